@@ -64,25 +64,52 @@ bool ADPCMStream::rewind() {
 	return true;
 }
 
+uint32 ADPCMStream::readChunk(byte *data, uint32 size) {
+	const int32 left = _endpos - _stream->pos();
+	if (left < (int32)size)
+		size = MAX<int32>(left, 1);
+
+	uint32 count = _stream->read(data, size);
+	if (count < size)
+		data[count++] = 0;
+
+	return count;
+}
+
+// Copies the buffered samples of a block decoder to the output
+static inline int copyDecodedSamples(int16 *buffer, int numSamples, const int16 *decodedSamples, uint16 &index, uint16 count) {
+	const int samples = MIN<int>(numSamples, count - index);
+	memcpy(buffer, decodedSamples + index, samples * sizeof(int16));
+	index += samples;
+	return samples;
+}
+
+static inline int16 decodeIMANibble(int32 &last, int32 &stepIndex, byte code) {
+	const int32 E = (2 * (code & 0x7) + 1) * Ima_ADPCMStream::_imaTable[stepIndex] / 8;
+	const int32 diff = (code & 0x08) ? -E : E;
+	const int32 samp = CLIP<int32>(last + diff, -32768, 32767);
+
+	last = samp;
+	stepIndex = CLIP<int32>(stepIndex + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(Ima_ADPCMStream::_imaTable) - 1);
+
+	return samp;
+}
+
 
 #pragma mark -
 
 
 int Oki_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeOKI((data >> 4) & 0x0f);
-			_decodedSamples[1] = decodeOKI((data >> 0) & 0x0f);
-			_decodedSampleCount = 2;
+	while (samples < numSamples) {
+		if (_decodedSampleIndex == _decodedSampleCount) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
+			decodeChunk();
 		}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+		samples += copyDecodedSamples(buffer + samples, numSamples - samples, _decodedSamples, _decodedSampleIndex, _decodedSampleCount);
 	}
 
 	return samples;
@@ -98,33 +125,53 @@ static const int16 okiStepSize[49] = {
 	 1552
 };
 
-// Decode Linear to ADPCM
-int16 Oki_ADPCMStream::decodeOKI(byte code) {
-	int16 diff, E, samp;
-
-	E = (2 * (code & 0x7) + 1) * okiStepSize[_status.ima_ch[0].stepIndex] / 8;
-	diff = (code & 0x08) ? -E : E;
-	samp = _status.ima_ch[0].last + diff;
+static inline int16 decodeOKINibble(int32 &last, int32 &stepIndex, byte code) {
+	const int16 E = (2 * (code & 0x7) + 1) * okiStepSize[stepIndex] / 8;
+	const int16 diff = (code & 0x08) ? -E : E;
 	// Clip the values to +/- 2^11 (supposed to be 12 bits)
-	samp = CLIP<int16>(samp, -2048, 2047);
+	const int16 samp = CLIP<int16>(last + diff, -2048, 2047);
 
-	_status.ima_ch[0].last = samp;
-	_status.ima_ch[0].stepIndex += _stepAdjustTable[code];
-	_status.ima_ch[0].stepIndex = CLIP<int32>(_status.ima_ch[0].stepIndex, 0, ARRAYSIZE(okiStepSize) - 1);
+	last = samp;
+	stepIndex = CLIP<int32>(stepIndex + ADPCMStream::_stepAdjustTable[code], 0, ARRAYSIZE(okiStepSize) - 1);
 
 	// * 16 effectively converts 12-bit input to 16-bit output
 	return samp * 16;
 }
 
+// Decode Linear to ADPCM
+int16 Oki_ADPCMStream::decodeOKI(byte code) {
+	return decodeOKINibble(_status.ima_ch[0].last, _status.ima_ch[0].stepIndex, code);
+}
+
+void Oki_ADPCMStream::decodeChunk() {
+	byte data[kChunkSize];
+	const uint32 size = readChunk(data, kChunkSize);
+
+	// Keep the decoder state in locals for the whole chunk
+	int32 last = _status.ima_ch[0].last;
+	int32 stepIndex = _status.ima_ch[0].stepIndex;
+	int16 *dst = _decodedSamples;
+
+	for (uint32 i = 0; i < size; i++) {
+		*dst++ = decodeOKINibble(last, stepIndex, data[i] >> 4);
+		*dst++ = decodeOKINibble(last, stepIndex, data[i] & 0x0f);
+	}
+
+	_status.ima_ch[0].last = last;
+	_status.ima_ch[0].stepIndex = stepIndex;
+	_decodedSampleCount = size * 2;
+	_decodedSampleIndex = 0;
+}
+
 
 #pragma mark -
 
 
 int XA_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte *data = new byte[128];
+	int samples = 0;
+	byte data[128];
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
+	while (samples < numSamples && !endOfData()) {
 		if (_decodedSampleCount == 0) {
 			uint32 bytesLeft = _stream->size() - _stream->pos();
 			if (bytesLeft < 128) {
@@ -138,12 +185,13 @@ int XA_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 			_decodedSampleIndex = 0;
 		}
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+		const int count = MIN<int>(numSamples - samples, _decodedSampleCount);
+		memcpy(&buffer[samples], &_decodedSamples[_decodedSampleIndex], count * sizeof(int16));
+		_decodedSampleIndex += count;
+		_decodedSampleCount -= count;
+		samples += count;
 	}
 
-	delete[] data;
 	return samples;
 }
 
@@ -221,25 +269,57 @@ void XA_ADPCMStream::decodeXA(const byte *src) {
 
 
 int DVI_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			data = _stream->readByte();
-			_decodedSamples[0] = decodeIMA((data >> 4) & 0x0f, 0);
-			_decodedSamples[1] = decodeIMA((data >> 0) & 0x0f, _channels == 2 ? 1 : 0);
-			_decodedSampleCount = 2;
+	while (samples < numSamples) {
+		if (_decodedSampleIndex == _decodedSampleCount) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
+			decodeChunk();
 		}
 
-		// (1 - (count - 1)) ensures that _decodedSamples acts as a FIFO of depth 2
-		buffer[samples] = _decodedSamples[1 - (_decodedSampleCount - 1)];
-		_decodedSampleCount--;
+		samples += copyDecodedSamples(buffer + samples, numSamples - samples, _decodedSamples, _decodedSampleIndex, _decodedSampleCount);
 	}
 
 	return samples;
 }
 
+void DVI_ADPCMStream::decodeChunk() {
+	byte data[kChunkSize];
+	const uint32 size = readChunk(data, kChunkSize);
+
+	int16 *dst = _decodedSamples;
+
+	if (_channels == 2) {
+		// The high nibble belongs to the left channel, the low one to the right
+		int32 last0 = _status.ima_ch[0].last, stepIndex0 = _status.ima_ch[0].stepIndex;
+		int32 last1 = _status.ima_ch[1].last, stepIndex1 = _status.ima_ch[1].stepIndex;
+
+		for (uint32 i = 0; i < size; i++) {
+			*dst++ = decodeIMANibble(last0, stepIndex0, data[i] >> 4);
+			*dst++ = decodeIMANibble(last1, stepIndex1, data[i] & 0x0f);
+		}
+
+		_status.ima_ch[0].last = last0;
+		_status.ima_ch[0].stepIndex = stepIndex0;
+		_status.ima_ch[1].last = last1;
+		_status.ima_ch[1].stepIndex = stepIndex1;
+	} else {
+		int32 last = _status.ima_ch[0].last, stepIndex = _status.ima_ch[0].stepIndex;
+
+		for (uint32 i = 0; i < size; i++) {
+			*dst++ = decodeIMANibble(last, stepIndex, data[i] >> 4);
+			*dst++ = decodeIMANibble(last, stepIndex, data[i] & 0x0f);
+		}
+
+		_status.ima_ch[0].last = last;
+		_status.ima_ch[0].stepIndex = stepIndex;
+	}
+
+	_decodedSampleCount = size * 2;
+	_decodedSampleIndex = 0;
+}
+
 #pragma mark -
 
 
@@ -254,56 +334,78 @@ int Apple_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 	int chanSamples = numSamples / _channels;
 
 	for (int i = 0; i < _channels; i++) {
-		_stream->seek(_streamPos[i]);
+		while (samples[i] < chanSamples) {
+			if (_decodedSampleIndex[i] == _decodedSampleCount[i]) {
+				// Last byte read and a new one needed
+				_stream->seek(_streamPos[i]);
+				if (_stream->eos() || _stream->pos() >= _endpos)
+					break;
+
+				decodeChunk(i);
+			}
 
-		while ((samples[i] < chanSamples) &&
-		       // Last byte read and a new one needed
-		       !((_stream->eos() || (_stream->pos() >= _endpos)) && (_chunkPos[i] == 0))) {
+			// The original is interleaved block-wise, we want it sample-wise
+			const int count = MIN<int>(chanSamples - samples[i], _decodedSampleCount[i] - _decodedSampleIndex[i]);
+			const int16 *src = &_decodedSamples[i][_decodedSampleIndex[i]];
+			int16 *dst = &buffer[_channels * samples[i] + i];
 
-			if (_blockPos[i] == _blockAlign) {
-				// 2 byte header per block
-				uint16 temp = _stream->readUint16BE();
+			for (int j = 0; j < count; j++, dst += _channels)
+				*dst = src[j];
 
-				// First 9 bits are the upper bits of the predictor
-				_status.ima_ch[i].last      = (int16) (temp & 0xFF80);
-				// Lower 7 bits are the step index
-				_status.ima_ch[i].stepIndex =          temp & 0x007F;
+			_decodedSampleIndex[i] += count;
+			samples[i] += count;
+		}
+	}
 
-				// Clip the step index
-				_status.ima_ch[i].stepIndex = CLIP<int32>(_status.ima_ch[i].stepIndex, 0, 88);
+	return samples[0] + samples[1];
+}
 
-				_blockPos[i] = 2;
-			}
+void Apple_ADPCMStream::decodeChunk(int channel) {
+	if (_blockPos[channel] == _blockAlign) {
+		// 2 byte header per block
+		uint16 temp = _stream->readUint16BE();
 
-			if (_chunkPos[i] == 0) {
-				// Decode data
-				byte data = _stream->readByte();
-				_buffer[i][0] = decodeIMA(data &  0x0F, i);
-				_buffer[i][1] = decodeIMA(data >>    4, i);
-			}
+		// First 9 bits are the upper bits of the predictor
+		_status.ima_ch[channel].last      = (int16) (temp & 0xFF80);
+		// Lower 7 bits are the step index
+		_status.ima_ch[channel].stepIndex =          temp & 0x007F;
 
-			// The original is interleaved block-wise, we want it sample-wise
-			buffer[_channels * samples[i] + i] = _buffer[i][_chunkPos[i]];
+		// Clip the step index
+		_status.ima_ch[channel].stepIndex = CLIP<int32>(_status.ima_ch[channel].stepIndex, 0, 88);
 
-			if (++_chunkPos[i] > 1) {
-				// We're about to decode the next byte, so advance the block position
-				_chunkPos[i] = 0;
-				_blockPos[i]++;
-			}
+		_blockPos[channel] = 2;
+	}
 
-			samples[i]++;
+	// Decode the rest of the block, or as much of it as fits
+	byte data[kChunkSize];
+	uint32 size = kChunkSize;
+	if (_blockPos[channel] < _blockAlign)
+		size = MIN<uint32>(size, _blockAlign - _blockPos[channel]);
+	size = readChunk(data, size);
 
-			if (_channels == 2)
-				if (_blockPos[i] == _blockAlign)
-					// We're at the end of the block.
-					// Since the channels are interleaved, skip the next block
-					_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+	int32 last = _status.ima_ch[channel].last;
+	int32 stepIndex = _status.ima_ch[channel].stepIndex;
+	int16 *dst = _decodedSamples[channel];
 
-			_streamPos[i] = _stream->pos();
-		}
+	for (uint32 j = 0; j < size; j++) {
+		*dst++ = decodeIMANibble(last, stepIndex, data[j] & 0x0f);
+		*dst++ = decodeIMANibble(last, stepIndex, data[j] >> 4);
 	}
 
-	return samples[0] + samples[1];
+	_status.ima_ch[channel].last = last;
+	_status.ima_ch[channel].stepIndex = stepIndex;
+	_decodedSampleCount[channel] = size * 2;
+	_decodedSampleIndex[channel] = 0;
+
+	_blockPos[channel] += size;
+
+	if (_channels == 2)
+		if (_blockPos[channel] == _blockAlign)
+			// We're at the end of the block.
+			// Since the channels are interleaved, skip the next block
+			_stream->skip(MIN<uint32>(_blockAlign, _endpos - _stream->pos()));
+
+	_streamPos[channel] = _stream->pos();
 }
 
 
@@ -316,40 +418,74 @@ int MSIma_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
 
 	int samples = 0;
 
-	while (samples < numSamples && !_stream->eos() && _stream->pos() < _endpos) {
-		if (_blockPos[0] == _blockAlign) {
-			for (int i = 0; i < _channels; i++) {
-				// read block header
-				_status.ima_ch[i].last = _stream->readSint16LE();
-				_status.ima_ch[i].stepIndex = _stream->readSint16LE();
-			}
-
-			_blockPos[0] = _channels * 4;
+	while (samples < numSamples) {
+		if (_decodedSampleIndex == _decodedSampleCount) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
+			decodeChunk();
 		}
 
-		// Decode a set of samples
+		samples += copyDecodedSamples(buffer + samples, numSamples - samples, _decodedSamples, _decodedSampleIndex, _decodedSampleCount);
+	}
+
+	return samples;
+}
+
+void MSIma_ADPCMStream::decodeChunk() {
+	if (_blockPos[0] == _blockAlign) {
 		for (int i = 0; i < _channels; i++) {
-			// The stream encodes four bytes per channel at a time
-			for (int j = 0; j < 4; j++) {
-				byte data = _stream->readByte();
-				_blockPos[0]++;
-				_buffer[i][j * 2] = decodeIMA(data & 0x0f, i);
-				_buffer[i][j * 2 + 1] = decodeIMA((data >> 4) & 0x0f, i);
-				_samplesLeft[i] += 2;
-			}
+			// read block header
+			_status.ima_ch[i].last = _stream->readSint16LE();
+			_status.ima_ch[i].stepIndex = _stream->readSint16LE();
 		}
 
-		while (samples < numSamples && _samplesLeft[0] != 0) {
-			for (int i = 0; i < _channels; i++) {
-				buffer[samples + i] = _buffer[i][8 - _samplesLeft[i]];
-				_samplesLeft[i]--;
-			}
+		_blockPos[0] = _channels * 4;
+	}
 
-			samples += _channels;
+	// The stream encodes groups of four bytes per channel, which are decoded
+	// to eight samples per channel. Decode as many whole groups as are left in
+	// the block and fit in the buffer.
+	const uint32 groupSize = _channels * 4;
+	uint32 groups = kChunkSize / groupSize;
+	if (_blockPos[0] < _blockAlign)
+		groups = MIN<uint32>(groups, (_blockAlign - _blockPos[0]) / groupSize);
+	const int32 left = _endpos - _stream->pos();
+	if (left > 0)
+		groups = MIN<uint32>(groups, (left + groupSize - 1) / groupSize);
+	groups = MAX<uint32>(groups, 1);
+
+	byte data[kChunkSize];
+	const uint32 size = groups * groupSize;
+	const uint32 count = _stream->read(data, size);
+	if (count < size) {
+		// The group in which the stream ended is decoded with zeros, like
+		// readByte() returns them
+		groups = count / groupSize + 1;
+		memset(data + count, 0, groups * groupSize - count);
+	}
+	_blockPos[0] += groups * groupSize;
+
+	for (int i = 0; i < _channels; i++) {
+		int32 last = _status.ima_ch[i].last;
+		int32 stepIndex = _status.ima_ch[i].stepIndex;
+
+		for (uint32 g = 0; g < groups; g++) {
+			const byte *src = data + g * groupSize + i * 4;
+			int16 *dst = _decodedSamples + g * 8 * _channels + i;
+
+			for (int j = 0; j < 4; j++) {
+				dst[0] = decodeIMANibble(last, stepIndex, src[j] & 0x0f);
+				dst[_channels] = decodeIMANibble(last, stepIndex, src[j] >> 4);
+				dst += 2 * _channels;
+			}
 		}
+
+		_status.ima_ch[i].last = last;
+		_status.ima_ch[i].stepIndex = stepIndex;
 	}
 
-	return samples;
+	_decodedSampleCount = groups * 8 * _channels;
+	_decodedSampleIndex = 0;
 }
 
 
@@ -369,67 +505,107 @@ static const int MSADPCMAdaptationTable[] = {
 	768, 614, 512, 409, 307, 230, 230, 230
 };
 
-int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
+int16 MS_ADPCMStream::decodeMSNibble(ADPCMChannelStatus &c, byte code) {
 	int32 predictor;
 
-	predictor = (((c->sample1) * (c->coeff1)) + ((c->sample2) * (c->coeff2))) / 256;
-	predictor += (signed)((code & 0x08) ? (code - 0x10) : (code)) * c->delta;
+	predictor = (((c.sample1) * (c.coeff1)) + ((c.sample2) * (c.coeff2))) / 256;
+	predictor += (signed)((code & 0x08) ? (code - 0x10) : (code)) * c.delta;
 
 	predictor = CLIP<int32>(predictor, -32768, 32767);
 
-	c->sample2 = c->sample1;
-	c->sample1 = predictor;
-	c->delta = (MSADPCMAdaptationTable[(int)code] * c->delta) >> 8;
+	c.sample2 = c.sample1;
+	c.sample1 = predictor;
+	c.delta = (MSADPCMAdaptationTable[(int)code] * c.delta) >> 8;
 
-	if (c->delta < 16)
-		c->delta = 16;
+	if (c.delta < 16)
+		c.delta = 16;
 
 	return (int16)predictor;
 }
 
+int16 MS_ADPCMStream::decodeMS(ADPCMChannelStatus *c, byte code) {
+	return decodeMSNibble(*c, code);
+}
+
 int MS_ADPCMStream::readBuffer(int16 *buffer, const int numSamples) {
-	int samples;
-	byte data;
+	int samples = 0;
+
+	while (samples < numSamples) {
+		if (_decodedSampleIndex == _decodedSampleCount) {
+			if (_stream->eos() || _stream->pos() >= _endpos)
+				break;
+			decodeChunk();
+		}
+
+		samples += copyDecodedSamples(buffer + samples, numSamples - samples, _decodedSamples, _decodedSampleIndex, _decodedSampleCount);
+	}
+
+	return samples;
+}
+
+void MS_ADPCMStream::decodeChunk() {
 	int i;
 
-	for (samples = 0; samples < numSamples && !endOfData(); samples++) {
-		if (_decodedSampleCount == 0) {
-			if (_blockPos[0] == _blockAlign) {
-				// read block header
-				for (i = 0; i < _channels; i++) {
-					_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
-					_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
-					_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
-				}
+	_decodedSampleCount = 0;
+	_decodedSampleIndex = 0;
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].delta = _stream->readSint16LE();
+	if (_blockPos[0] == _blockAlign) {
+		// read block header
+		for (i = 0; i < _channels; i++) {
+			_status.ch[i].predictor = CLIP(_stream->readByte(), (byte)0, (byte)6);
+			_status.ch[i].coeff1 = MSADPCMAdaptCoeff1[_status.ch[i].predictor];
+			_status.ch[i].coeff2 = MSADPCMAdaptCoeff2[_status.ch[i].predictor];
+		}
 
-				for (i = 0; i < _channels; i++)
-					_status.ch[i].sample1 = _stream->readSint16LE();
+		for (i = 0; i < _channels; i++)
+			_status.ch[i].delta = _stream->readSint16LE();
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
+		for (i = 0; i < _channels; i++)
+			_status.ch[i].sample1 = _stream->readSint16LE();
 
-				for (i = 0; i < _channels; i++)
-					_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+		for (i = 0; i < _channels; i++)
+			_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample2 = _stream->readSint16LE();
 
-				_blockPos[0] = _channels * 7;
-			} else {
-				data = _stream->readByte();
-				_blockPos[0]++;
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[0], (data >> 4) & 0x0f);
-				_decodedSamples[_decodedSampleCount++] = decodeMS(&_status.ch[_channels - 1], data & 0x0f);
-			}
-			_decodedSampleIndex = 0;
+		for (i = 0; i < _channels; i++)
+			_decodedSamples[_decodedSampleCount++] = _status.ch[i].sample1;
+
+		_blockPos[0] = _channels * 7;
+		return;
+	}
+
+	// Decode the rest of the block, or as much of it as fits
+	byte data[kChunkSize];
+	uint32 size = kChunkSize;
+	if (_blockPos[0] < _blockAlign)
+		size = MIN<uint32>(size, _blockAlign - _blockPos[0]);
+	size = readChunk(data, size);
+	_blockPos[0] += size;
+
+	int16 *dst = _decodedSamples;
+
+	if (_channels == 2) {
+		ADPCMChannelStatus left = _status.ch[0];
+		ADPCMChannelStatus right = _status.ch[1];
+
+		for (uint32 j = 0; j < size; j++) {
+			*dst++ = decodeMSNibble(left, data[j] >> 4);
+			*dst++ = decodeMSNibble(right, data[j] & 0x0f);
+		}
+
+		_status.ch[0] = left;
+		_status.ch[1] = right;
+	} else {
+		ADPCMChannelStatus mono = _status.ch[0];
+
+		for (uint32 j = 0; j < size; j++) {
+			*dst++ = decodeMSNibble(mono, data[j] >> 4);
+			*dst++ = decodeMSNibble(mono, data[j] & 0x0f);
 		}
 
-		// _decodedSamples acts as a FIFO of depth 2 or 4;
-		buffer[samples] = _decodedSamples[_decodedSampleIndex++];
-		_decodedSampleCount--;
+		_status.ch[0] = mono;
 	}
 
-	return samples;
+	_decodedSampleCount = size * 2;
 }
 
 
@@ -546,15 +722,7 @@ const int16 Ima_ADPCMStream::_imaTable[89] = {
 };
 
 int16 Ima_ADPCMStream::decodeIMA(byte code, int channel) {
-	int32 E = (2 * (code & 0x7) + 1) * _imaTable[_status.ima_ch[channel].stepIndex] / 8;
-	int32 diff = (code & 0x08) ? -E : E;
-	int32 samp = CLIP<int32>(_status.ima_ch[channel].last + diff, -32768, 32767);
-
-	_status.ima_ch[channel].last = samp;
-	_status.ima_ch[channel].stepIndex += _stepAdjustTable[code];
-	_status.ima_ch[channel].stepIndex = CLIP<int32>(_status.ima_ch[channel].stepIndex, 0, ARRAYSIZE(_imaTable) - 1);
-
-	return samp;
+	return decodeIMANibble(_status.ima_ch[channel].last, _status.ima_ch[channel].stepIndex, code);
 }
 
 SeekableAudioStream *makeADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, ADPCMType type, int rate, int channels, uint32 blockAlign) {
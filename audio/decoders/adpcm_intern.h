@@ -57,8 +57,22 @@ protected:
 		} ima_ch[2];
 	} _status;
 
+	enum {
+		/** Number of encoded bytes the block decoders process at once */
+		kChunkSize = 256
+	};
+
 	virtual void reset();
 
+	/**
+	 * Reads up to size bytes of encoded data, stopping at the end of the data
+	 * but reading at least one byte. If the stream ends early, a zero byte is
+	 * appended, like readByte() would return it.
+	 *
+	 * @return the number of bytes stored in data
+	 */
+	uint32 readChunk(byte *data, uint32 size);
+
 public:
 	ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign);
 
@@ -83,18 +97,26 @@ public:
 class Oki_ADPCMStream : public ADPCMStream {
 public:
 	Oki_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+		: ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = _decodedSampleIndex = 0; }
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleIndex == _decodedSampleCount); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 protected:
 	int16 decodeOKI(byte);
 
+	void reset() {
+		ADPCMStream::reset();
+		_decodedSampleCount = _decodedSampleIndex = 0;
+	}
+
 private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
+	void decodeChunk();
+
+	uint16 _decodedSampleCount;
+	uint16 _decodedSampleIndex;
+	int16 _decodedSamples[kChunkSize * 2];
 };
 
 class XA_ADPCMStream : public ADPCMStream {
@@ -132,28 +154,38 @@ public:
 class DVI_ADPCMStream : public Ima_ADPCMStream {
 public:
 	DVI_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
-		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = 0; }
+		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) { _decodedSampleCount = _decodedSampleIndex = 0; }
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleIndex == _decodedSampleCount); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
+protected:
+	void reset() {
+		Ima_ADPCMStream::reset();
+		_decodedSampleCount = _decodedSampleIndex = 0;
+	}
+
 private:
-	uint8 _decodedSampleCount;
-	int16 _decodedSamples[2];
+	void decodeChunk();
+
+	uint16 _decodedSampleCount;
+	uint16 _decodedSampleIndex;
+	int16 _decodedSamples[kChunkSize * 2];
 };
 
 class Apple_ADPCMStream : public Ima_ADPCMStream {
 protected:
 	// Apple QuickTime IMA ADPCM
 	int32 _streamPos[2];
-	int16 _buffer[2][2];
-	uint8 _chunkPos[2];
+	uint16 _decodedSampleCount[2];
+	uint16 _decodedSampleIndex[2];
+	int16 _decodedSamples[2][kChunkSize * 2];
 
 	void reset() {
 		Ima_ADPCMStream::reset();
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
+		_decodedSampleCount[0] = _decodedSampleIndex[0] = 0;
+		_decodedSampleCount[1] = _decodedSampleIndex[1] = 0;
 		_streamPos[0] = 0;
 		_streamPos[1] = _blockAlign;
 	}
@@ -161,14 +193,22 @@ protected:
 public:
 	Apple_ADPCMStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, uint32 size, int rate, int channels, uint32 blockAlign)
 		: Ima_ADPCMStream(stream, disposeAfterUse, size, rate, channels, blockAlign) {
-		_chunkPos[0] = 0;
-		_chunkPos[1] = 0;
+		_decodedSampleCount[0] = _decodedSampleIndex[0] = 0;
+		_decodedSampleCount[1] = _decodedSampleIndex[1] = 0;
 		_streamPos[0] = 0;
 		_streamPos[1] = _blockAlign;
 	}
 
+	virtual bool endOfData() const {
+		return Ima_ADPCMStream::endOfData() &&
+			_decodedSampleIndex[0] == _decodedSampleCount[0] &&
+			_decodedSampleIndex[1] == _decodedSampleCount[1];
+	}
+
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
+private:
+	void decodeChunk(int channel);
 };
 
 class MSIma_ADPCMStream : public Ima_ADPCMStream {
@@ -182,21 +222,24 @@ public:
 		if (blockAlign % (_channels * 4))
 			error("MSIma_ADPCMStream(): invalid blockAlign");
 
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		_decodedSampleCount = _decodedSampleIndex = 0;
 	}
 
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleIndex == _decodedSampleCount); }
+
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
 	void reset() {
 		Ima_ADPCMStream::reset();
-		_samplesLeft[0] = 0;
-		_samplesLeft[1] = 0;
+		_decodedSampleCount = _decodedSampleIndex = 0;
 	}
 
 private:
-	int16 _buffer[2][8];
-	int _samplesLeft[2];
+	void decodeChunk();
+
+	uint16 _decodedSampleCount;
+	uint16 _decodedSampleIndex;
+	int16 _decodedSamples[kChunkSize * 2];
 };
 
 class MS_ADPCMStream : public ADPCMStream {
@@ -218,6 +261,7 @@ protected:
 	void reset() {
 		ADPCMStream::reset();
 		memset(&_status, 0, sizeof(_status));
+		_decodedSampleCount = _decodedSampleIndex = 0;
 	}
 
 public:
@@ -230,7 +274,7 @@ public:
 		_decodedSampleIndex = 0;
 	}
 
-	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleCount == 0); }
+	virtual bool endOfData() const { return (_stream->eos() || _stream->pos() >= _endpos) && (_decodedSampleIndex == _decodedSampleCount); }
 
 	virtual int readBuffer(int16 *buffer, const int numSamples);
 
@@ -238,9 +282,13 @@ protected:
 	int16 decodeMS(ADPCMChannelStatus *c, byte);
 
 private:
-	uint8 _decodedSampleCount;
-	uint8 _decodedSampleIndex;
-	int16 _decodedSamples[4];
+	static int16 decodeMSNibble(ADPCMChannelStatus &c, byte code);
+
+	void decodeChunk();
+
+	uint16 _decodedSampleCount;
+	uint16 _decodedSampleIndex;
+	int16 _decodedSamples[kChunkSize * 2];
 };
 
 // Duck DK3 IMA ADPCM Decoder
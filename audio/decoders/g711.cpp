@@ -45,8 +45,14 @@ class G711AudioStream : public SeekableAudioStream {
 	const int _rate;
 	const int _channels;
 
+	enum {
+		/** Number of bytes which are read and decoded at once */
+		kChunkSize = 512
+	};
+
 protected:
-	virtual int16 decodeSample(uint8 val) = 0;
+	/** Decoded sample for each byte value, filled in by the subclasses */
+	int16 _decodeTable[256];
 
 public:
 	G711AudioStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int rate, int channels) :
@@ -56,13 +62,18 @@ public:
 	}
 
 	int readBuffer(int16 *buffer, const int numSamples) override {
-		int samples;
+		byte data[kChunkSize];
+		int samples = 0;
+
+		while (samples < numSamples) {
+			const uint32 count = _stream->read(data, MIN<int>(numSamples - samples, kChunkSize));
+
+			for (uint32 i = 0; i < count; i++)
+				buffer[samples + i] = _decodeTable[data[i]];
+			samples += count;
 
-		for (samples = 0; samples < numSamples; samples++) {
-			uint8 val = _stream->readByte();
 			if (endOfData())
 				break;
-			buffer[samples] = decodeSample(val);
 		}
 
 		return samples;
@@ -81,7 +92,7 @@ public:
 };
 
 class G711ALawStream : public G711AudioStream {
-	int16 decodeSample(uint8 val) override {
+	static int16 decodeSample(uint8 val) {
 		val ^= 0x55;
 
 		int t = val & QUANT_MASK;
@@ -97,6 +108,8 @@ class G711ALawStream : public G711AudioStream {
 public:
 	G711ALawStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int rate, int channels) :
 		G711AudioStream(stream, disposeAfterUse, rate, channels) {
+		for (int i = 0; i < ARRAYSIZE(_decodeTable); i++)
+			_decodeTable[i] = decodeSample(i);
 	}
 };
 
@@ -105,7 +118,7 @@ SeekableAudioStream *makeALawStream(Common::SeekableReadStream *stream, DisposeA
 }
 
 class G711MuLawStream : public G711AudioStream {
-	int16 decodeSample(uint8 val) override {
+	static int16 decodeSample(uint8 val) {
 		val = ~val;
 
 		int t = ((val & QUANT_MASK) << 3) + BIAS;
@@ -117,6 +130,8 @@ class G711MuLawStream : public G711AudioStream {
 public:
 	G711MuLawStream(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse, int rate, int channels) :
 		G711AudioStream(stream, disposeAfterUse, rate, channels) {
+		for (int i = 0; i < ARRAYSIZE(_decodeTable); i++)
+			_decodeTable[i] = decodeSample(i);
 	}
 };
 
@@ -57,6 +57,10 @@ namespace RetroWaveOPL3 {
 } // End of namespace RetroWaveOPL3
 #endif // ENABLE_RETROWAVE_OPL3
 
+namespace DRODump {
+	OPL *create(OPL *opl, Config::OplType type);
+} // End of namespace DRODump
+
 // Config implementation
 
 enum OplEmulator {
@@ -70,10 +74,15 @@ enum OplEmulator {
 	kRWOPL3 = 7
 };
 
-OPL::OPL() {
-	if (_hasInstance)
-		error("There are multiple OPL output instances running");
-	_hasInstance = true;
+OPL::OPL() : OPL(true) {
+}
+
+OPL::OPL(bool isOutput) {
+	if (isOutput) {
+		if (_hasInstance)
+			error("There are multiple OPL output instances running");
+		_hasInstance = true;
+	}
 	_rhythmMode = false;
 	_connectionFeedbackValues[0] = 0;
 	_connectionFeedbackValues[1] = 0;
@@ -182,6 +191,16 @@ OPL *Config::create(OplType type) {
 }
 
 OPL *Config::create(DriverId driver, OplType type) {
+	OPL *opl = createDriver(driver, type);
+
+	// Log all register writes to 'dump.dro' when requested
+	if (opl && ConfMan.getBool("dump_opl"))
+		opl = DRODump::create(opl, type);
+
+	return opl;
+}
+
+OPL *Config::createDriver(DriverId driver, OplType type) {
 	// On invalid driver selection, we try to do some fallback detection
 	if (driver == -1) {
 		warning("Invalid OPL driver selected, trying to detect a fallback emulator");
@@ -406,6 +425,8 @@ EmulatedOPL::EmulatedOPL() :
 	_nextTick(0),
 	_samplesPerTick(0),
 	_baseFreq(0),
+	_queueWrites(false),
+	_queuePos(0),
 	_handle(new Audio::SoundHandle()) {
 }
 
@@ -421,27 +442,60 @@ EmulatedOPL::~EmulatedOPL() {
 
 int EmulatedOPL::readBuffer(int16 *buffer, const int numSamples) {
 	const int stereoFactor = isStereo() ? 2 : 1;
-	int len = numSamples / stereoFactor;
-	int step;
+	const int len = numSamples / stereoFactor;
+
+	// Run the callbacks of all the ticks falling into this buffer first. The
+	// register writes they make are queued at the sample position of their
+	// tick, so that the buffer is only split where a write takes effect,
+	// instead of at every tick.
+	{
+		Common::StackLock lock(_queueMutex);
+		_queueWrites = true;
+	}
+
+	int pos = 0;
+	while ((_nextTick >> FIXP_SHIFT) < len - pos) {
+		pos += _nextTick >> FIXP_SHIFT;
+		_nextTick &= (1 << FIXP_SHIFT) - 1;
+
+		{
+			Common::StackLock lock(_queueMutex);
+			_queuePos = pos;
+		}
+
+		if (_callback && _callback->isValid())
+			(*_callback)();
 
-	do {
-		step = len;
-		if (step > (_nextTick >> FIXP_SHIFT))
-			step = (_nextTick >> FIXP_SHIFT);
+		_nextTick += _samplesPerTick;
+	}
+	_nextTick -= (len - pos) << FIXP_SHIFT;
 
-		generateSamples(buffer, step * stereoFactor);
+	{
+		Common::StackLock lock(_queueMutex);
+		_queueWrites = false;
+		_queue.swap(_replay);
+	}
 
-		_nextTick -= step << FIXP_SHIFT;
-		if (!(_nextTick >> FIXP_SHIFT)) {
-			if (_callback && _callback->isValid())
-				(*_callback)();
+	int rendered = 0;
+	for (uint i = 0; i < _replay.size(); i++) {
+		const QueuedWrite &queued = _replay[i];
 
-			_nextTick += _samplesPerTick;
+		if (queued.pos > rendered) {
+			generateSamples(buffer + rendered * stereoFactor, (queued.pos - rendered) * stereoFactor);
+			rendered = queued.pos;
 		}
 
-		buffer += step * stereoFactor;
-		len -= step;
-	} while (len);
+		if (queued.isReg)
+			writeReg(queued.a, queued.v);
+		else
+			write(queued.a, queued.v);
+	}
+
+	if (len > rendered)
+		generateSamples(buffer + rendered * stereoFactor, (len - rendered) * stereoFactor);
+
+	// Keep the storage for the next buffer
+	_replay.resize(0);
 
 	return numSamples;
 }
@@ -450,6 +504,20 @@ int EmulatedOPL::getRate() const {
 	return g_system->getMixer()->getOutputRate();
 }
 
+bool EmulatedOPL::queueWrite(int a, int v, bool isReg) {
+	Common::StackLock lock(_queueMutex);
+	if (!_queueWrites)
+		return false;
+
+	QueuedWrite queued;
+	queued.pos = _queuePos;
+	queued.a = a;
+	queued.v = v;
+	queued.isReg = isReg;
+	_queue.push_back(queued);
+	return true;
+}
+
 void EmulatedOPL::startCallbacks(int timerFrequency) {
 	setCallbackFrequency(timerFrequency);
 	g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, _handle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
@@ -24,7 +24,9 @@
 
 #include "audio/audiostream.h"
 
+#include "common/array.h"
 #include "common/func.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/scummsys.h"
 
@@ -110,6 +112,8 @@ public:
 	static OPL *create(OplType type = kOpl2);
 
 private:
+	static OPL *createDriver(DriverId driver, OplType type);
+
 	static const EmulatorDescription _drivers[];
 };
 
@@ -213,6 +217,12 @@ protected:
 	*/
 	bool emulateDualOpl2OnOpl3(int r, int v, Config::OplType oplType);
 
+	/**
+	 * Constructor for OPLs which only forward to another OPL instance, and
+	 * thus do not count as an additional output instance.
+	 */
+	explicit OPL(bool isOutput);
+
 	/**
 	 * Start the callbacks.
 	 */
@@ -279,6 +289,7 @@ public:
 
 	// AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
+	using Audio::AudioStream::isStereo;
 	int getRate() const;
 	bool endOfData() const { return false; }
 
@@ -299,6 +310,23 @@ protected:
 	 */
 	virtual void generateSamples(int16 *buffer, int numSamples) = 0;
 
+	/**
+	 * Queue a register write made by a timer callback.
+	 *
+	 * readBuffer() runs the callbacks of all the ticks falling into the
+	 * buffer before rendering it, so emulators must call this first in
+	 * write() and writeReg(). While the callbacks run, the write is stored
+	 * with the sample position of the current tick, to be applied when the
+	 * output reaches it, and true is returned. Otherwise, false is returned
+	 * and the write must be applied immediately.
+	 *
+	 * @param a		port address, or register number for writeReg()
+	 * @param v		value to write
+	 * @param isReg	whether the write was made through writeReg()
+	 * @return		true if the write was queued
+	 */
+	bool queueWrite(int a, int v, bool isReg);
+
 private:
 	int _baseFreq;
 
@@ -309,6 +337,21 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	struct QueuedWrite {
+		int pos;
+		int a;
+		int v;
+		bool isReg;
+	};
+
+	// Writes made by the timer callbacks of the buffer being rendered. The
+	// lock guards them against writes made from other threads.
+	Common::Mutex _queueMutex;
+	Common::Array<QueuedWrite> _queue;
+	Common::Array<QueuedWrite> _replay;
+	bool _queueWrites;
+	int _queuePos;
+
 	Audio::SoundHandle *_handle;
 };
 /** @} */
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/midicache.h"
+#include "audio/audiostream.h"
+#include "audio/decoders/wave.h"
+
+#include "common/compression/zlib.h"
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/textconsole.h"
+
+namespace Audio {
+namespace MidiRenderCache {
+
+enum {
+	// Longer tracks are not cached, to bound the memory used for recording
+	kMaxRecordSeconds = 300
+};
+
+// Settings which change the output of the music drivers
+static const char *const settingKeys[] = {
+	"music_driver", "gm_device", "mt32_device", "native_mt32", "enable_gs", "midi_gain", "opl_driver",
+	"soundfont", "fluidsynth_chorus_activate", "fluidsynth_chorus_nr", "fluidsynth_chorus_level",
+	"fluidsynth_chorus_speed", "fluidsynth_chorus_depth", "fluidsynth_chorus_waveform",
+	"fluidsynth_reverb_activate", "fluidsynth_reverb_roomsize", "fluidsynth_reverb_damping",
+	"fluidsynth_reverb_width", "fluidsynth_reverb_level", "fluidsynth_misc_interpolation",
+	nullptr
+};
+
+static Common::FSNode getDirectory() {
+	return Common::FSNode(ConfMan.get("midi_render_cache_path"));
+}
+
+static void hashBytes(uint64 &hash, const byte *data, uint32 size) {
+	// 64-bit FNV-1a
+	for (uint32 i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+}
+
+bool isEnabled() {
+	return !ConfMan.get("midi_render_cache_path").empty();
+}
+
+Common::String makeName(const byte *data, uint32 size, int track, uint rate, int volume) {
+	Common::String settings = Common::String::format("%d:%u:%d", track, rate, volume);
+	for (const char *const *key = settingKeys; *key; key++)
+		settings += ":" + ConfMan.get(*key);
+
+	uint64 hash = 14695981039346656037ULL;
+	hashBytes(hash, data, size);
+	hashBytes(hash, (const byte *)settings.c_str(), settings.size());
+
+	return Common::String::format("midi-%08x%08x.wav", (uint32)(hash >> 32), (uint32)hash);
+}
+
+SeekableAudioStream *open(const Common::String &name) {
+	Common::FSNode node = getDirectory().getChild(name);
+	if (!node.exists())
+		return nullptr;
+
+	Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(node.createReadStream());
+	if (!stream)
+		return nullptr;
+
+	debug(1, "Playing music from the render cache: '%s'", name.c_str());
+	return makeWAVStream(stream, DisposeAfterUse::YES);
+}
+
+Recorder::Recorder(const Common::String &name, uint rate, bool stereo) :
+	_name(name), _rate(rate), _stereo(stereo), _maxSize(rate * (stereo ? 4 : 2) * kMaxRecordSeconds), _overflow(false) {
+	// Allocate the whole buffer up front, since write() is called from the
+	// audio thread for every buffer the driver renders
+	_data.reserve(_maxSize);
+}
+
+uint32 Recorder::write(const void *dataPtr, uint32 dataSize) {
+	if (_overflow || _data.size() + dataSize > _maxSize) {
+		_overflow = true;
+		return dataSize;
+	}
+
+	const uint32 oldSize = _data.size();
+	_data.resize(oldSize + dataSize);
+	memcpy(_data.data() + oldSize, dataPtr, dataSize);
+	return dataSize;
+}
+
+void Recorder::save() const {
+	if (_overflow || _data.empty())
+		return;
+
+	Common::FSNode dir = getDirectory();
+	if (!dir.exists() && !dir.createDirectory()) {
+		warning("Could not create the music cache directory '%s'", dir.getPath().c_str());
+		return;
+	}
+
+	Common::DumpFile *file = new Common::DumpFile();
+	if (!file->open(dir.getChild(_name))) {
+		warning("Could not open '%s' for writing", _name.c_str());
+		delete file;
+		return;
+	}
+
+	// The wrapper takes ownership of the file, and compresses the data if
+	// zlib is available
+	Common::WriteStream *stream = Common::wrapCompressedWriteStream(file);
+
+	const uint16 channels = _stereo ? 2 : 1;
+	const uint32 size = _data.size();
+
+	stream->write("RIFF", 4);
+	stream->writeUint32LE(36 + size);
+	stream->write("WAVE", 4);
+	stream->write("fmt ", 4);
+	stream->writeUint32LE(16);
+	stream->writeUint16LE(1);						// PCM
+	stream->writeUint16LE(channels);
+	stream->writeUint32LE(_rate);
+	stream->writeUint32LE(_rate * channels * 2);	// bytes per second
+	stream->writeUint16LE(channels * 2);			// block align
+	stream->writeUint16LE(16);						// bits per sample
+	stream->write("data", 4);
+	stream->writeUint32LE(size);
+
+#ifdef SCUMM_LITTLE_ENDIAN
+	stream->write(_data.data(), size);
+#else
+	for (uint32 i = 0; i < size; i += 2)
+		stream->writeUint16LE(READ_UINT16(_data.data() + i));
+#endif
+
+	stream->finalize();
+	if (stream->err())
+		warning("Could not write '%s'", _name.c_str());
+	else
+		debug(1, "Stored music in the render cache: '%s'", _name.c_str());
+
+	delete stream;
+}
+
+} // End of namespace MidiRenderCache
+} // End of namespace Audio
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIDICACHE_H
+#define AUDIO_MIDICACHE_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/str.h"
+#include "common/stream.h"
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * @defgroup audio_midicache Pre-rendered music cache
+ * @ingroup audio
+ *
+ * @brief Cache of music tracks rendered by emulated MIDI drivers.
+ *
+ * Tracks played through an emulated driver are recorded while they play,
+ * and stored compressed in the directory set by 'midi_render_cache_path'.
+ * The next time the same track is started with the same driver settings,
+ * it is played back from the cache instead of being synthesized. The cache
+ * is disabled if no directory is set.
+ *
+ * See Audio::MidiPlayer::useRenderCache() for the playback side.
+ * @{
+ */
+namespace MidiRenderCache {
+
+/**
+ * Return whether the cache is enabled.
+ */
+bool isEnabled();
+
+/**
+ * Return the name of the cache entry for a track. The name depends on the
+ * MIDI data, the track number, the output rate and volume, and the settings
+ * of the music drivers.
+ */
+Common::String makeName(const byte *data, uint32 size, int track, uint rate, int volume);
+
+/**
+ * Open the cache entry with the given name.
+ *
+ * @return The stream, or nullptr if there is no such entry
+ */
+SeekableAudioStream *open(const Common::String &name);
+
+/**
+ * Collects the samples of a track while it is recorded. The samples are
+ * written in native byte order, interleaved if stereo.
+ */
+class Recorder : public Common::WriteStream {
+public:
+	/**
+	 * Create a recorder. This allocates the buffer for the longest track
+	 * which can be recorded, so it must not be done in the audio or timer
+	 * threads either.
+	 */
+	Recorder(const Common::String &name, uint rate, bool stereo);
+
+	uint32 write(const void *dataPtr, uint32 dataSize) override;
+	int64 pos() const override { return _data.size(); }
+
+	/**
+	 * Return whether the track was too long to be recorded.
+	 */
+	bool isOverflowed() const { return _overflow; }
+
+	/**
+	 * Write the recorded track to the cache. This may take a while, so it
+	 * must not be done in the audio or timer threads.
+	 */
+	void save() const;
+
+private:
+	Common::String _name;
+	uint _rate;
+	bool _stereo;
+	uint32 _maxSize;
+	Common::Array<byte> _data;
+	bool _overflow;
+};
+
+} // End of namespace MidiRenderCache
+
+/** @} */
+} // End of namespace Audio
+
+#endif
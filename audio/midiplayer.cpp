@@ -20,7 +20,9 @@
  */
 
 #include "audio/midiplayer.h"
+#include "audio/midicache.h"
 #include "audio/midiparser.h"
+#include "audio/softsynth/emumidi.h"
 
 #include "common/config-manager.h"
 
@@ -33,7 +35,19 @@ MidiPlayer::MidiPlayer() :
 	_isLooping(false),
 	_isPlaying(false),
 	_masterVolume(0),
-	_nativeMT32(false) {
+	_nativeMT32(false),
+	_cacheSink(this),
+	_cachePlaying(false),
+	_cacheStream(nullptr),
+	_cacheStopPending(false),
+	_cacheDriver(nullptr),
+	_cacheRecorder(nullptr),
+	_cacheRecordPending(false),
+	_cacheRecordAbort(false),
+	_cacheRecordStopping(nullptr),
+	_cacheRecordKeep(false),
+	_cacheRecorded(nullptr),
+	_inTimer(false) {
 
 	memset(_channelsTable, 0, sizeof(_channelsTable));
 	memset(_channelsVolume, 127, sizeof(_channelsVolume));
@@ -55,6 +69,12 @@ MidiPlayer::~MidiPlayer() {
 		delete _driver;
 		_driver = nullptr;
 	}
+
+	// The driver is gone, so nothing is being played or recorded anymore
+	delete _cacheStream;
+	delete _cacheRecorder;
+	delete _cacheRecordStopping;
+	storeRenderCache();
 }
 
 void MidiPlayer::createDriver(int flags) {
@@ -75,6 +95,10 @@ void MidiPlayer::setVolume(int volume) {
 
 	Common::StackLock lock(_mutex);
 
+	// The cached tracks are rendered at a fixed volume
+	if (usingRenderCache())
+		leaveRenderCache();
+
 	_masterVolume = volume;
 	for (int i = 0; i < kNumChannels; ++i) {
 		if (_channelsTable[i]) {
@@ -93,6 +117,10 @@ void MidiPlayer::syncVolume() {
 
 
 void MidiPlayer::send(uint32 b) {
+	// MIDI data not coming from the parser cannot be cached
+	if (!_inTimer && usingRenderCache())
+		leaveRenderCache();
+
 	byte ch = (byte)(b & 0x0F);
 	if ((b & 0xFFF0) == 0x07B0) {
 		// Adjust volume changes by master volume
@@ -125,6 +153,19 @@ void MidiPlayer::sendToChannel(byte ch, uint32 b) {
 void MidiPlayer::metaEvent(byte type, byte *data, uint16 length) {
 	switch (type) {
 	case 0x2F:	// End of Track
+		if (_cacheRecorder && !_cacheRecordPending && !_cacheRecordAbort) {
+			if (_inTimer) {
+				// The track was recorded completely. The driver stops
+				// recording at this tick, and onTimer() keeps the recording
+				// once it has done so.
+				_cacheDriver->setCaptureStream(nullptr);
+				_cacheRecordStopping = _cacheRecorder;
+				_cacheRecordKeep = true;
+				_cacheRecorder = nullptr;
+			} else {
+				_cacheRecordAbort = true;
+			}
+		}
 		endOfTrack();
 		break;
 	default:
@@ -149,11 +190,52 @@ void MidiPlayer::timerCallback(void *data) {
 void MidiPlayer::onTimer() {
 	Common::StackLock lock(_mutex);
 
+	// The render cache is only handled here, since for emulated drivers
+	// this runs in sync with the rendering. The driver then starts and stops
+	// recording and playing back exactly at the current tick.
+	if (_cacheRecordAbort) {
+		_cacheDriver->setCaptureStream(nullptr);
+		_cacheRecordStopping = _cacheRecorder;
+		_cacheRecordKeep = false;
+		_cacheRecorder = nullptr;
+		_cacheRecordAbort = false;
+	}
+
+	if (_cacheRecordStopping && !_cacheDriver->isCapturing()) {
+		if (_cacheRecordKeep && !_cacheRecordStopping->isOverflowed()) {
+			delete _cacheRecorded;
+			_cacheRecorded = _cacheRecordStopping;
+		} else {
+			delete _cacheRecordStopping;
+		}
+		_cacheRecordStopping = nullptr;
+	}
+
+	if (_cacheRecordPending && !_cacheRecordStopping && _isPlaying && _parser) {
+		_cacheDriver->setCaptureStream(_cacheRecorder);
+		_cacheRecordPending = false;
+	}
+
+	if (_cacheStopPending) {
+		_cacheDriver->setPlaybackStream(nullptr);
+		_cacheStopPending = false;
+	}
+
+	if (_cacheStream && _isPlaying && _parser) {
+		_cacheDriver->setPlaybackStream(_cacheStream);
+		_cacheStream = nullptr;
+	}
+
+	if (_cachePlaying)
+		_cacheDriver->setPlaybackPaused(!_isPlaying);
+
 	// TODO: Maybe we can replace _isPlaying
 	// by a simple check for "_parser != 0" ?
 
 	if (_isPlaying && _parser) {
+		_inTimer = true;
 		_parser->onTimer();
+		_inTimer = false;
 	}
 }
 
@@ -161,6 +243,8 @@ void MidiPlayer::onTimer() {
 void MidiPlayer::stop() {
 	Common::StackLock lock(_mutex);
 
+	stopRenderCache();
+
 	_isPlaying = false;
 	if (_parser) {
 		_parser->unloadMusic();
@@ -182,7 +266,9 @@ void MidiPlayer::stop() {
 void MidiPlayer::pause() {
 //	debugC(2, kDraciSoundDebugLevel, "Pausing track %d", _track);
 	_isPlaying = false;
-	setVolume(-1);	// FIXME: This should be 0, shouldn't it?
+	// A cached track is paused by the driver, see onTimer()
+	if (!_cachePlaying)
+		setVolume(-1);	// FIXME: This should be 0, shouldn't it?
 }
 
 void MidiPlayer::resume() {
@@ -191,4 +277,96 @@ void MidiPlayer::resume() {
 	_isPlaying = true;
 }
 
+void MidiPlayer::useRenderCache(const byte *data, uint32 size, int track) {
+	Common::StackLock lock(_mutex);
+
+	if (!MidiRenderCache::isEnabled() || !_isPlaying || !_parser)
+		return;
+
+	MidiDriver_Emulated *driver = dynamic_cast<MidiDriver_Emulated *>(_driver);
+	if (!driver)
+		return;
+
+	stopRenderCache();
+	_cacheDriver = driver;
+
+	Common::String name = MidiRenderCache::makeName(data, size, track, driver->getRate(), _masterVolume);
+
+	SeekableAudioStream *stream = MidiRenderCache::open(name);
+	if (stream) {
+		// Keep the parser running for the timing and the end of the track
+		_parser->setMidiDriver(&_cacheSink);
+
+		// The stream is passed to the driver in onTimer()
+		_cacheStream = _isLooping ? makeLoopingAudioStream(stream, 0) : stream;
+		_cachePlaying = true;
+	} else if (!_cacheRecordAbort) {
+		// Otherwise, the recording of the previous track is still being
+		// stopped, and this one is recorded the next time it plays. The
+		// recorder is attached in onTimer().
+		_cacheRecorder = new MidiRenderCache::Recorder(name, driver->getRate(), driver->isStereo());
+		_cacheRecordPending = true;
+	}
+}
+
+void MidiPlayer::leaveRenderCache() {
+	Common::StackLock lock(_mutex);
+
+	bool wasPlaying = _cachePlaying;
+	stopRenderCache();
+
+	if (wasPlaying && _parser) {
+		// Bring the driver up to date with the programs and controllers of
+		// the track, without playing the notes which are already sounding
+		_parser->setMidiDriver(this);
+		_parser->jumpToTick(_parser->getTick(), true, true, true);
+	}
+}
+
+void MidiPlayer::storeRenderCache() {
+	MidiRenderCache::Recorder *recorded;
+	{
+		Common::StackLock lock(_mutex);
+		recorded = _cacheRecorded;
+		_cacheRecorded = nullptr;
+	}
+
+	if (recorded) {
+		recorded->save();
+		delete recorded;
+	}
+}
+
+bool MidiPlayer::usingRenderCache() const {
+	return _cachePlaying || (_cacheRecorder && !_cacheRecordAbort);
+}
+
+void MidiPlayer::stopRenderCache() {
+	// The driver stops playing the stream in onTimer(), unless it has not
+	// been passed to it yet
+	if (_cachePlaying) {
+		if (_cacheStream) {
+			delete _cacheStream;
+			_cacheStream = nullptr;
+		} else {
+			_cacheStopPending = true;
+		}
+		_cachePlaying = false;
+	}
+
+	// Likewise, an attached recorder is detached in onTimer()
+	if (_cacheRecordPending) {
+		delete _cacheRecorder;
+		_cacheRecorder = nullptr;
+		_cacheRecordPending = false;
+	} else if (_cacheRecorder) {
+		_cacheRecordAbort = true;
+	}
+}
+
+void MidiPlayer::CacheSink::metaEvent(byte type, byte *data, uint16 length) {
+	if (type == 0x2F)
+		_player->metaEvent(type, data, length);
+}
+
 } // End of namespace Audio
@@ -27,9 +27,16 @@
 #include "audio/mididrv.h"
 
 class MidiParser;
+class MidiDriver_Emulated;
 
 namespace Audio {
 
+class AudioStream;
+
+namespace MidiRenderCache {
+class Recorder;
+}
+
 /**
  * @defgroup audio_midiplayer MIDI player
  * @ingroup audio
@@ -121,11 +128,49 @@ public:
 	// TODO: Document this
 	bool hasNativeMT32() const { return _nativeMT32; }
 
+	/**
+	 * Write the last completely recorded track to the render cache, if
+	 * any. This may take a while, so call it from the engine when the
+	 * music changes, and without holding _mutex, since the driver's timer
+	 * callback waits for it.
+	 */
+	void storeRenderCache();
+
 	// MidiDriver_BASE implementation
 	void send(uint32 b) override;
 	void metaEvent(byte type, byte *data, uint16 length) override;
 
 protected:
+	/**
+	 * Play the track which was just started from the pre-rendered music
+	 * cache, if possible. Otherwise, the track is recorded while it plays,
+	 * so that it can be played from the cache the next time. Nothing is
+	 * done unless the cache is enabled and the driver is an emulated one.
+	 * See Audio::MidiRenderCache.
+	 *
+	 * Call this after _parser, _isLooping and the volume have been set up
+	 * and _isPlaying has been set. The parser has to send its MIDI data to
+	 * this player. Recorded tracks are kept in memory until
+	 * storeRenderCache() is called.
+	 *
+	 * While the track plays from the cache, the parser keeps running with
+	 * its MIDI data discarded. Live synthesis takes over again on volume
+	 * changes and on MIDI data sent by the engine rather than the parser.
+	 * Subclasses which bypass send() or change the playback otherwise have
+	 * to call leaveRenderCache() themselves.
+	 *
+	 * @param data  The MIDI data of the track, identifying it in the cache
+	 * @param size  The size of the MIDI data
+	 * @param track The track number passed to the parser
+	 */
+	void useRenderCache(const byte *data, uint32 size, int track);
+
+	/**
+	 * Switch from cached playback of the current track back to live
+	 * synthesis, and stop recording it.
+	 */
+	void leaveRenderCache();
+
 	/**
 	 * This method is invoked by the default send() implementation,
 	 * after suitably filtering the message b.
@@ -187,6 +232,45 @@ protected:
 	int _masterVolume;	// FIXME: byte or int ?
 
 	bool _nativeMT32;
+
+private:
+	/**
+	 * Receives the MIDI data of the parser while the track is played from
+	 * the render cache; only the end of the track is passed on.
+	 */
+	class CacheSink : public MidiDriver_BASE {
+	public:
+		CacheSink(MidiPlayer *player) : _player(player) {}
+
+		void send(uint32 b) override {}
+		void metaEvent(byte type, byte *data, uint16 length) override;
+
+	private:
+		MidiPlayer *_player;
+	};
+
+	bool usingRenderCache() const;
+	void stopRenderCache();
+
+	CacheSink _cacheSink;
+	bool _cachePlaying;
+
+	// The driver is only told to play and record in onTimer(), see there.
+	// Until then, the stream to play and the recorder are kept here.
+	MidiDriver_Emulated *_cacheDriver;
+	AudioStream *_cacheStream;
+	bool _cacheStopPending;
+	MidiRenderCache::Recorder *_cacheRecorder;
+	bool _cacheRecordPending;
+	bool _cacheRecordAbort;
+
+	// The recorder the driver is detaching, and whether to keep its track
+	MidiRenderCache::Recorder *_cacheRecordStopping;
+	bool _cacheRecordKeep;
+
+	MidiRenderCache::Recorder *_cacheRecorded;
+
+	bool _inTimer;
 };
 
 /** @} */
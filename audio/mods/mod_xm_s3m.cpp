@@ -109,6 +109,7 @@ private:
 	static const int FP_SHIFT;
 	static const int FP_ONE;
 	static const int FP_MASK;
+	enum { RESAMPLE_BLOCK = 256 };
 	static const int16 sinetable[];
 
 	int calculateDuration();
@@ -1169,61 +1170,88 @@ int ModXmS3mStream::seek(int samplePos) {
 }
 
 void ModXmS3mStream::resample(const Channel &channel, int *mixBuf, int offset, int count, int sampleRate) {
-	Sample *sample = channel.sample;
-	int lGain = 0, rGain = 0, samIdx = 0, samFra = 0, step = 0;
-	int loopLen = 0, loopEnd = 0, outIdx = 0, outEnd = 0, y = 0, m = 0, c = 0;
-	int16 *sampleData = channel.sample->data;
-	if (channel.ampl > 0) {
-		lGain = channel.ampl * (255 - channel.pann) >> 8;
-		rGain = channel.ampl * channel.pann >> 8;
-		samIdx = channel.sampleIdx;
-		samFra = channel.sampleFra;
-		step = (channel.freq << (FP_SHIFT - 3)) / (sampleRate >> 3);
-		loopLen = sample->loopLength;
-		loopEnd = sample->loopStart + loopLen;
-		outIdx = offset * 2;
-		outEnd = (offset + count) * 2;
-		if (_interpolation) {
-			while (outIdx < outEnd) {
-				if (samIdx >= loopEnd) {
-					if (loopLen > 1) {
-						while (samIdx >= loopEnd) {
-							samIdx -= loopLen;
-						}
-					} else {
-						break;
-					}
+	if (channel.ampl <= 0)
+		return;
+
+	const Sample *sample = channel.sample;
+	const int16 *sampleData = sample->data;
+	const int lGain = channel.ampl * (255 - channel.pann) >> 8;
+	const int rGain = channel.ampl * channel.pann >> 8;
+	const int step = (channel.freq << (FP_SHIFT - 3)) / (sampleRate >> 3);
+	const int loopLen = sample->loopLength;
+	const int loopEnd = sample->loopStart + loopLen;
+	int samIdx = channel.sampleIdx;
+	int samFra = channel.sampleFra;
+	int outIdx = offset * 2;
+	const int outEnd = (offset + count) * 2;
+	int block[RESAMPLE_BLOCK];
+
+	while (outIdx < outEnd) {
+		if (samIdx >= loopEnd) {
+			if (loopLen > 1) {
+				while (samIdx >= loopEnd) {
+					samIdx -= loopLen;
 				}
-				c = sampleData[samIdx];
-				m = sampleData[samIdx + 1] - c;
-				y = ((m * samFra) >> FP_SHIFT) + c;
-				mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
-				mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
+			} else {
+				break;
+			}
+		}
+		if (samIdx < 0 && _interpolation != 1)
+			samIdx = 0;
+
+		// Resample a run which ends before the loop end, so that the
+		// wrap around only has to be checked once per run
+		int length = MIN<int>((outEnd - outIdx) / 2, RESAMPLE_BLOCK);
+		if (step > 0)
+			length = (int)MIN<int64>(length, ((((int64)(loopEnd - samIdx) << FP_SHIFT) - samFra + step - 1) / step));
+		else if (step < 0)
+			length = 1;
+
+		switch (_interpolation) {
+		case 0:
+			for (int i = 0; i < length; i++) {
+				block[i] = sampleData[samIdx];
 				samFra += step;
 				samIdx += samFra >> FP_SHIFT;
 				samFra &= FP_MASK;
 			}
-		} else {
-			while (outIdx < outEnd) {
-				if (samIdx >= loopEnd) {
-					if (loopLen > 1) {
-						while (samIdx >= loopEnd) {
-							samIdx -= loopLen;
-						}
-					} else {
-						break;
-					}
-				}
-				if (samIdx < 0)
-					samIdx = 0;
-				y = sampleData[samIdx];
-				mixBuf[outIdx++] += (y * lGain) >> FP_SHIFT;
-				mixBuf[outIdx++] += (y * rGain) >> FP_SHIFT;
+			break;
+		case 2:
+			for (int i = 0; i < length; i++) {
+				// Catmull-Rom spline through the two samples around the
+				// position and their neighbours
+				const int p0 = sampleData[samIdx > 0 ? samIdx - 1 : 0];
+				const int p1 = sampleData[samIdx];
+				const int p2 = sampleData[samIdx + 1];
+				const int p3 = sampleData[samIdx + 2 <= loopEnd ? samIdx + 2 : (loopLen > 1 ? samIdx + 2 - loopLen : loopEnd)];
+				const int64 a = -p0 + 3 * p1 - 3 * p2 + p3;
+				const int64 b = 2 * p0 - 5 * p1 + 4 * p2 - p3;
+				const int64 c = p2 - p0;
+				int64 y = ((a * samFra) >> FP_SHIFT) + b;
+				y = ((y * samFra) >> FP_SHIFT) + c;
+				block[i] = (int)(((y * samFra) >> FP_SHIFT) / 2) + p1;
 				samFra += step;
 				samIdx += samFra >> FP_SHIFT;
 				samFra &= FP_MASK;
 			}
+			break;
+		default:
+			for (int i = 0; i < length; i++) {
+				const int c = sampleData[samIdx];
+				const int m = sampleData[samIdx + 1] - c;
+				block[i] = ((m * samFra) >> FP_SHIFT) + c;
+				samFra += step;
+				samIdx += samFra >> FP_SHIFT;
+				samFra &= FP_MASK;
+			}
+			break;
+		}
+
+		for (int i = 0; i < length; i++) {
+			mixBuf[outIdx + i * 2] += (block[i] * lGain) >> FP_SHIFT;
+			mixBuf[outIdx + i * 2 + 1] += (block[i] * rGain) >> FP_SHIFT;
 		}
+		outIdx += length * 2;
 	}
 }
 
@@ -83,7 +83,8 @@ class AudioStream;
  * @param disposeAfterUse	whether to delete the stream after use
  * @param initialPos		initial track to start playback from
  * @param rate				sample rate
- * @param interpolation		interpolation effect level
+ * @param interpolation		interpolation of the samples: 0 for none, 1 for linear,
+ *							2 for cubic
  */
 RewindableAudioStream *makeModXmS3mStream(Common::SeekableReadStream *stream,
 		DisposeAfterUse::Flag disposeAfterUse,
@@ -33,11 +33,10 @@
 #include <math.h>
 
 #include "common/scummsys.h"
-#include "common/translation.h"
+#include "common/system.h"
 
 #include "audio/mixer.h"
 #include "audio/mods/paula.h"
-#include "audio/null.h"
 
 namespace Audio {
 
@@ -64,6 +63,7 @@ Paula::Paula(bool stereo, int rate, uint interruptFreq, FilterMode filterMode, i
 	_curInt = 0;
 	_timerBase = 1;
 	_playing = false;
+	_interpolation = kInterpolationNone;
 	_end = true;
 }
 
@@ -122,58 +122,166 @@ int Paula::readBuffer(int16 *buffer, const int numSamples) {
  * The current filtering should be accurate to 2 dB with the filter on,
  * and to 1 dB with the filter off.
  */
-inline int32 filter(int32 input, Paula::FilterState &state, int voice) {
+static void filterBlock(int32 *samples, int count, Paula::FilterState &state, int voice) {
+	float *rc = state.rc[voice];
 	float normalOutput, ledOutput;
 
 	switch (state.mode) {
 	case Paula::kFilterModeA500:
-		state.rc[voice][0] = state.a0[0] * input + (1 - state.a0[0]) * state.rc[voice][0] + DENORMAL_OFFSET;
-		state.rc[voice][1] = state.a0[1] * state.rc[voice][0] + (1-state.a0[1]) * state.rc[voice][1];
-		normalOutput = state.rc[voice][1];
+		for (int i = 0; i < count; i++) {
+			rc[0] = state.a0[0] * samples[i] + (1 - state.a0[0]) * rc[0] + DENORMAL_OFFSET;
+			rc[1] = state.a0[1] * rc[0] + (1-state.a0[1]) * rc[1];
+			normalOutput = rc[1];
 
-		state.rc[voice][2] = state.a0[2] * normalOutput        + (1 - state.a0[2]) * state.rc[voice][2];
-		state.rc[voice][3] = state.a0[2] * state.rc[voice][2]  + (1 - state.a0[2]) * state.rc[voice][3];
-		state.rc[voice][4] = state.a0[2] * state.rc[voice][3]  + (1 - state.a0[2]) * state.rc[voice][4];
+			rc[2] = state.a0[2] * normalOutput + (1 - state.a0[2]) * rc[2];
+			rc[3] = state.a0[2] * rc[2]        + (1 - state.a0[2]) * rc[3];
+			rc[4] = state.a0[2] * rc[3]        + (1 - state.a0[2]) * rc[4];
 
-		ledOutput = state.rc[voice][4];
+			ledOutput = rc[4];
+			samples[i] = CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+		}
 		break;
 
 	case Paula::kFilterModeA1200:
-		normalOutput = input;
+		for (int i = 0; i < count; i++) {
+			normalOutput = samples[i];
 
-		state.rc[voice][1] = state.a0[2] * normalOutput        + (1 - state.a0[2]) * state.rc[voice][1] + DENORMAL_OFFSET;
-		state.rc[voice][2] = state.a0[2] * state.rc[voice][1]  + (1 - state.a0[2]) * state.rc[voice][2];
-		state.rc[voice][3] = state.a0[2] * state.rc[voice][2]  + (1 - state.a0[2]) * state.rc[voice][3];
+			rc[1] = state.a0[2] * normalOutput + (1 - state.a0[2]) * rc[1] + DENORMAL_OFFSET;
+			rc[2] = state.a0[2] * rc[1]        + (1 - state.a0[2]) * rc[2];
+			rc[3] = state.a0[2] * rc[2]        + (1 - state.a0[2]) * rc[3];
 
-		ledOutput = state.rc[voice][3];
+			ledOutput = rc[3];
+			samples[i] = CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+		}
 		break;
 
 	case Paula::kFilterModeNone:
 	default:
-		return input;
+		break;
+	}
+}
+
+enum {
+	// Number of sample frames of a voice which are processed at once
+	kMixBlockSize = 256
+};
+
+// Return the number of samples which can be generated before the offset
+// reaches the end of the sample data, but at most maxSamples.
+inline int samplesUntilEnd(const Paula::Offset &offset, frac_t rate, uint bufSize, int maxSamples) {
+	if (offset.int_off >= bufSize)
+		return 0;
+	if (rate <= 0)
+		return maxSamples;
+
+	const uint64 left = ((uint64)(bufSize - offset.int_off) << FRAC_BITS) - offset.rem_off;
+	return (int)MIN<uint64>((left + rate - 1) / rate, maxSamples);
+}
+
+// Return the sample at the given index, continuing into the repeat data
+// past the end of the sample data. Only used for interpolation.
+inline int sampleAt(const int8 *data, uint bufSize, const int8 *next, uint nextSize, uint index) {
+	if (index < bufSize)
+		return data[index];
+
+	index -= bufSize;
+	return (next && index < nextSize) ? next[index] : data[bufSize - 1];
+}
+
+// Fetch the next count samples, scaled by the volume, and step the offset
+inline void fetchBlock(int32 *samples, int count, Paula::InterpolationMode interpolation, const int8 *data, uint bufSize, const int8 *next, uint nextSize,
+		Paula::Offset &offset, frac_t rate, byte volume) {
+	uint intOff = offset.int_off;
+	frac_t remOff = offset.rem_off;
+
+	switch (interpolation) {
+	case Paula::kInterpolationLinear:
+		for (int i = 0; i < count; i++) {
+			const int s0 = data[intOff];
+			const int s1 = sampleAt(data, bufSize, next, nextSize, intOff + 1);
+
+			// Interpolate with 8 fractional bits
+			const int32 y = (s0 << 8) + (((s1 - s0) * remOff) >> 8);
+			samples[i] = (y * volume) >> 8;
+
+			remOff += rate;
+			intOff += remOff >> FRAC_BITS;
+			remOff &= FRAC_LO_MASK;
+		}
+		break;
+
+	case Paula::kInterpolationCubic:
+		for (int i = 0; i < count; i++) {
+			const int p0 = intOff ? data[intOff - 1] : data[intOff];
+			const int p1 = data[intOff];
+			const int p2 = sampleAt(data, bufSize, next, nextSize, intOff + 1);
+			const int p3 = sampleAt(data, bufSize, next, nextSize, intOff + 2);
+
+			// Catmull-Rom spline, with the coefficients doubled and 8
+			// fractional bits
+			const int64 a = (-p0 + 3 * p1 - 3 * p2 + p3) << 8;
+			const int64 b = (2 * p0 - 5 * p1 + 4 * p2 - p3) << 8;
+			const int64 c = (p2 - p0) << 8;
+			int64 y = ((a * remOff) >> FRAC_BITS) + b;
+			y = ((y * remOff) >> FRAC_BITS) + c;
+			y = ((y * remOff) >> FRAC_BITS) / 2 + (p1 << 8);
+			samples[i] = (int32)((y * volume) >> 8);
+
+			remOff += rate;
+			intOff += remOff >> FRAC_BITS;
+			remOff &= FRAC_LO_MASK;
+		}
+		break;
+
+	case Paula::kInterpolationNone:
+	default:
+		for (int i = 0; i < count; i++) {
+			samples[i] = ((int32)data[intOff]) * volume;
 
+			remOff += rate;
+			intOff += remOff >> FRAC_BITS;
+			remOff &= FRAC_LO_MASK;
+		}
+		break;
 	}
 
-	return CLIP<int32>(state.ledFilter ? ledOutput : normalOutput, -32768, 32767);
+	offset.int_off = intOff;
+	offset.rem_off = remOff;
 }
 
 template<bool stereo>
-inline int mixBuffer(int16 *&buf, const int8 *data, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize, byte volume, byte panning, Paula::FilterState &filterState, int voice) {
-	int samples;
-	for (samples = 0; samples < neededSamples && offset.int_off < bufSize; ++samples) {
-		const int32 tmp = filter(((int32) data[offset.int_off]) * volume, filterState, voice);
-		if (stereo) {
-			*buf++ += (tmp * (255 - panning)) >> 7;
-			*buf++ += (tmp * (panning)) >> 7;
-		} else
-			*buf++ += tmp;
-
-		// Step to next source sample
-		offset.rem_off += rate;
-		if (offset.rem_off >= (frac_t)FRAC_ONE) {
-			offset.int_off += fracToInt(offset.rem_off);
-			offset.rem_off &= FRAC_LO_MASK;
+inline void mixBlock(int16 *&buf, const int32 *samples, int count, byte panning) {
+	if (stereo) {
+		const int32 left = 255 - panning;
+		const int32 right = panning;
+		for (int i = 0; i < count; i++) {
+			buf[2 * i]     += (samples[i] * left) >> 7;
+			buf[2 * i + 1] += (samples[i] * right) >> 7;
 		}
+		buf += 2 * count;
+	} else {
+		for (int i = 0; i < count; i++)
+			buf[i] += samples[i];
+		buf += count;
+	}
+}
+
+// Mix samples until neededSamples are generated or the end of the sample data
+// is reached, in blocks. The samples of a block are fetched, filtered and then
+// mixed in separate passes, so that each of the loops is simple enough for
+// the compiler to optimize, and vectorize where possible.
+template<bool stereo>
+inline int mixBuffer(int16 *&buf, const int8 *data, const int8 *next, uint nextSize, Paula::Offset &offset, frac_t rate, int neededSamples, uint bufSize,
+		byte volume, byte panning, Paula::InterpolationMode interpolation, Paula::FilterState &filterState, int voice) {
+	const int samples = samplesUntilEnd(offset, rate, bufSize, neededSamples);
+
+	int32 block[kMixBlockSize];
+	for (int done = 0; done < samples; done += kMixBlockSize) {
+		const int count = MIN<int>(samples - done, kMixBlockSize);
+
+		fetchBlock(block, count, interpolation, data, bufSize, next, nextSize, offset, rate, volume);
+		filterBlock(block, count, filterState, voice);
+		mixBlock<stereo>(buf, block, count, panning);
 	}
 
 	return samples;
@@ -225,7 +333,10 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 			// by the OS/2 version of Hopkins FBI.
 
 			// Mix the generated samples into the output buffer
-			neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, _filterState, voice);
+			// The data following the sample data, for interpolation
+			const int8 *next = (ch.dataRepeat && ch.lengthRepeat > 2) ? ch.dataRepeat : nullptr;
+
+			neededSamples -= mixBuffer<stereo>(p, ch.data, next, ch.lengthRepeat, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, _interpolation, _filterState, voice);
 
 			// Wrap around if necessary
 			if (ch.offset.int_off >= ch.length) {
@@ -256,7 +367,7 @@ int Paula::readBufferIntern(int16 *buffer, const int numSamples) {
 				// Repeat as long as necessary.
 				while (neededSamples > 0) {
 					// Mix the generated samples into the output buffer
-					neededSamples -= mixBuffer<stereo>(p, ch.data, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, _filterState, voice);
+					neededSamples -= mixBuffer<stereo>(p, ch.data, next, ch.lengthRepeat, ch.offset, rate, neededSamples, ch.length, ch.volume, ch.panning, _interpolation, _filterState, voice);
 
 					if (ch.offset.int_off >= ch.length) {
 						// Wrap around. See also the note above.
@@ -302,33 +413,3 @@ float Paula::filterCalculateA0(int rate, int cutoff) {
 
 } // End of namespace Audio
 
-
-//	Plugin interface
-//	(This can only create a null driver since apple II gs support seeems not to be implemented
-//  and also is not part of the midi driver architecture. But we need the plugin for the options
-//  menu in the launcher and for MidiDriver::detectDevice() which is more or less used by all engines.)
-
-class AmigaMusicPlugin : public NullMusicPlugin {
-public:
-	const char *getName() const override {
-		return _s("Amiga Audio emulator");
-	}
-
-	const char *getId() const override {
-		return "amiga";
-	}
-
-	MusicDevices getDevices() const override;
-};
-
-MusicDevices AmigaMusicPlugin::getDevices() const {
-	MusicDevices devices;
-	devices.push_back(MusicDevice(this, "", MT_AMIGA));
-	return devices;
-}
-
-//#if PLUGIN_ENABLED_DYNAMIC(AMIGA)
-	//REGISTER_PLUGIN_DYNAMIC(AMIGA, PLUGIN_TYPE_MUSIC, AmigaMusicPlugin);
-//#else
-	REGISTER_PLUGIN_STATIC(AMIGA, PLUGIN_TYPE_MUSIC, AmigaMusicPlugin);
-//#endif
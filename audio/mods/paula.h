@@ -61,6 +61,17 @@ public:
 #endif
 	};
 
+	/**
+	 * How the samples are resampled to the output rate. The real chip does
+	 * not interpolate, so kInterpolationNone is the default and the most
+	 * authentic; the others sound smoother at low periods.
+	 */
+	enum InterpolationMode {
+		kInterpolationNone = 0,
+		kInterpolationLinear,
+		kInterpolationCubic
+	};
+
 	/* TODO: Document this */
 	struct Offset {
 		uint	int_off;	// integral part of the offset
@@ -97,6 +108,8 @@ public:
 	void startPlay() { filterResetState(); _playing = true; }
 	void stopPlay() { _playing = false; }
 	void pausePlay(bool pause) { _playing = !pause; }
+	void setInterpolation(InterpolationMode mode) { _interpolation = mode; }
+	InterpolationMode getInterpolation() const { return _interpolation; }
 
 // AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
@@ -229,6 +242,7 @@ private:
 	uint _curInt;
 	uint32 _timerBase;
 	bool _playing;
+	InterpolationMode _interpolation;
 
 	FilterState _filterState;
 
@@ -7,6 +7,7 @@ MODULE_OBJS := \
 	casio.o \
 	cms.o \
 	fmopl.o \
+	midicache.o \
 	mididrv.o \
 	mididrv_ms.o \
 	midiparser_qt.o \
@@ -21,6 +22,7 @@ MODULE_OBJS := \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
+	opl_dump.o \
 	rate.o \
 	timestamp.o \
 	decoders/3do.o \
@@ -51,6 +53,7 @@ MODULE_OBJS := \
 	mods/module_mod_xm_s3m.o \
 	mods/protracker.o \
 	mods/paula.o \
+	mods/paula_plugin.o \
 	mods/rjp1.o \
 	mods/soundfx.o \
 	mods/tfmx.o \
@@ -70,6 +73,7 @@ MODULE_OBJS := \
 	softsynth/fluidsynth.o \
 	softsynth/mt32.o \
 	softsynth/eas.o \
+	softsynth/emumidi.o \
 	softsynth/pcspk.o \
 	softsynth/sid.o \
 	softsynth/wave6581.o \
@@ -0,0 +1,261 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/* OPL wrapper which logs all register writes to 'dump.dro'.
+ *
+ * The log uses the DOSBox Raw OPL v2.0 format, which is understood by most
+ * OPL players and can be replayed by the 'opl' benchmark suite. Each write
+ * is stamped with the system time at which it happens. Writes come from the
+ * engine thread as well as from the OPL timer callbacks, so the log is
+ * guarded by a mutex.
+ *
+ * Caveats and limitations:
+ * - Writes to registers which do not exist on the chip are not logged.
+ * - Resets of the chip are not logged.
+ */
+
+#include "audio/fmopl.h"
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/file.h"
+#include "common/func.h"
+#include "common/mutex.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace OPL {
+namespace DRODump {
+
+class OPL : public ::OPL::OPL {
+private:
+	enum {
+		kShortDelayCode = 0x7E,
+		kLongDelayCode = 0x7F,
+		kBankFlag = 0x80,
+		kInvalidCode = 0xFF
+	};
+
+	::OPL::OPL *_opl;
+	Config::OplType _type;
+	int _address[2];
+
+	byte _regToCode[256];
+	Common::Array<byte> _codeMap;
+
+	Common::Mutex _mutex;
+	Common::Array<byte> _data;
+	uint32 _pairs;
+	uint32 _startMillis;
+	uint32 _lastMillis;
+
+	static bool isValidRegister(int r);
+
+	void onTimer();
+	void logWrite(int r, int v);
+	void logDelay(uint32 millis);
+	void writeDump(uint32 length);
+
+public:
+	OPL(::OPL::OPL *opl, Config::OplType type);
+	~OPL();
+
+	bool init() override { return _opl->init(); }
+	void reset() override { _opl->reset(); }
+
+	void write(int a, int v) override;
+	byte read(int a) override { return _opl->read(a); }
+
+	void writeReg(int r, int v) override;
+
+	void setCallbackFrequency(int timerFrequency) override;
+
+protected:
+	void startCallbacks(int timerFrequency) override;
+	void stopCallbacks() override;
+};
+
+OPL::OPL(::OPL::OPL *opl, Config::OplType type) : ::OPL::OPL(false),
+	_opl(opl), _type(type), _pairs(0), _startMillis(g_system->getMillis()), _lastMillis(0) {
+	_address[0] = _address[1] = 0;
+
+	// Only the registers which exist on the chip get a code, so that all
+	// of them fit into the 7 bits available in the format.
+	memset(_regToCode, kInvalidCode, sizeof(_regToCode));
+	for (int r = 0; r < 256; r++) {
+		if (isValidRegister(r)) {
+			_regToCode[r] = _codeMap.size();
+			_codeMap.push_back(r);
+		}
+	}
+	assert(_codeMap.size() <= kShortDelayCode);
+}
+
+OPL::~OPL() {
+	stop();
+	delete _opl;
+
+	if (_pairs)
+		writeDump(g_system->getMillis() - _startMillis);
+}
+
+bool OPL::isValidRegister(int r) {
+	if (r < 0x20)
+		return (r >= 0x01 && r <= 0x05) || r == 0x08;
+
+	// Operator registers, with 18 slots in each group
+	if (r < 0xA0 || r >= 0xE0) {
+		const int slot = r & 0x1F;
+		return r <= 0xF5 && slot < 0x16 && (slot & 0x07) < 6;
+	}
+
+	// Channel registers, with 9 channels in each group
+	return r == 0xBD || (r < 0xD0 && (r & 0x0F) < 9);
+}
+
+void OPL::write(int a, int v) {
+	if (!(a & 1)) {
+		// Latch the address just like the chips do
+		switch (_type) {
+		case Config::kOpl2:
+			_address[0] = v & 0xFF;
+			break;
+		case Config::kDualOpl2:
+			if (!(a & 0x8)) {
+				_address[(a & 2) >> 1] = v & 0xFF;
+			} else {
+				_address[0] = v & 0xFF;
+				_address[1] = v & 0xFF;
+			}
+			break;
+		case Config::kOpl3:
+			_address[0] = (v & 0xFF) | ((a & 2) << 7);
+			break;
+		default:
+			break;
+		}
+	} else if (_type == Config::kDualOpl2) {
+		if (!(a & 0x8)) {
+			const int index = (a & 2) >> 1;
+			logWrite(_address[index] | (index << 8), v);
+		} else {
+			logWrite(_address[0], v);
+			logWrite(_address[1] | 0x100, v);
+		}
+	} else {
+		logWrite(_address[0], v);
+	}
+
+	_opl->write(a, v);
+}
+
+void OPL::writeReg(int r, int v) {
+	logWrite(r, v);
+	_opl->writeReg(r, v);
+}
+
+void OPL::setCallbackFrequency(int timerFrequency) {
+	_opl->setCallbackFrequency(timerFrequency);
+}
+
+void OPL::startCallbacks(int timerFrequency) {
+	_opl->start(new Common::Functor0Mem<void, OPL>(this, &OPL::onTimer), timerFrequency);
+}
+
+void OPL::stopCallbacks() {
+	_opl->stop();
+}
+
+void OPL::onTimer() {
+	if (_callback && _callback->isValid())
+		(*_callback)();
+}
+
+void OPL::logWrite(int r, int v) {
+	const byte code = _regToCode[r & 0xFF];
+	if (code == kInvalidCode)
+		return;
+
+	Common::StackLock lock(_mutex);
+	logDelay(g_system->getMillis() - _startMillis);
+
+	_data.push_back(code | ((r & 0x100) ? kBankFlag : 0));
+	_data.push_back(v);
+	_pairs++;
+}
+
+void OPL::logDelay(uint32 millis) {
+	uint32 delay = millis - _lastMillis;
+	_lastMillis = millis;
+
+	// Long delays are in units of 256 ms, short delays in units of 1 ms;
+	// both store the delay minus one.
+	while (delay >= 256) {
+		const uint32 count = MIN<uint32>(delay >> 8, 256);
+		_data.push_back(kLongDelayCode);
+		_data.push_back(count - 1);
+		_pairs++;
+		delay -= count << 8;
+	}
+
+	if (delay) {
+		_data.push_back(kShortDelayCode);
+		_data.push_back(delay - 1);
+		_pairs++;
+	}
+}
+
+void OPL::writeDump(uint32 length) {
+	static const byte hardwareTypes[] = { 0, 1, 2 };
+
+	Common::DumpFile dumpFile;
+	if (!dumpFile.open("dump.dro")) {
+		warning("Could not open 'dump.dro' for writing");
+		return;
+	}
+
+	dumpFile.write("DBRAWOPL", 8);
+	dumpFile.writeUint16LE(2);						// major version
+	dumpFile.writeUint16LE(0);						// minor version
+	dumpFile.writeUint32LE(_pairs);
+	dumpFile.writeUint32LE(length);
+	dumpFile.writeByte(hardwareTypes[_type]);
+	dumpFile.writeByte(0);							// format: interleaved register/value pairs
+	dumpFile.writeByte(0);							// compression: none
+	dumpFile.writeByte(kShortDelayCode);
+	dumpFile.writeByte(kLongDelayCode);
+	dumpFile.writeByte(_codeMap.size());
+	dumpFile.write(_codeMap.data(), _codeMap.size());
+	dumpFile.write(_data.data(), _data.size());
+	dumpFile.finalize();
+	dumpFile.close();
+
+	debug("Ending OPL dump, created 'dump.dro'");
+}
+
+::OPL::OPL *create(::OPL::OPL *opl, Config::OplType type) {
+	debug("Starting OPL dump");
+	return new OPL(opl, type);
+}
+
+} // End of namespace DRODump
+} // End of namespace OPL
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+enum {
+	kRenderChunk = 512,         // sample frames rendered at once when rendering ahead
+	kRenderInterval = 5000,     // microseconds between render-ahead callbacks
+	kMaxChunksPerCall = 8
+};
+
+void MidiDriver_Emulated::startRenderAhead(int renderAheadMs, Common::TimerManager::TimerProc proc, const char *id) {
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	if (renderAheadMs <= 0 || !timerManager || _buffer)
+		return;
+
+	const int stereoFactor = isStereo() ? 2 : 1;
+	_renderAhead = (uint)(getRate() * MIN(renderAheadMs, 1000) / 1000);
+	_bufferSize = _renderAhead + kRenderChunk;
+	_buffer = new int16[_bufferSize * stereoFactor];
+	_bufferRead = 0;
+	_bufferFill = 0;
+
+	if (timerManager->installTimerProc(proc, kRenderInterval, this, id)) {
+		_renderAheadProc = proc;
+	} else {
+		delete[] _buffer;
+		_buffer = nullptr;
+	}
+}
+
+void MidiDriver_Emulated::stopRenderAhead() {
+	if (_renderAheadProc) {
+		g_system->getTimerManager()->removeTimerProc(_renderAheadProc);
+		_renderAheadProc = nullptr;
+	}
+
+	delete[] _buffer;
+	_buffer = nullptr;
+	_bufferSize = 0;
+	_renderAhead = 0;
+}
+
+uint MidiDriver_Emulated::readAhead(int16 *data, uint frames) {
+	Common::StackLock lock(_bufferMutex);
+	const int stereoFactor = isStereo() ? 2 : 1;
+	uint done = 0;
+	while (done < frames && _bufferFill > 0) {
+		uint count = MIN(MIN(frames - done, _bufferFill), _bufferSize - _bufferRead);
+		memcpy(data + done * stereoFactor, _buffer + _bufferRead * stereoFactor, count * stereoFactor * sizeof(int16));
+		done += count;
+		_bufferFill -= count;
+		_bufferRead = (_bufferRead + count) % _bufferSize;
+	}
+	return done;
+}
+
+void MidiDriver_Emulated::renderAhead() {
+	Common::StackLock lock(_renderMutex);
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	// Render at most a few chunks per call, to not hold up other timers
+	for (int i = 0; i < kMaxChunksPerCall; i++) {
+		uint writePos, count;
+		{
+			Common::StackLock bufferLock(_bufferMutex);
+			if (!_buffer || _bufferFill >= _renderAhead)
+				return;
+			writePos = (_bufferRead + _bufferFill) % _bufferSize;
+			count = MIN<uint>(MIN<uint>(kRenderChunk, _renderAhead - _bufferFill), _bufferSize - writePos);
+		}
+
+		// The free part of the ring is not touched by readAhead(), so it can
+		// be rendered into without holding the buffer lock
+		renderBuffer(_buffer + writePos * stereoFactor, count * stereoFactor);
+
+		Common::StackLock bufferLock(_bufferMutex);
+		_bufferFill += count;
+	}
+}
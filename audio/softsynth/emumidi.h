@@ -26,6 +26,9 @@
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
 
+#include "common/mutex.h"
+#include "common/stream.h"
+
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
 	bool _isOpen;
@@ -43,12 +46,173 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	// Number of sample frames rendered so far, and the position at which
+	// the MIDI data being sent right now takes effect. _synthTimestamp is
+	// the same position without the frames output from a playback stream.
+	uint32 _samplePos;
+	uint32 _eventTimestamp;
+	uint32 _synthTimestamp;
+
+	void setEventTimestamp(uint32 timestamp) {
+		if (_timestampMutex) {
+			Common::StackLock lock(*_timestampMutex);
+			_eventTimestamp = timestamp;
+			_synthTimestamp = timestamp - _playbackFrames;
+		} else {
+			_eventTimestamp = timestamp;
+			_synthTimestamp = timestamp - _playbackFrames;
+		}
+	}
+
+	void processTick() {
+		if (_timerProc)
+			(*_timerProc)(_timerParam);
+
+		onTimer();
+
+		_nextTick += _samplesPerTick;
+	}
+
+	// Render-ahead ring buffer (interleaved if stereo). It is filled from a
+	// timer callback, so that the mixer callback only has to copy samples.
+	// _renderMutex serializes rendering, _bufferMutex guards the ring state.
+	Common::Mutex _renderMutex;
+	Common::Mutex _bufferMutex;
+	int16 *_buffer;
+	uint _bufferSize;
+	uint _bufferRead;
+	uint _bufferFill;
+	uint _renderAhead;
+	Common::TimerManager::TimerProc _renderAheadProc;
+
+	uint readAhead(int16 *data, uint frames);
+
+	// Capture of the rendered samples, from the sample position at which it
+	// was started up to the one at which it was stopped
+	Common::WriteStream *_captureStream;
+	uint32 _captureStart;
+	uint32 _captureEnd;
+	bool _captureStopping;
+
+	// Stream played instead of the synthesized output, and the one replacing
+	// it at sample position _playbackSwitch
+	Audio::AudioStream *_playbackStream;
+	Audio::AudioStream *_nextPlaybackStream;
+	uint32 _playbackSwitch;
+	bool _playbackSwitchPending;
+	bool _playbackPaused;
+	uint32 _playbackFrames;
+
+	void produceSamples(int16 *data, int len) {
+		const int stereoFactor = isStereo() ? 2 : 1;
+
+		while (len > 0) {
+			int step = len;
+			if (_playbackSwitchPending) {
+				const int32 ahead = (int32)(_playbackSwitch - _samplePos);
+				if (ahead <= 0) {
+					delete _playbackStream;
+					_playbackStream = _nextPlaybackStream;
+					_nextPlaybackStream = nullptr;
+					_playbackSwitchPending = false;
+					continue;
+				}
+				step = MIN<int>(len, ahead);
+			}
+
+			if (!_playbackStream) {
+				generateSamples(data, step);
+			} else {
+				int done = _playbackPaused ? 0 : _playbackStream->readBuffer(data, step * stereoFactor);
+				if (done < step * stereoFactor)
+					memset(data + MAX(done, 0), 0, (step * stereoFactor - MAX(done, 0)) * sizeof(int16));
+				_playbackFrames += step;
+			}
+
+			_samplePos += step;
+			data += step * stereoFactor;
+			len -= step;
+		}
+	}
+
+	void captureSamples(const int16 *data, uint32 start, int len) {
+		if (!_captureStream)
+			return;
+
+		const int stereoFactor = isStereo() ? 2 : 1;
+		const uint32 end = start + len;
+		uint32 from = start, to = end;
+		if ((int32)(_captureStart - from) > 0)
+			from = _captureStart;
+		if (_captureStopping && (int32)(to - _captureEnd) > 0)
+			to = _captureEnd;
+
+		if ((int32)(to - from) > 0)
+			_captureStream->write(data + (from - start) * stereoFactor, (to - from) * stereoFactor * sizeof(int16));
+
+		if (_captureStopping && (int32)(end - _captureEnd) >= 0) {
+			_captureStream = nullptr;
+			_captureStopping = false;
+		}
+	}
+
 protected:
 	int _baseFreq;
 
+	/**
+	 * Lock held while the event timestamp is updated. Drivers with
+	 * hasEventTimestamps() set this to the lock they hold when calling
+	 * getEventTimestamp(), since MIDI data may be sent from another thread
+	 * than the one rendering the audio.
+	 */
+	Common::Mutex *_timestampMutex;
+
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Drivers which can defer MIDI data to the sample position returned by
+	 * getEventTimestamp() should return true here. The timer ticks falling
+	 * into a buffer are then all processed before the buffer is rendered,
+	 * in a single generateSamples() call. Otherwise, rendering is split at
+	 * each tick and the MIDI data takes effect immediately.
+	 *
+	 * The OPL based drivers are not built on this class: OPL::EmulatedOPL
+	 * does the same for the register writes of its own timer callbacks.
+	 */
+	virtual bool hasEventTimestamps() const { return false; }
+
+	/**
+	 * Return the output sample position (counted in sample frames since
+	 * open()) at which MIDI data sent now should take effect. This is the
+	 * position of the current timer tick while the timer callback runs,
+	 * and the start of the next rendered buffer otherwise. The frames
+	 * output from a playback stream instead of generateSamples() are not
+	 * counted. Must be called with _timestampMutex held.
+	 */
+	uint32 getEventTimestamp() const { return _synthTimestamp; }
+
+	/**
+	 * Start rendering up to renderAheadMs milliseconds of audio ahead of the
+	 * mixer, from a timer callback. The music, and any MIDI data sent, is
+	 * delayed by that time. If the buffer runs empty, the missing samples
+	 * are rendered in the mixer callback as usual.
+	 *
+	 * The timer manager does not allow a callback to be installed twice, so
+	 * each driver class passes its own, which has to call renderAhead().
+	 * Nothing is done if renderAheadMs is 0 or there is no timer manager.
+	 */
+	void startRenderAhead(int renderAheadMs, Common::TimerManager::TimerProc proc, const char *id);
+
+	/**
+	 * Stop rendering ahead. Must be called after the mixer stream has been
+	 * stopped, and before the synth is shut down.
+	 */
+	void stopRenderAhead();
+
+	/** Fill the render-ahead buffer; called from the timer callback. */
+	void renderAhead();
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -57,7 +221,32 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
-		_baseFreq(250) {
+		_samplePos(0),
+		_eventTimestamp(0),
+		_synthTimestamp(0),
+		_buffer(nullptr),
+		_bufferSize(0),
+		_bufferRead(0),
+		_bufferFill(0),
+		_renderAhead(0),
+		_renderAheadProc(nullptr),
+		_captureStream(nullptr),
+		_captureStart(0),
+		_captureEnd(0),
+		_captureStopping(false),
+		_playbackStream(nullptr),
+		_nextPlaybackStream(nullptr),
+		_playbackSwitch(0),
+		_playbackSwitchPending(false),
+		_playbackPaused(false),
+		_playbackFrames(0),
+		_baseFreq(250),
+		_timestampMutex(nullptr) {
+	}
+
+	~MidiDriver_Emulated() {
+		delete _playbackStream;
+		delete _nextPlaybackStream;
 	}
 
 	// MidiDriver API
@@ -72,6 +261,11 @@ public:
 
 		_samplesPerTick = (d << FIXP_SHIFT) + (r << FIXP_SHIFT) / _baseFreq;
 
+		_nextTick = 0;
+		_samplePos = 0;
+		_playbackFrames = 0;
+		setEventTimestamp(0);
+
 		return 0;
 	}
 
@@ -86,38 +280,144 @@ public:
 		return 1000000 / _baseFreq;
 	}
 
+	/**
+	 * Write a copy of the samples rendered from the current event timestamp
+	 * on to the given stream, in native byte order. If stream is nullptr,
+	 * stop at the current event timestamp instead. The samples up to there
+	 * may not have been rendered yet, so the stream stays in use until
+	 * isCapturing() returns false.
+	 *
+	 * This must only be called from the timer callback, which runs in sync
+	 * with the rendering.
+	 */
+	void setCaptureStream(Common::WriteStream *stream) {
+		if (stream) {
+			_captureStream = stream;
+			_captureStart = _eventTimestamp;
+			_captureStopping = false;
+		} else if (_captureStream) {
+			_captureEnd = _eventTimestamp;
+			_captureStopping = true;
+		}
+	}
+
+	/**
+	 * Return whether the stream passed to setCaptureStream() is still in
+	 * use. Like setCaptureStream(), this must only be called from the timer
+	 * callback.
+	 */
+	bool isCapturing() const { return _captureStream != nullptr; }
+
+	/**
+	 * Output the samples of the given stream instead of the synthesized
+	 * ones, from the current event timestamp on, or go back to synthesis if
+	 * stream is nullptr. The stream must have the rate and channels of the
+	 * driver. The driver takes ownership of it, and silence is output once
+	 * it ends.
+	 *
+	 * This must only be called from the timer callback, which runs in sync
+	 * with the rendering.
+	 */
+	void setPlaybackStream(Audio::AudioStream *stream) {
+		delete _nextPlaybackStream;
+		_nextPlaybackStream = stream;
+		_playbackSwitch = _eventTimestamp;
+		_playbackSwitchPending = true;
+	}
+
+	/**
+	 * Output silence instead of the playback stream while paused. This must
+	 * only be called from the timer callback.
+	 */
+	void setPlaybackPaused(bool paused) {
+		_playbackPaused = paused;
+	}
+
 	// AudioStream API
 	virtual int readBuffer(int16 *data, const int numSamples) {
+		if (!_buffer)
+			return renderBuffer(data, numSamples);
+
+		const int stereoFactor = isStereo() ? 2 : 1;
+		uint frames = numSamples / stereoFactor;
+		uint done = readAhead(data, frames);
+		if (done < frames) {
+			// The render-ahead callback fell behind. Check once more while
+			// holding the render lock, since it may just have finished a chunk,
+			// then render the remainder here.
+			Common::StackLock lock(_renderMutex);
+			done += readAhead(data + done * stereoFactor, frames - done);
+			if (done < frames)
+				renderBuffer(data + done * stereoFactor, (frames - done) * stereoFactor);
+		}
+
+		return numSamples;
+	}
+
+	virtual bool endOfData() const {
+		return false;
+	}
+
+protected:
+	/**
+	 * Render samples directly, processing the timer ticks which fall into
+	 * them. This is what readBuffer() does when not rendering ahead.
+	 */
+	int renderBuffer(int16 *data, const int numSamples) {
 		const int stereoFactor = isStereo() ? 2 : 1;
 		int len = numSamples / stereoFactor;
 		int step;
 
+		if (hasEventTimestamps()) {
+			// Run all ticks in this buffer first, stamping the MIDI data with
+			// the tick positions, then render the whole buffer at once. The
+			// playback stream is not stamped, so while it is used, render up
+			// to each tick instead.
+			const uint32 startPos = _samplePos;
+			int pos = 0, tickPos = 0;
+			while ((_nextTick >> FIXP_SHIFT) < len - tickPos) {
+				step = _nextTick >> FIXP_SHIFT;
+				tickPos += step;
+				_nextTick -= step << FIXP_SHIFT;
+
+				if (_playbackStream || _playbackSwitchPending) {
+					produceSamples(data + pos * stereoFactor, tickPos - pos);
+					pos = tickPos;
+				}
+
+				setEventTimestamp(startPos + tickPos);
+				processTick();
+			}
+			_nextTick -= (len - tickPos) << FIXP_SHIFT;
+
+			setEventTimestamp(startPos + len);
+			produceSamples(data + pos * stereoFactor, len - pos);
+			captureSamples(data, startPos, len);
+
+			return numSamples;
+		}
+
+		int16 *start = data;
+		const uint32 startPos = _samplePos;
 		do {
 			step = len;
 			if (step > (_nextTick >> FIXP_SHIFT))
 				step = (_nextTick >> FIXP_SHIFT);
 
-			generateSamples(data, step);
+			produceSamples(data, step);
+			setEventTimestamp(_samplePos);
 
 			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
-
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
+			if (!(_nextTick >> FIXP_SHIFT))
+				processTick();
 
 			data += step * stereoFactor;
 			len -= step;
 		} while (len);
 
-		return numSamples;
-	}
+		captureSamples(start, startPos, numSamples / stereoFactor);
 
-	virtual bool endOfData() const {
-		return false;
+		return numSamples;
 	}
 };
 
@@ -40,6 +40,7 @@
 #include "common/scummsys.h"
 #include "common/config-manager.h"
 #include "common/error.h"
+#include "common/mutex.h"
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -47,6 +48,7 @@
 #include "audio/musicplugin.h"
 #include "audio/mpu401.h"
 #include "audio/softsynth/emumidi.h"
+#include "audio/softsynth/fluidsynth.h"
 #include "gui/message.h"
 #if defined(IPHONE_IOS7)
 #include "backends/platform/ios7/ios7_common.h"
@@ -94,6 +96,31 @@ static void logHandler(int level, char *message, void *data)
 	}
 }
 
+// The synth of the last closed driver, kept with its SoundFont loaded, so
+// that the next driver using the same SoundFont file (e.g. in the next game
+// started) does not need to load it again. Large General MIDI SoundFonts
+// can take seconds to load.
+struct CachedSynth {
+	fluid_settings_t *settings;
+	fluid_synth_t *synth;
+	int soundFont;
+	Common::String soundFontPath;
+	int outputRate;
+};
+
+static CachedSynth *g_cachedSynth = nullptr;
+
+static void releaseCachedSynth() {
+	if (!g_cachedSynth)
+		return;
+
+	fluid_synth_sfunload(g_cachedSynth->synth, g_cachedSynth->soundFont, 1);
+	delete_fluid_synth(g_cachedSynth->synth);
+	delete_fluid_settings(g_cachedSynth->settings);
+	delete g_cachedSynth;
+	g_cachedSynth = nullptr;
+}
+
 class MidiDriver_FluidSynth : public MidiDriver_Emulated {
 private:
 	MidiChannel_MPU401 _midiChannels[16];
@@ -103,6 +130,17 @@ private:
 	int _outputRate;
 	Common::SeekableReadStream *_engineSoundFontData;
 
+	// Path of the SoundFont file, or empty if the engine's SoundFont data is used
+	Common::String _soundFontPath;
+
+	// Load of the synth. It is updated on the thread rendering the audio and
+	// read by the settings dialog, so _statsMutex guards it.
+	FluidSynth::Stats _stats;
+	Common::Mutex _statsMutex;
+
+	void updateStats();
+	static void renderAheadProc(void *refCon);
+
 protected:
 	// Because GCC complains about casting from const to non-const...
 	void setInt(const char *name, int val);
@@ -127,12 +165,25 @@ public:
 	// AudioStream API
 	bool isStereo() const override { return true; }
 	int getRate() const override { return _outputRate; }
+
+	void getStats(FluidSynth::Stats &stats);
 };
 
+// The driver opened last, whose load the settings dialog shows
+static MidiDriver_FluidSynth *g_statsDriver = nullptr;
+
+bool FluidSynth::getStats(Stats &stats) {
+	if (!g_statsDriver)
+		return false;
+
+	g_statsDriver->getStats(stats);
+	return true;
+}
+
 // MidiDriver method implementations
 
 MidiDriver_FluidSynth::MidiDriver_FluidSynth(Audio::Mixer *mixer)
-	: MidiDriver_Emulated(mixer), _engineSoundFontData(nullptr) {
+	: MidiDriver_Emulated(mixer), _settings(nullptr), _synth(nullptr), _soundFont(-1), _engineSoundFontData(nullptr) {
 
 	for (int i = 0; i < ARRAYSIZE(_midiChannels); i++) {
 		_midiChannels[i].init(this, i);
@@ -314,7 +365,32 @@ int MidiDriver_FluidSynth::open() {
 	}
 #endif
 
-	_settings = new_fluid_settings();
+	_soundFontPath.clear();
+	if (!isUsingInMemorySoundFontData) {
+#if defined(IPHONE_IOS7)
+		// HACK: Due to the sandbox on non-jailbroken iOS devices, we need to deal
+		// with the chroot filesystem. All the path selected by the user are
+		// relative to the Document directory. So, we need to adjust the path to
+		// reflect that.
+		_soundFontPath = iOS7_getDocumentsDir() + ConfMan.get("soundfont");
+#else
+		_soundFontPath = ConfMan.get("soundfont");
+#endif
+	}
+
+	// Reuse the synth of the last driver if it has the same SoundFont
+	// loaded. Otherwise, release it before loading another SoundFont.
+	if (g_cachedSynth && !_soundFontPath.empty() && g_cachedSynth->soundFontPath == _soundFontPath &&
+			g_cachedSynth->outputRate == _outputRate) {
+		_settings = g_cachedSynth->settings;
+		_synth = g_cachedSynth->synth;
+		_soundFont = g_cachedSynth->soundFont;
+		delete g_cachedSynth;
+		g_cachedSynth = nullptr;
+	} else {
+		releaseCachedSynth();
+		_soundFont = -1;
+	}
 
 	// The default gain setting is ridiculously low - at least for me. This
 	// cannot be fixed by ScummVM's volume settings because they can only
@@ -323,10 +399,19 @@ int MidiDriver_FluidSynth::open() {
 
 	double gain = (double)ConfMan.getInt("midi_gain") / 100.0;
 
-	setNum("synth.gain", gain);
-	setNum("synth.sample-rate", _outputRate);
+	if (_synth) {
+		// Bring the reused synth back to its power-on state. The effect
+		// settings are applied again below.
+		fluid_synth_system_reset(_synth);
+		fluid_synth_set_gain(_synth, gain);
+	} else {
+		_settings = new_fluid_settings();
+
+		setNum("synth.gain", gain);
+		setNum("synth.sample-rate", _outputRate);
 
-	_synth = new_fluid_synth(_settings);
+		_synth = new_fluid_synth(_settings);
+	}
 
 	if (ConfMan.getBool("fluidsynth_chorus_activate")) {
 #if FS_API_VERSION >= 0x0202
@@ -408,59 +493,69 @@ int MidiDriver_FluidSynth::open() {
 
 	fluid_synth_set_interp_method(_synth, -1, interpMethod);
 
-	Common::String soundfont;
+	if (_soundFont == -1) {
+		Common::String soundfont;
 
 #if defined(FS_HAS_STREAM_SUPPORT)
-	if (isUsingInMemorySoundFontData) {
+		if (isUsingInMemorySoundFontData) {
 #if defined(USE_FLUIDLITE)
-		fluidlite_stream_holder *holder = new fluidlite_stream_holder;
-		holder->stream = _engineSoundFontData;
-		holder->openCounter = 0;
+			fluidlite_stream_holder *holder = new fluidlite_stream_holder;
+			holder->stream = _engineSoundFontData;
+			holder->openCounter = 0;
 
-		fluid_sfloader_t *soundFontMemoryLoader = new_fluid_defsfloader();
-		soundFontMemoryLoader->fileapi = const_cast<fluid_fileapi_t *>(&SoundFontMemLoader_callbacks);
-		fluid_synth_add_sfloader(_synth, soundFontMemoryLoader);
+			fluid_sfloader_t *soundFontMemoryLoader = new_fluid_defsfloader();
+			soundFontMemoryLoader->fileapi = const_cast<fluid_fileapi_t *>(&SoundFontMemLoader_callbacks);
+			fluid_synth_add_sfloader(_synth, soundFontMemoryLoader);
 
-		soundfont = Common::String::format("&%p", (void *)holder);
+			soundfont = Common::String::format("&%p", (void *)holder);
 #else
-		// Fluidsynth 2.0+
-		fluid_sfloader_t *soundFontMemoryLoader = new_fluid_defsfloader(_settings);
-		fluid_sfloader_set_callbacks(soundFontMemoryLoader,
-									 SoundFontMemLoader_open,
-									 SoundFontMemLoader_read,
-									 SoundFontMemLoader_seek,
-									 SoundFontMemLoader_tell,
-									 SoundFontMemLoader_close);
-		fluid_synth_add_sfloader(_synth, soundFontMemoryLoader);
-
-		soundfont = Common::String::format("&%p", (void *)_engineSoundFontData);
+			// Fluidsynth 2.0+
+			fluid_sfloader_t *soundFontMemoryLoader = new_fluid_defsfloader(_settings);
+			fluid_sfloader_set_callbacks(soundFontMemoryLoader,
+										 SoundFontMemLoader_open,
+										 SoundFontMemLoader_read,
+										 SoundFontMemLoader_seek,
+										 SoundFontMemLoader_tell,
+										 SoundFontMemLoader_close);
+			fluid_synth_add_sfloader(_synth, soundFontMemoryLoader);
+
+			soundfont = Common::String::format("&%p", (void *)_engineSoundFontData);
 #endif
-	} else
+		} else
 #endif // FS_HAS_STREAM_SUPPORT
-	{
-#if defined(IPHONE_IOS7)
-		// HACK: Due to the sandbox on non-jailbroken iOS devices, we need to deal
-		// with the chroot filesystem. All the path selected by the user are
-		// relative to the Document directory. So, we need to adjust the path to
-		// reflect that.
-		soundfont = iOS7_getDocumentsDir() + ConfMan.get("soundfont");
-#else
-		soundfont = ConfMan.get("soundfont");
-#endif
-	}
+		{
+			soundfont = _soundFontPath;
+		}
 
-	_soundFont = fluid_synth_sfload(_synth, soundfont.c_str(), 1);
+		_soundFont = fluid_synth_sfload(_synth, soundfont.c_str(), 1);
 
-	if (_soundFont == -1) {
-		GUI::MessageDialog dialog(Common::U32String::format(_("FluidSynth: Failed loading custom SoundFont '%s'. Music is off."), soundfont.c_str()));
-		dialog.runModal();
-		return MERR_DEVICE_NOT_AVAILABLE;
+		if (_soundFont == -1) {
+			delete_fluid_synth(_synth);
+			delete_fluid_settings(_settings);
+			_synth = nullptr;
+			_settings = nullptr;
+
+			GUI::MessageDialog dialog(Common::U32String::format(_("FluidSynth: Failed loading custom SoundFont '%s'. Music is off."), soundfont.c_str()));
+			dialog.runModal();
+			return MERR_DEVICE_NOT_AVAILABLE;
+		}
+	}
+
+	{
+		Common::StackLock lock(_statsMutex);
+		_stats.activeVoices = -1;
+		_stats.peakVoices = -1;
+		_stats.polyphony = fluid_synth_get_polyphony(_synth);
+		_stats.cpuLoad = -1;
 	}
+	g_statsDriver = this;
 
 	MidiDriver_Emulated::open();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
+	startRenderAhead(ConfMan.getInt("fluidsynth_render_ahead"), &renderAheadProc, "FluidSynthRenderAhead");
+
 	return 0;
 }
 
@@ -470,12 +565,32 @@ void MidiDriver_FluidSynth::close() {
 	_isOpen = false;
 
 	_mixer->stopHandle(_mixerSoundHandle);
+	stopRenderAhead();
+
+	if (g_statsDriver == this)
+		g_statsDriver = nullptr;
 
-	if (_soundFont != -1)
-		fluid_synth_sfunload(_synth, _soundFont, 1);
+	if (!_soundFontPath.empty() && ConfMan.getBool("fluidsynth_cache_soundfont")) {
+		// Keep the synth with the SoundFont loaded for the next driver
+		releaseCachedSynth();
 
-	delete_fluid_synth(_synth);
-	delete_fluid_settings(_settings);
+		g_cachedSynth = new CachedSynth();
+		g_cachedSynth->settings = _settings;
+		g_cachedSynth->synth = _synth;
+		g_cachedSynth->soundFont = _soundFont;
+		g_cachedSynth->soundFontPath = _soundFontPath;
+		g_cachedSynth->outputRate = _outputRate;
+	} else {
+		if (_soundFont != -1)
+			fluid_synth_sfunload(_synth, _soundFont, 1);
+
+		delete_fluid_synth(_synth);
+		delete_fluid_settings(_settings);
+	}
+
+	_synth = nullptr;
+	_settings = nullptr;
+	_soundFont = -1;
 }
 
 void MidiDriver_FluidSynth::send(uint32 b) {
@@ -535,6 +650,31 @@ MidiChannel *MidiDriver_FluidSynth::getPercussionChannel() {
 
 void MidiDriver_FluidSynth::generateSamples(int16 *data, int len) {
 	fluid_synth_write_s16(_synth, len, data, 0, 2, data, 1, 2);
+	updateStats();
+}
+
+void MidiDriver_FluidSynth::updateStats() {
+	if (g_statsDriver != this)
+		return;
+
+#if !defined(USE_FLUIDLITE) && FS_API_VERSION >= 0x0200
+	const int activeVoices = fluid_synth_get_active_voice_count(_synth);
+	const int cpuLoad = (int)fluid_synth_get_cpu_load(_synth);
+
+	Common::StackLock lock(_statsMutex);
+	_stats.activeVoices = activeVoices;
+	_stats.peakVoices = MAX(_stats.peakVoices, activeVoices);
+	_stats.cpuLoad = cpuLoad;
+#endif
+}
+
+void MidiDriver_FluidSynth::getStats(FluidSynth::Stats &stats) {
+	Common::StackLock lock(_statsMutex);
+	stats = _stats;
+}
+
+void MidiDriver_FluidSynth::renderAheadProc(void *refCon) {
+	((MidiDriver_FluidSynth *)refCon)->renderAhead();
 }
 
 void MidiDriver_FluidSynth::setEngineSoundFont(Common::SeekableReadStream *soundFontData) {
@@ -553,6 +693,10 @@ bool MidiDriver_FluidSynth::acceptsSoundFontData() {
 
 class FluidSynthMusicPlugin : public MusicPluginObject {
 public:
+	~FluidSynthMusicPlugin() override {
+		releaseCachedSynth();
+	}
+
 	const char *getName() const override {
 		return "FluidSynth";
 	}
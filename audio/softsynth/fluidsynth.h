@@ -0,0 +1,48 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_SOFTSYNTH_FLUIDSYNTH_H
+#define AUDIO_SOFTSYNTH_FLUIDSYNTH_H
+
+#include "common/scummsys.h"
+
+namespace FluidSynth {
+
+/**
+ * Load of the FluidSynth music driver, for display in the settings dialog.
+ */
+struct Stats {
+	int activeVoices;	///< Number of voices playing, or -1 if unknown
+	int peakVoices;		///< Highest number of voices playing since the driver was opened, or -1 if unknown
+	int polyphony;		///< Maximum number of voices
+	int cpuLoad;		///< CPU load of the synthesis in percent, or -1 if unknown
+};
+
+/**
+ * Get the load of the FluidSynth driver which was opened last.
+ *
+ * @return true on success, false if no FluidSynth driver is open
+ */
+bool getStats(Stats &stats);
+
+} // End of namespace FluidSynth
+
+#endif
@@ -129,6 +129,18 @@ void PCMDevice_Base::setSfxChanMask(int mask) {
 }
 
 void PCMDevice_Base::readBuffer(int32 *buffer, uint32 bufferSize) {
+	bool idle = true;
+	for (int ii = 0; ii < 8 && idle; ii++)
+		idle = !_channels[ii]->isPlaying();
+	for (int ii = 0; ii < _numChannels && idle; ii++)
+		idle = !_channels[ii]->isActive();
+
+	// Without playing channels only the timer has to be advanced
+	if (idle) {
+		_timer = (uint32)(((uint64)_timer + (uint64)_extRate * bufferSize) % _intRate);
+		return;
+	}
+
 	for (uint32 i = 0; i < bufferSize; i++) {
 		_timer += _extRate;
 		while (_timer >= _intRate) {
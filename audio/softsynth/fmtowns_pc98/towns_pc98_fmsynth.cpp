@@ -52,6 +52,8 @@ public:
 	void ampModulation(bool enable);
 	void reset();
 
+	bool isReady() const { return _state == kEnvReady; }
+
 protected:
 	void frequency(int freq);
 
@@ -880,6 +882,16 @@ void TownsPC98_FmSynthPercussionSource::nextTick(int32 *buffer, uint32 bufferSiz
 	if (!_ready)
 		return;
 
+	bool active = false;
+	for (int ii = 0; ii < 6; ii++)
+		active |= _rhChan[ii].active;
+
+	// Without playing instruments only the timer has to be advanced
+	if (!active) {
+		_timer = (uint32)(((uint64)_timer + (uint64)_tickLength * bufferSize) % _envDuration);
+		return;
+	}
+
 	for (uint32 i = 0; i < bufferSize; i++) {
 		_timer += _tickLength;
 		while (_timer >= _envDuration) {
@@ -1581,102 +1593,160 @@ void TownsPC98_FmSynth::nextTick(int32 *buffer, uint32 bufferSize) {
 	if (!_ready)
 		return;
 
+	const int32 divisor = (_numChan + _numSSG - 3) / 3;
+	int32 output[kRenderBlockSize];
+
 	for (int i = 0; i < _numChan; i++) {
-		TownsPC98_FmSynthOperator **o = _chanInternal[i].opr;
+		ChanInternal &chan = _chanInternal[i];
+		TownsPC98_FmSynthOperator **o = chan.opr;
 
-		if (_chanInternal[i].updateEnvelopeParameters) {
-			_chanInternal[i].updateEnvelopeParameters = false;
+		if (chan.updateEnvelopeParameters) {
+			chan.updateEnvelopeParameters = false;
 			for (int ii = 0; ii < 4 ; ii++)
 				o[ii]->updatePhaseIncrement();
 		}
 
-		for (uint32 ii = 0; ii < bufferSize ; ii++) {
-			int32 phbuf1, phbuf2, output;
-			phbuf1 = phbuf2 = output = 0;
+		// A channel whose operators have all finished the release phase
+		// produces silence and has no state to advance, apart from the
+		// delay buffer which the algorithms always leave cleared.
+		if (o[0]->isReady() && o[1]->isReady() && o[2]->isReady() && o[3]->isReady()) {
+			chan.feedbuf[2] = 0;
+			continue;
+		}
+
+		const bool volA = ((1 << i) & _volMaskA) != 0;
+		const bool volB = ((1 << i) & _volMaskB) != 0;
 
-			int32 *leftSample = &buffer[ii * 2];
-			int32 *rightSample = &buffer[ii * 2 + 1];
-			int32 *del = &_chanInternal[i].feedbuf[2];
-			int32 *feed = _chanInternal[i].feedbuf;
+		for (uint32 offset = 0; offset < bufferSize; offset += kRenderBlockSize) {
+			const uint32 count = MIN<uint32>(bufferSize - offset, kRenderBlockSize);
 
-			switch (_chanInternal[i].algorithm) {
+			// The operators are evaluated for the whole block first, with
+			// the algorithm selected once instead of for every sample
+			switch (chan.algorithm) {
 			case 0:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, nullptr, phbuf2);
-				*del = 0;
-				o[1]->generateOutput(phbuf1, nullptr, *del);
-				o[3]->generateOutput(phbuf2, nullptr, output);
+				renderChannel<0>(chan, output, count);
 				break;
 			case 1:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, nullptr, phbuf2);
-				o[1]->generateOutput(0, nullptr, phbuf1);
-				o[3]->generateOutput(phbuf2, nullptr, output);
-				*del = phbuf1;
+				renderChannel<1>(chan, output, count);
 				break;
 			case 2:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(*del, nullptr, phbuf2);
-				o[1]->generateOutput(0, nullptr, phbuf1);
-				o[3]->generateOutput(phbuf2, nullptr, output);
-				*del = phbuf1;
+				renderChannel<2>(chan, output, count);
 				break;
 			case 3:
-				o[0]->generateOutput(0, feed, phbuf2);
-				o[2]->generateOutput(0, nullptr, *del);
-				o[1]->generateOutput(phbuf2, nullptr, phbuf1);
-				o[3]->generateOutput(*del, nullptr, output);
-				*del = phbuf1;
+				renderChannel<3>(chan, output, count);
 				break;
 			case 4:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, nullptr, phbuf2);
-				o[1]->generateOutput(phbuf1, nullptr, output);
-				o[3]->generateOutput(phbuf2, nullptr, output);
-				*del = 0;
+				renderChannel<4>(chan, output, count);
 				break;
 			case 5:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(*del, nullptr, output);
-				o[1]->generateOutput(phbuf1, nullptr, output);
-				o[3]->generateOutput(phbuf1, nullptr, output);
-				*del = phbuf1;
+				renderChannel<5>(chan, output, count);
 				break;
 			case 6:
-				o[0]->generateOutput(0, feed, phbuf1);
-				o[2]->generateOutput(0, nullptr, output);
-				o[1]->generateOutput(phbuf1, nullptr, output);
-				o[3]->generateOutput(0, nullptr, output);
-				*del = 0;
+				renderChannel<6>(chan, output, count);
 				break;
 			case 7:
-				o[0]->generateOutput(0, feed, output);
-				o[2]->generateOutput(0, nullptr, output);
-				o[1]->generateOutput(0, nullptr, output);
-				o[3]->generateOutput(0, nullptr, output);
-				*del = 0;
+				renderChannel<7>(chan, output, count);
 				break;
 			default:
+				memset(output, 0, count * sizeof(int32));
 				break;
-			};
+			}
 
-			int32 finOut = (output << 2) / ((_numChan + _numSSG - 3) / 3);
+			int32 *dst = &buffer[offset * 2];
+			for (uint32 ii = 0; ii < count; ii++) {
+				int32 finOut = (output[ii] << 2) / divisor;
 
-			if ((1 << i) & _volMaskA)
-				finOut = (finOut * _volumeA) / Audio::Mixer::kMaxMixerVolume;
+				if (volA)
+					finOut = (finOut * _volumeA) / Audio::Mixer::kMaxMixerVolume;
 
-			if ((1 << i) & _volMaskB)
-				finOut = (finOut * _volumeB) / Audio::Mixer::kMaxMixerVolume;
+				if (volB)
+					finOut = (finOut * _volumeB) / Audio::Mixer::kMaxMixerVolume;
 
-			if (_chanInternal[i].enableLeft)
-				*leftSample += finOut;
+				if (chan.enableLeft)
+					dst[ii * 2] += finOut;
 
-			if (_chanInternal[i].enableRight)
-				*rightSample += finOut;
+				if (chan.enableRight)
+					dst[ii * 2 + 1] += finOut;
+			}
 		}
 	}
 }
 
+template<int algorithm>
+void TownsPC98_FmSynth::renderChannel(ChanInternal &chan, int32 *output, uint32 count) {
+	TownsPC98_FmSynthOperator **o = chan.opr;
+	int32 *del = &chan.feedbuf[2];
+	int32 *feed = chan.feedbuf;
+
+	for (uint32 ii = 0; ii < count; ii++) {
+		int32 phbuf1, phbuf2, out;
+		phbuf1 = phbuf2 = out = 0;
+
+		switch (algorithm) {
+		case 0:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, nullptr, phbuf2);
+			*del = 0;
+			o[1]->generateOutput(phbuf1, nullptr, *del);
+			o[3]->generateOutput(phbuf2, nullptr, out);
+			break;
+		case 1:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, nullptr, phbuf2);
+			o[1]->generateOutput(0, nullptr, phbuf1);
+			o[3]->generateOutput(phbuf2, nullptr, out);
+			*del = phbuf1;
+			break;
+		case 2:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(*del, nullptr, phbuf2);
+			o[1]->generateOutput(0, nullptr, phbuf1);
+			o[3]->generateOutput(phbuf2, nullptr, out);
+			*del = phbuf1;
+			break;
+		case 3:
+			o[0]->generateOutput(0, feed, phbuf2);
+			o[2]->generateOutput(0, nullptr, *del);
+			o[1]->generateOutput(phbuf2, nullptr, phbuf1);
+			o[3]->generateOutput(*del, nullptr, out);
+			*del = phbuf1;
+			break;
+		case 4:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, nullptr, phbuf2);
+			o[1]->generateOutput(phbuf1, nullptr, out);
+			o[3]->generateOutput(phbuf2, nullptr, out);
+			*del = 0;
+			break;
+		case 5:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(*del, nullptr, out);
+			o[1]->generateOutput(phbuf1, nullptr, out);
+			o[3]->generateOutput(phbuf1, nullptr, out);
+			*del = phbuf1;
+			break;
+		case 6:
+			o[0]->generateOutput(0, feed, phbuf1);
+			o[2]->generateOutput(0, nullptr, out);
+			o[1]->generateOutput(phbuf1, nullptr, out);
+			o[3]->generateOutput(0, nullptr, out);
+			*del = 0;
+			break;
+		case 7:
+			o[0]->generateOutput(0, feed, out);
+			o[2]->generateOutput(0, nullptr, out);
+			o[1]->generateOutput(0, nullptr, out);
+			o[3]->generateOutput(0, nullptr, out);
+			*del = 0;
+			break;
+		default:
+			break;
+		}
+
+		output[ii] = out;
+	}
+}
+
 const uint32 TownsPC98_FmSynth::_adtStat[] = {
 	0x00010001, 0x00010001, 0x00010001, 0x01010001,
 	0x00010101, 0x00010101, 0x00010101, 0x01010101,
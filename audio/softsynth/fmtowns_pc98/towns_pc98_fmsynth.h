@@ -150,6 +150,15 @@ private:
 		TownsPC98_FmSynthOperator *opr[4];
 	};
 
+	enum {
+		kRenderBlockSize = 256
+	};
+
+	// Renders the operators of one channel with the given algorithm, before
+	// the volume and panning are applied.
+	template<int algorithm>
+	void renderChannel(ChanInternal &chan, int32 *output, uint32 count);
+
 	TownsPC98_FmSynthSquareWaveSource *_ssg;
 #ifndef DISABLE_PC98_RHYTHM_CHANNEL
 	TownsPC98_FmSynthPercussionSource *_prc;
@@ -188,6 +188,9 @@ void OPL::reset() {
 }
 
 void OPL::write(int port, int val) {
+	if (queueWrite(port, val, false))
+		return;
+
 	if (port&1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -259,6 +262,9 @@ byte OPL::read(int port) {
 }
 
 void OPL::writeReg(int r, int v) {
+	if (queueWrite(r, v, true))
+		return;
+
 	int tempReg = 0;
 	switch (_type) {
 	case Config::kOpl2:
@@ -68,6 +68,9 @@ void OPL::reset() {
 }
 
 void OPL::write(int a, int v) {
+	if (queueWrite(a, v, false))
+		return;
+
 	MAME::OPLWrite(_opl, a, v);
 }
 
@@ -76,6 +79,9 @@ byte OPL::read(int a) {
 }
 
 void OPL::writeReg(int r, int v) {
+	if (queueWrite(r, v, true))
+		return;
+
 	MAME::OPLWriteReg(_opl, r, v);
 }
 
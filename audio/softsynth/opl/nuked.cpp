@@ -379,6 +379,13 @@ static void OPL3_EnvelopeCalc(opl3_slot *slot)
     Bit8u reset = 0;
     slot->eg_out = slot->eg_rout + (slot->reg_tl << 2)
                  + (slot->eg_ksl >> kslshift[slot->reg_ksl]) + *slot->trem;
+    // Fast path for keyed off slots which have fully decayed. The code
+    // below leaves their state unchanged, so this is bit exact.
+    if (!slot->key && slot->eg_gen == envelope_gen_num_release && slot->eg_rout == 0x1ff)
+    {
+        slot->pg_reset = 0;
+        return;
+    }
     if (slot->key && slot->eg_gen == envelope_gen_num_release)
     {
         reset = 1;
@@ -1422,6 +1429,9 @@ void OPL::reset() {
 }
 
 void OPL::write(int port, int val) {
+	if (queueWrite(port, val, false))
+		return;
+
 	if (port & 1) {
 		switch (_type) {
 		case Config::kOpl2:
@@ -1470,6 +1480,9 @@ void OPL::write(int port, int val) {
 
 
 void OPL::writeReg(int r, int v) {
+	if (queueWrite(r, v, true))
+		return;
+
 	OPL3_WriteRegBuffered(&chip, (Bit16u)r, (Bit8u)v);
 }
 
@@ -127,6 +127,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_screenChangeCount(0),
 	_mouseSurface(nullptr), _mouseScaler(nullptr),
 	_mouseOrigSurface(nullptr), _cursorDontScale(false), _cursorPaletteDisabled(true),
+	_cursorCacheNext(0),
 	_currentShakeXOffset(0), _currentShakeYOffset(0),
 	_paletteDirtyStart(0), _paletteDirtyEnd(0),
 	_screenIsLocked(false),
@@ -157,6 +158,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 
 	_mouseLastRect.x = _mouseLastRect.y = _mouseLastRect.w = _mouseLastRect.h = 0;
 	_mouseNextRect.x = _mouseNextRect.y = _mouseNextRect.w = _mouseNextRect.h = 0;
+	_mouseBackupRect.x = _mouseBackupRect.y = _mouseBackupRect.w = _mouseBackupRect.h = 0;
 
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
@@ -668,6 +670,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 
 	// Even if the old and new scale factors are the same, we may have a
 	// different scaler for the cursor now.
+	clearCursorCache();
 	blitCursor();
 }
 
@@ -1058,6 +1061,10 @@ void SurfaceSdlGraphicsManager::unloadGFXMode() {
 		_overlayscreen = nullptr;
 	}
 
+	_mouseBackup.free();
+	_mouseBackupRect.w = _mouseBackupRect.h = 0;
+	clearCursorCache();
+
 #ifdef USE_OSD
 	if (_osdMessageSurface) {
 		SDL_FreeSurface(_osdMessageSurface);
@@ -1095,6 +1102,7 @@ bool SurfaceSdlGraphicsManager::hotswapGFXMode() {
 		SDL_FreeSurface(_hwScreen);
 		_hwScreen = nullptr;
 	}
+	_mouseBackupRect.w = _mouseBackupRect.h = 0;
 	if (_tmpscreen) {
 		SDL_FreeSurface(_tmpscreen);
 		_tmpscreen = nullptr;
@@ -1263,8 +1271,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	// Add the area covered by the mouse cursor to the list of dirty rects if
 	// we have to redraw the mouse, or if the cursor is alpha-blended since
 	// alpha-blended cursors will happily blend into themselves if the surface
-	// under the cursor is not reset first
-	if (_cursorNeedsRedraw || _cursorFormat.aBits() > 1)
+	// under the cursor is not reset first. Without double buffering the
+	// surface under the cursor is put back from _mouseBackup instead.
+	if (_cursorNeedsRedraw || (_isDoubleBuf && _cursorFormat.aBits() > 1))
 		undrawMouse();
 
 #ifdef USE_OSD
@@ -1312,6 +1321,13 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		uint32 bpp, srcPitch, dstPitch;
 		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
 
+		// Put back what was under the cursor, so that it can be drawn again
+		// on top without scaling the game screen under it
+		const SDL_Rect oldMouseRect = _mouseBackupRect;
+		if (!doRedraw)
+			restoreMouseBackground();
+		_mouseBackupRect.w = _mouseBackupRect.h = 0;
+
 		for (r = _dirtyRectList; r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
@@ -1400,6 +1416,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 		drawMouse();
 
+		// Only the areas the cursor left and now covers need to be updated,
+		// the dirty rects already include any change of the game screen
+		if (!_isDoubleBuf && !doRedraw && _cursorNeedsRedraw) {
+			if (oldMouseRect.w != 0 && oldMouseRect.h != 0)
+				_dirtyRectList[actualDirtyRects++] = oldMouseRect;
+			if (_mouseBackupRect.w != 0 && _mouseBackupRect.h != 0)
+				_dirtyRectList[actualDirtyRects++] = _mouseBackupRect;
+		}
+
 #ifdef USE_OSD
 		drawOSD();
 #endif
@@ -1996,6 +2021,49 @@ void SurfaceSdlGraphicsManager::copyRectToOverlay(const void *buf, int pitch, in
 #pragma mark -
 
 void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) {
+	// Games often set the same cursor again, e.g. every frame or whenever the
+	// mouse moves over a hotspot, so skip converting and scaling it then
+	if (isSameCursor(buf, w, h, hotspotX, hotspotY, keyColor, dontScale, format, mask))
+		return;
+
+	const uint bpp = format ? format->bytesPerPixel : 1;
+	_lastCursorArgs.data.resize(w * h * bpp);
+	if (w && h)
+		memcpy(&_lastCursorArgs.data[0], buf, w * h * bpp);
+	_lastCursorArgs.mask.resize(mask ? w * h : 0);
+	if (mask && w && h)
+		memcpy(&_lastCursorArgs.mask[0], mask, w * h);
+	_lastCursorArgs.w = w;
+	_lastCursorArgs.h = h;
+	_lastCursorArgs.hotspotX = hotspotX;
+	_lastCursorArgs.hotspotY = hotspotY;
+	_lastCursorArgs.keyColor = keyColor;
+	_lastCursorArgs.dontScale = dontScale;
+	_lastCursorArgs.format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+
+	setMouseCursorIntern(buf, w, h, hotspotX, hotspotY, keyColor, dontScale, format, mask);
+}
+
+bool SurfaceSdlGraphicsManager::isSameCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) const {
+	const CursorArgs &last = _lastCursorArgs;
+	const Graphics::PixelFormat cursorFormat = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+
+	if (last.w != w || last.h != h || last.hotspotX != hotspotX || last.hotspotY != hotspotY ||
+	    last.keyColor != keyColor || last.dontScale != dontScale || last.format != cursorFormat)
+		return false;
+
+	if (!w || !h)
+		return true;
+
+	if (last.mask.empty() != !mask)
+		return false;
+	if (mask && memcmp(&last.mask[0], mask, w * h) != 0)
+		return false;
+
+	return memcmp(&last.data[0], buf, w * h * cursorFormat.bytesPerPixel) == 0;
+}
+
+void SurfaceSdlGraphicsManager::setMouseCursorIntern(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keyColor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) {
 
 	if (mask && (!format || format->bytesPerPixel == 1)) {
 		// 8-bit masked cursor, SurfaceSdl has no alpha mask support so we must convert this to color key
@@ -2035,7 +2103,7 @@ void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h,
 				maskedImage[i] = static_cast<byte>(bestKey);
 		}
 
-		setMouseCursor(&maskedImage[0], w, h, hotspotX, hotspotY, bestKey, dontScale, format, nullptr);
+		setMouseCursorIntern(&maskedImage[0], w, h, hotspotX, hotspotY, bestKey, dontScale, format, nullptr);
 		return;
 	}
 
@@ -2086,7 +2154,7 @@ void SurfaceSdlGraphicsManager::setMouseCursor(const void *buf, uint w, uint h,
 			memcpy(&maskedImage[i * outBPP], outColorPtr, outBPP);
 		}
 
-		setMouseCursor(&maskedImage[0], w, h, hotspotX, hotspotY, 0, dontScale, &formatWithAlpha, nullptr);
+		setMouseCursorIntern(&maskedImage[0], w, h, hotspotX, hotspotY, 0, dontScale, &formatWithAlpha, nullptr);
 		return;
 	}
 #endif
@@ -2283,31 +2351,57 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 	SDL_LockSurface(_mouseOrigSurface);
 	SDL_LockSurface(_mouseSurface);
 
+	const byte *origPixels = (const byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * _mouseOrigSurface->format->BytesPerPixel;
+	const uint origPitch = _mouseOrigSurface->pitch;
+
+	bool useScaler = false;
+#ifdef USE_SCALERS
+	// HACK: AdvMame4x requires a height of at least 4 pixels, so we
+	// fall back on the Normal scaler when a smaller cursor is supplied.
+	useScaler = !_cursorDontScale && _mouseScaler && _scalerPlugin->canDrawCursor() && (uint)_mouseCurState.h >= _extraPixels;
+#endif
+
+	uint32 hash = 2166136261U;
+	for (int y = 0; y < h; y++) {
+		const byte *line = origPixels + y * origPitch;
+		for (int x = 0; x < w * _cursorFormat.bytesPerPixel; x++) {
+			hash ^= line[x];
+			hash *= 16777619;
+		}
+	}
+
+	const int cached = findCachedCursor(origPixels, origPitch, hash, cursorScale, useScaler);
+	if (cached >= 0) {
+		const Graphics::Surface &scaled = _cursorCache[cached].scaled;
+		Graphics::copyBlit((byte *)_mouseSurface->pixels, (const byte *)scaled.getPixels(),
+		                   _mouseSurface->pitch, scaled.pitch, rW, rH, _mouseSurface->format->BytesPerPixel);
+
+		SDL_UnlockSurface(_mouseSurface);
+		SDL_UnlockSurface(_mouseOrigSurface);
+		return;
+	}
+
 	// If possible, use the same scaler for the cursor as for the rest of
 	// the game. This only works well with the non-blurring scalers so we
 	// otherwise use the Normal scaler
 	if (!_cursorDontScale) {
 #ifdef USE_SCALERS
-		// HACK: AdvMame4x requires a height of at least 4 pixels, so we
-		// fall back on the Normal scaler when a smaller cursor is supplied.
-		if (_mouseScaler && _scalerPlugin->canDrawCursor() && (uint)_mouseCurState.h >= _extraPixels) {
+		if (useScaler) {
 			_mouseScaler->setFactor(_videoMode.scaleFactor);
-			_mouseScaler->scale(
-					(byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * _mouseOrigSurface->format->BytesPerPixel,
-					_mouseOrigSurface->pitch, (byte *)_mouseSurface->pixels, _mouseSurface->pitch,
+			_mouseScaler->scale(origPixels, origPitch, (byte *)_mouseSurface->pixels, _mouseSurface->pitch,
 					_mouseCurState.w, _mouseCurState.h, 0, 0);
 		} else
 #endif
 		{
-			Graphics::scaleBlit((byte *)_mouseSurface->pixels, (const byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * _mouseOrigSurface->format->BytesPerPixel,
+			Graphics::scaleBlit((byte *)_mouseSurface->pixels, origPixels,
 			                    _mouseSurface->pitch, _mouseOrigSurface->pitch,
 				                _mouseCurState.w * _videoMode.scaleFactor, _mouseCurState.h * _videoMode.scaleFactor,
 			                    _mouseCurState.w, _mouseCurState.h, convertSDLPixelFormat(_mouseSurface->format));
 
 		}
 	} else {
-		Graphics::copyBlit((byte *)_mouseSurface->pixels, (const byte *)_mouseOrigSurface->pixels + _mouseOrigSurface->pitch * _maxExtraPixels + _maxExtraPixels * _mouseOrigSurface->format->BytesPerPixel,
-		                   _mouseSurface->pitch, _mouseOrigSurface->pitch,
+		Graphics::copyBlit((byte *)_mouseSurface->pixels, origPixels,
+		                   _mouseSurface->pitch, origPitch,
 		                   _mouseCurState.w, _mouseCurState.h, _mouseSurface->format->BytesPerPixel);
 	}
 
@@ -2316,10 +2410,60 @@ void SurfaceSdlGraphicsManager::blitCursor() {
 		stretch200To240Nearest((uint8 *)_mouseSurface->pixels, _mouseSurface->pitch, rW, rH1, 0, 0, 0, convertSDLPixelFormat(_mouseSurface->format));
 #endif
 
+	cacheCursor(origPixels, origPitch, hash, cursorScale, useScaler);
+
 	SDL_UnlockSurface(_mouseSurface);
 	SDL_UnlockSurface(_mouseOrigSurface);
 }
 
+int SurfaceSdlGraphicsManager::findCachedCursor(const byte *pixels, uint pitch, uint32 hash, int cursorScale, bool useScaler) const {
+	for (int i = 0; i < kCursorCacheSize; i++) {
+		const CachedCursor &entry = _cursorCache[i];
+		if (!entry.scaled.getPixels() || entry.hash != hash || entry.keyColor != _mouseKeyColor ||
+		    entry.scaleFactor != cursorScale || entry.useScaler != useScaler ||
+		    entry.aspectRatioCorrection != (!_cursorDontScale && _videoMode.aspectRatioCorrection) ||
+		    entry.orig.w != _mouseCurState.w || entry.orig.h != _mouseCurState.h ||
+		    entry.orig.format != _cursorFormat || entry.scaled.w != _mouseCurState.rW || entry.scaled.h != _mouseCurState.rH)
+			continue;
+
+		// Compare the images too, since different cursors may have the same hash
+		bool same = true;
+		for (int y = 0; y < entry.orig.h && same; y++)
+			same = memcmp(entry.orig.getBasePtr(0, y), pixels + y * pitch, entry.orig.w * entry.orig.format.bytesPerPixel) == 0;
+		if (same)
+			return i;
+	}
+
+	return -1;
+}
+
+void SurfaceSdlGraphicsManager::cacheCursor(const byte *pixels, uint pitch, uint32 hash, int cursorScale, bool useScaler) {
+	CachedCursor &entry = _cursorCache[_cursorCacheNext];
+	_cursorCacheNext = (_cursorCacheNext + 1) % kCursorCacheSize;
+
+	entry.hash = hash;
+	entry.keyColor = _mouseKeyColor;
+	entry.scaleFactor = cursorScale;
+	entry.aspectRatioCorrection = !_cursorDontScale && _videoMode.aspectRatioCorrection;
+	entry.useScaler = useScaler;
+
+	entry.orig.create(_mouseCurState.w, _mouseCurState.h, _cursorFormat);
+	Graphics::copyBlit((byte *)entry.orig.getPixels(), pixels, entry.orig.pitch, pitch,
+	                   entry.orig.w, entry.orig.h, entry.orig.format.bytesPerPixel);
+
+	entry.scaled.create(_mouseCurState.rW, _mouseCurState.rH, convertSDLPixelFormat(_mouseSurface->format));
+	Graphics::copyBlit((byte *)entry.scaled.getPixels(), (const byte *)_mouseSurface->pixels, entry.scaled.pitch, _mouseSurface->pitch,
+	                   entry.scaled.w, entry.scaled.h, entry.scaled.format.bytesPerPixel);
+}
+
+void SurfaceSdlGraphicsManager::clearCursorCache() {
+	for (int i = 0; i < kCursorCacheSize; i++) {
+		_cursorCache[i].orig.free();
+		_cursorCache[i].scaled.free();
+	}
+	_cursorCacheNext = 0;
+}
+
 void SurfaceSdlGraphicsManager::undrawMouse() {
 	_mouseLastRect = _mouseNextRect;
 
@@ -2354,6 +2498,12 @@ void SurfaceSdlGraphicsManager::undrawMouse() {
 	//
 	// The mouse is undrawn using virtual coordinates, i.e. they may be
 	// scaled and aspect-ratio corrected.
+	//
+	// Without double buffering this is not needed, since the surface under
+	// the cursor is put back from _mouseBackup.
+
+	if (!_isDoubleBuf)
+		return;
 
 	if (_mouseLastRect.w != 0 && _mouseLastRect.h != 0)
 		addDirtyRect(_mouseLastRect.x, _mouseLastRect.y, _mouseLastRect.w, _mouseLastRect.h, _overlayInGUI);
@@ -2390,10 +2540,65 @@ void SurfaceSdlGraphicsManager::drawMouse() {
 	// Note that SDL_BlitSurface() and addDirtyRect() will both perform any
 	// clipping necessary
 
+	if (!_isDoubleBuf)
+		saveMouseBackground(dst);
+
 	if (SDL_BlitSurface(_mouseSurface, nullptr, _hwScreen, &dst) != 0)
 		error("SDL_BlitSurface failed: %s", SDL_GetError());
 }
 
+void SurfaceSdlGraphicsManager::saveMouseBackground(const SDL_Rect &dst) {
+	int x = dst.x;
+	int y = dst.y;
+	int w = dst.w;
+	int h = dst.h;
+
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	w = MIN<int>(w, _hwScreen->w - x);
+	h = MIN<int>(h, _hwScreen->h - y);
+
+	if (w <= 0 || h <= 0)
+		return;
+
+	const uint bpp = _hwScreen->format->BytesPerPixel;
+	if (_mouseBackup.w < w || _mouseBackup.h < h || _mouseBackup.format.bytesPerPixel != bpp) {
+		_mouseBackup.create(MAX<int>(w, _mouseBackup.w), MAX<int>(h, _mouseBackup.h),
+		                    convertSDLPixelFormat(_hwScreen->format));
+	}
+
+	SDL_LockSurface(_hwScreen);
+	Graphics::copyBlit((byte *)_mouseBackup.getPixels(), (const byte *)_hwScreen->pixels + y * _hwScreen->pitch + x * bpp,
+	                   _mouseBackup.pitch, _hwScreen->pitch, w, h, bpp);
+	SDL_UnlockSurface(_hwScreen);
+
+	_mouseBackupRect.x = x;
+	_mouseBackupRect.y = y;
+	_mouseBackupRect.w = w;
+	_mouseBackupRect.h = h;
+}
+
+void SurfaceSdlGraphicsManager::restoreMouseBackground() {
+	if (_mouseBackupRect.w == 0 || _mouseBackupRect.h == 0)
+		return;
+
+	const uint bpp = _hwScreen->format->BytesPerPixel;
+
+	SDL_LockSurface(_hwScreen);
+	Graphics::copyBlit((byte *)_hwScreen->pixels + _mouseBackupRect.y * _hwScreen->pitch + _mouseBackupRect.x * bpp,
+	                   (const byte *)_mouseBackup.getPixels(), _hwScreen->pitch, _mouseBackup.pitch,
+	                   _mouseBackupRect.w, _mouseBackupRect.h, bpp);
+	SDL_UnlockSurface(_hwScreen);
+
+	_mouseBackupRect.w = _mouseBackupRect.h = 0;
+}
+
 #pragma mark -
 #pragma mark --- On Screen Display ---
 #pragma mark -
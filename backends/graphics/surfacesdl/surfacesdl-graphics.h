@@ -27,6 +27,8 @@
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
+#include "graphics/surface.h"
+#include "common/array.h"
 #include "common/events.h"
 #include "common/mutex.h"
 
@@ -387,6 +389,51 @@ protected:
 	SDL_Surface *_mouseOrigSurface;
 	SDL_Surface *_mouseSurface;
 
+	// The arguments of the last call to setMouseCursor, so that setting the
+	// same cursor again does not convert and scale it again.
+	struct CursorArgs {
+		Common::Array<byte> data;
+		Common::Array<byte> mask;
+		uint w, h;
+		int hotspotX, hotspotY;
+		uint32 keyColor;
+		bool dontScale;
+		Graphics::PixelFormat format;
+
+		CursorArgs() : w(0), h(0), hotspotX(0), hotspotY(0), keyColor(0), dontScale(false) { }
+	};
+
+	CursorArgs _lastCursorArgs;
+
+	// Recently used cursors, already scaled for the current video mode, so
+	// that animated cursors and games switching between a few cursors do
+	// not scale each frame again. The cursor palette is applied when the
+	// cursor is drawn, so it is not part of the key.
+	struct CachedCursor {
+		uint32 hash;
+		Graphics::Surface orig;
+		Graphics::Surface scaled;
+		uint32 keyColor;
+		int scaleFactor;
+		bool aspectRatioCorrection;
+		bool useScaler;
+
+		CachedCursor() : hash(0), keyColor(0), scaleFactor(0), aspectRatioCorrection(false), useScaler(false) { }
+	};
+
+	enum {
+		kCursorCacheSize = 8
+	};
+
+	CachedCursor _cursorCache[kCursorCacheSize];
+	uint _cursorCacheNext;
+
+	// The part of _hwScreen covered by the cursor, saved when drawing it so
+	// that it can be put back without scaling the game screen again. This
+	// is not used with double buffering.
+	Graphics::Surface _mouseBackup;
+	SDL_Rect _mouseBackupRect;
+
 	// Shake mode
 	// This is always set to 0 when building with SDL2.
 	int _currentShakeXOffset;
@@ -420,6 +467,14 @@ protected:
 	virtual void undrawMouse();
 	virtual void blitCursor();
 
+	void setMouseCursorIntern(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask);
+	bool isSameCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format, const byte *mask) const;
+	int findCachedCursor(const byte *pixels, uint pitch, uint32 hash, int cursorScale, bool useScaler) const;
+	void cacheCursor(const byte *pixels, uint pitch, uint32 hash, int cursorScale, bool useScaler);
+	void clearCursorCache();
+	void saveMouseBackground(const SDL_Rect &dst);
+	void restoreMouseBackground();
+
 	virtual void internUpdateScreen();
 	virtual void updateScreen(SDL_Rect *dirtyRectList, int actualDirtyRects);
 
@@ -305,7 +305,6 @@ MixerManager *ModularMixerBackend::getMixerManager() {
 }
 
 Audio::Mixer *ModularMixerBackend::getMixer() {
-	assert(_mixerManager);
 	return getMixerManager()->getMixer();
 }
 
@@ -49,13 +49,13 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#include "backends/mixer/null/null-mixer.h"
 #include "base/main.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
-#include "backends/mixer/null/null-mixer.h"
 #include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
 #endif
@@ -95,6 +95,11 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	virtual MixerManager *getMixerManager();
+	virtual bool hasFeature(Feature f);
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -239,6 +244,25 @@ void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
 	fflush(output);
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+MixerManager *OSystem_NULL::getMixerManager() {
+	// The tests never initialize the backend, so the mixer is only created
+	// once it is actually used (e.g. by the audio benchmarks).
+	if (!_mixerManager) {
+		_mixerManager = new NullMixerManager();
+		_mixerManager->init();
+	}
+
+	return _mixerManager;
+}
+
+bool OSystem_NULL::hasFeature(Feature f) {
+	// There is no graphics manager either, so answer like the null graphics
+	// manager would (e.g. for the GUI renderer benchmarks).
+	return false;
+}
+#endif
+
 void OSystem_NULL::addSysArchivesToSearchSet(Common::SearchSet &s, int priority) {
 	s.add("test/engine-data", new Common::FSDirectory("test/engine-data", 4), priority);
 	s.add("gui/themes", new Common::FSDirectory("gui/themes", 4), priority);
@@ -168,6 +168,8 @@ static const char HELP_STRING4[] =
 	"  --native-mt32            True Roland MT-32 (disable GM emulation)\n"
 	"  --dump-midi              Dumps MIDI events to 'dump.mid', until quitting from game\n"
 	"                           (if file already exists, it will be overwritten)\n"
+	"  --dump-opl               Dumps OPL register writes to 'dump.dro', until quitting\n"
+	"                           from game (if file already exists, it will be overwritten)\n"
 	"  --enable-gs              Enable Roland GS mode for MIDI playback\n"
 	"  --output-channels=CHANNELS Select output channel count (e.g. 2 for stereo)\n"
 	"  --output-rate=RATE       Select output sample rate in Hz (e.g. 22050)\n"
@@ -316,8 +318,11 @@ void registerDefaults() {
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("dump_midi", false);
+	ConfMan.registerDefault("dump_opl", false);
 	ConfMan.registerDefault("enable_gs", false);
 	ConfMan.registerDefault("midi_gain", 100);
+	ConfMan.registerDefault("mt32_render_ahead", 0);
+	ConfMan.registerDefault("midi_render_cache_path", "");
 
 	ConfMan.registerDefault("music_driver", "auto");
 	ConfMan.registerDefault("mt32_device", "null");
@@ -401,6 +406,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("fluidsynth_reverb_level", 90);
 
 	ConfMan.registerDefault("fluidsynth_misc_interpolation", "4th");
+
+	ConfMan.registerDefault("fluidsynth_render_ahead", 0);
+	ConfMan.registerDefault("fluidsynth_cache_soundfont", true);
 #endif
 #ifdef USE_DISCORD
 	ConfMan.registerDefault("discord_rpc", true);
@@ -831,6 +839,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("dump-midi")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("dump-opl")
+			END_OPTION
+
 			DO_LONG_OPTION_BOOL("enable-gs")
 			END_OPTION
 
@@ -539,6 +539,11 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 		ConfMan.registerDefault("dump_midi", true);
 	}
 
+	if (settings.contains("dump-opl")) {
+		// Store this command line setting in ConfMan, since all transient settings are destroyed
+		ConfMan.registerDefault("dump_opl", true);
+	}
+
 #ifdef USE_OPENGL
 	if (settings.contains("last_window_width")) {
 		ConfMan.setInt("last_window_width", atoi(settings["last_window_width"].c_str()));
@@ -64,6 +64,10 @@ void MusicPlayer::sendToChannel(byte channel, uint32 b) {
 }
 
 void MusicPlayer::playSMF(int track, bool loop) {
+	// Store the last recorded track while the music changes anyway. This
+	// must not be done with the lock held.
+	storeRenderCache();
+
 	Common::StackLock lock(_mutex);
 
 	if (_isPlaying && track == _track) {
@@ -104,6 +108,8 @@ void MusicPlayer::playSMF(int track, bool loop) {
 		_isPlaying = true;
 		_track = track;
 		debugC(2, kDraciSoundDebugLevel, "Playing track %d", track);
+
+		useRenderCache(_midiData, midiMusicSize, 0);
 	} else {
 		debugC(2, kDraciSoundDebugLevel, "Cannot play track %d", track);
 		delete parser;
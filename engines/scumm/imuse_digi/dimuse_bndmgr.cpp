@@ -288,6 +288,12 @@ int32 BundleMgr::seekFile(int32 offset, int mode) {
 }
 
 int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool header_outside) {
+	*comp_final = (byte *)malloc(size);
+	assert(*comp_final);
+	return readFile(name, size, *comp_final, header_outside);
+}
+
+int32 BundleMgr::readFile(const char *name, int32 size, byte *dest, bool header_outside) {
 	int32 final_size = 0;
 
 	if (!_file->isOpen()) {
@@ -327,9 +333,7 @@ int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool
 
 		if (_isUncompressed) {
 			_file->seek(_bundleTable[found->index].offset + _curDecompressedFilePos + headerSize, SEEK_SET);
-			*comp_final = (byte *)malloc(size);
-			assert(*comp_final);
-			_file->read(*comp_final, size);
+			_file->read(dest, size);
 			_curDecompressedFilePos += size;
 			return size;
 		}
@@ -341,9 +345,7 @@ int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool
 		if ((lastBlock >= _numCompItems) && (_numCompItems > 0))
 			lastBlock = _numCompItems - 1;
 
-		int32 blocksFinalSize = DIMUSE_BUN_CHUNK_SIZE * (1 + lastBlock - firstBlock);
-		*comp_final = (byte *)malloc(blocksFinalSize);
-		assert(*comp_final);
+		const int32 destSize = size;
 		finalSize = 0;
 
 		skip = (_curDecompressedFilePos + headerSize) % DIMUSE_BUN_CHUNK_SIZE; // Excess length after the last block
@@ -377,9 +379,9 @@ int32 BundleMgr::readFile(const char *name, int32 size, byte **comp_final, bool
 			if (outputSize > size)
 				outputSize = size;
 
-			assert(finalSize + outputSize <= blocksFinalSize);
+			assert(finalSize + outputSize <= destSize);
 
-			memcpy(*comp_final + finalSize, _compOutputBuff + skip, outputSize);
+			memcpy(dest + finalSize, _compOutputBuff + skip, outputSize);
 			finalSize += outputSize;
 
 			size -= outputSize;
@@ -104,6 +104,8 @@ public:
 	Common::SeekableReadStream *getFile(const char *filename, int32 &offset, int32 &size);
 	int32 seekFile(int32 offset, int size);
 	int32 readFile(const char *name, int32 size, byte **compFinal, bool headerOutside);
+	// Same as above, but decompresses straight into a buffer of at least 'size' bytes
+	int32 readFile(const char *name, int32 size, byte *dest, bool headerOutside);
 	bool isExtCompBun(byte gameId);
 };
 
@@ -234,13 +234,11 @@ int IMuseDigiFilesHandler::read(int soundId, uint8 *buf, int32 size, int bufId)
 						memcpy(buf, tmpBuf, resultingSize); // We don't free tmpBuf: it's the resource pointer
 						return resultingSize;
 					} else { // DIG & COMI
-						resultingSize = curSnd->bundle->readFile(fileName, size, &tmpBuf, ((_vm->_game.id == GID_CMI) && !(_vm->_game.features & GF_DEMO)));
+						resultingSize = curSnd->bundle->readFile(fileName, size, buf, ((_vm->_game.id == GID_CMI) && !(_vm->_game.features & GF_DEMO)));
 
 						if (resultingSize != size)
 							debug(5, "IMuseDigiFilesHandler::read(): WARNING: tried to read %d bytes, got %d instead (soundId %d (%s))", size, resultingSize, soundId, fileName);
 
-						memcpy(buf, tmpBuf, resultingSize);
-						free(tmpBuf);
 						return resultingSize;
 					}
 				}
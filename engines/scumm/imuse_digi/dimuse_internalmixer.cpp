@@ -221,6 +221,11 @@ void IMuseDigiInternalMixer::mix(uint8 *srcBuf, int32 inFrameCount, int wordSize
 					// Linear volume quantization from the lookup table
 					rightChannelVolume = _stereoVolumeTable[17 * channelVolume + channelPan];
 					leftChannelVolume = _stereoVolumeTable[17 * channelVolume - channelPan];
+
+					// Both amplitude tables would be all zeros
+					if (!leftChannelVolume && !rightChannelVolume)
+						return;
+
 					if (wordSize == 8) {
 						mixBits8ConvertToStereo(
 							srcBuf,
@@ -254,6 +259,10 @@ void IMuseDigiInternalMixer::mix(uint8 *srcBuf, int32 inFrameCount, int wordSize
 					if (channelVolume >= 17)
 						channelVolume = 16;
 
+					// The amplitude table would be all zeros
+					if (!channelVolume)
+						return;
+
 					if (wordSize == 8)
 						ampTable = &_amp8Table[channelVolume * 128];
 					else
@@ -539,11 +548,10 @@ void IMuseDigiInternalMixer::mixBits16Mono(uint8 *srcBuf, int32 inFrameCount, in
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
-		if (feedSize) {
-			srcBuf_ptr = (uint16 *)srcBuf;
-			for (int i = 0; i < feedSize; i++) {
-				mixBufCurCell[i] += *(uint16 *)((uint8 *)ampTable + (((int16)srcBuf_ptr[i] & (int16)0xFFF7) >> 3) + 4096);
-			}
+		const int32 multiplier = getAmp12Multiplier(ampTable);
+		const int16 *src = (const int16 *)srcBuf;
+		for (int i = 0; i < feedSize; i++) {
+			mixBufCurCell[i] += amp16(src[i], multiplier);
 		}
 	} else if (2 * inFrameCount == feedSize) {
 		srcBuf_ptr = (uint16 *)srcBuf;
@@ -1040,13 +1048,12 @@ void IMuseDigiInternalMixer::mixBits16ConvertToStereo(uint8 *srcBuf, int32 inFra
 	mixBufCurCell = (uint16 *)(&_mixBuf[2 * mixBufStartIndex]);
 
 	if (feedSize == inFrameCount) {
-		if (feedSize) {
-			srcBuf_tmp = (uint16 *)srcBuf;
-			for (int i = 0; i < feedSize; i++) {
-				mixBufCurCell[0] += *(uint16 *)((uint8 *)leftAmpTable  + (((int16)srcBuf_tmp[i] & (int16)0xFFF7) >> 3) + 4096);
-				mixBufCurCell[1] += *(uint16 *)((uint8 *)rightAmpTable + (((int16)srcBuf_tmp[i] & (int16)0xFFF7) >> 3) + 4096);
-				mixBufCurCell += 2;
-			}
+		const int32 leftMultiplier = getAmp12Multiplier(leftAmpTable);
+		const int32 rightMultiplier = getAmp12Multiplier(rightAmpTable);
+		const int16 *src = (const int16 *)srcBuf;
+		for (int i = 0; i < feedSize; i++) {
+			mixBufCurCell[i * 2] += amp16(src[i], leftMultiplier);
+			mixBufCurCell[i * 2 + 1] += amp16(src[i], rightMultiplier);
 		}
 	} else if (2 * inFrameCount == feedSize) {
 		srcBuf_tmp = (uint16 *)srcBuf;
@@ -1305,15 +1312,10 @@ void IMuseDigiInternalMixer::mixBits16Stereo(uint8 *srcBuf, int32 inFrameCount,
 
 	mixBufCurCell = (uint16 *)(&_mixBuf[4 * mixBufStartIndex]);
 	if (feedSize == inFrameCount) {
-		if (feedSize) {
-			srcBuf_ptr = (uint16 *)srcBuf;
-
-			for (int i = 0; i < feedSize; i++) {
-				mixBufCurCell[0] += *(uint16 *)((int8 *)ampTable + (((int16)srcBuf_ptr[0] & (int16)0xFFF7) >> 3) + 4096);
-				mixBufCurCell[1] += *(uint16 *)((int8 *)ampTable + (((int16)srcBuf_ptr[1] & (int16)0xFFF7) >> 3) + 4096);
-				srcBuf_ptr += 2;
-				mixBufCurCell += 2;
-			}
+		const int32 multiplier = getAmp12Multiplier(ampTable);
+		const int16 *src = (const int16 *)srcBuf;
+		for (int i = 0; i < feedSize * 2; i++) {
+			mixBufCurCell[i] += amp16(src[i], multiplier);
 		}
 	} else if (2 * inFrameCount == feedSize) {
 		srcBuf_ptr = (uint16 *)srcBuf;
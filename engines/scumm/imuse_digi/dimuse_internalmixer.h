@@ -40,9 +40,12 @@ class Mixer;
 class QueuingAudioStream;
 }
 
+class DiMUSEInternalMixerTestSuite;
+
 namespace Scumm {
 
 class IMuseDigiInternalMixer {
+	friend class ::DiMUSEInternalMixerTestSuite;
 
 private:
 	int32 *_amp8Table;
@@ -63,6 +66,18 @@ private:
 	bool _isEarlyDiMUSE;
 	bool _lowLatencyMode;
 
+	// The 12-bit amplitude tables hold ((sample >> 4) * multiplier) / 127, with
+	// the multiplier depending on the volume. Computing this instead of looking
+	// it up allows the compiler to vectorize the loops over whole buffers.
+	int32 getAmp12Multiplier(const int32 *ampTable) const {
+		const int volume = (ampTable - _amp12Table) / 2048;
+		return volume ? volume * 8 - 1 : 0;
+	}
+
+	static inline uint16 amp16(int16 sample, int32 multiplier) {
+		return (uint16)(((sample >> 4) * multiplier) / 127);
+	}
+
 	void mixBits8Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable, bool ftIs11025Hz);
 	void mixBits12Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable);
 	void mixBits16Mono(uint8 *srcBuf, int32 inFrameCount, int feedSize, int32 mixBufStartIndex, int32 *ampTable);
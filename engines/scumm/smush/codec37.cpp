@@ -261,11 +261,8 @@ void SmushDeltaBlocksDecoder::makeTable(int pitch, int index) {
 #define DECLARE_LITERAL_TEMP(v) \
 	uint32 v
 
-#define READ_LITERAL_PIXEL(src, v)             \
-	do {                                       \
-		v = *src++;                            \
-		v += (v << 8) + (v << 16) + (v << 24); \
-	} while (0)
+#define READ_LITERAL_PIXEL(src, v) \
+	v = *src++ * 0x01010101U
 
 #define WRITE_4X1_LINE(dst, v) \
 	*(uint32 *)(dst) = v
@@ -324,6 +321,29 @@ void SmushDeltaBlocksDecoder::makeTable(int pitch, int index) {
 		dst += 4;                                             \
 	} while (0)
 
+/**
+ * Copy a run of 'length' unchanged 4x4 blocks from the previous frame.
+ * Instead of copying block by block, the part of the run in each row of
+ * blocks is copied with one memcpy per pixel line. Updates the block
+ * position the same way the per-block loop does.
+ */
+void SmushDeltaBlocksDecoder::copyBlockRun(byte *&dst, int32 nextOffs, int32 length, int32 &i, int bw, int &bh, int pitch) {
+	while (length > 0) {
+		int32 count = MIN(length, i);
+		for (int y = 0; y < 4; y++)
+			memcpy(dst + pitch * y, dst + nextOffs + pitch * y, count * 4);
+
+		dst += count * 4;
+		i -= count;
+		length -= count;
+		if (i == 0) {
+			dst += pitch * 3;
+			bh--;
+			i = bw;
+		}
+	}
+}
+
 void SmushDeltaBlocksDecoder::proc1(byte *dst, const byte *src, int32 nextOffs, int bw, int bh, int pitch, int16 *offsetTable) {
 	uint8 code;
 	bool filling, skipCode;
@@ -438,16 +458,7 @@ void SmushDeltaBlocksDecoder::proc4WithFDFE(byte *dst, const byte *src, int32 ne
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				copyBlockRun(dst, nextOffs, length, i, bw, bh, pitch);
 				if (bh == 0) {
 					return;
 				}
@@ -470,16 +481,7 @@ void SmushDeltaBlocksDecoder::proc4WithoutFDFE(byte *dst, const byte *src, int32
 				LITERAL_1X1(src, dst, pitch);
 			} else if (code == 0x00) {
 				int32 length = *src++ + 1;
-				for (int32 l = 0; l < length; l++) {
-					byte *dst2 = dst + nextOffs;
-					COPY_4X4(dst2, dst, pitch);
-					i--;
-					if (i == 0) {
-						dst += pitch * 3;
-						bh--;
-						i = bw;
-					}
-				}
+				copyBlockRun(dst, nextOffs, length, i, bw, bh, pitch);
 				if (bh == 0) {
 					return;
 				}
@@ -494,6 +496,10 @@ void SmushDeltaBlocksDecoder::proc4WithoutFDFE(byte *dst, const byte *src, int32
 }
 
 void SmushDeltaBlocksDecoder::decode(byte *dst, const byte *src) {
+	memcpy(dst, decodeFrame(src), _frameSize);
+}
+
+const byte *SmushDeltaBlocksDecoder::decodeFrame(const byte *src) {
 	int32 bw = (_width + 3) / 4, bh = (_height + 3) / 4;
 	int32 pitch = bw * 4;
 
@@ -566,7 +572,7 @@ void SmushDeltaBlocksDecoder::decode(byte *dst, const byte *src) {
 	}
 	_prevSeqNb = seqNb;
 
-	memcpy(dst, _deltaBufs[_curTable], _frameSize);
+	return _deltaBufs[_curTable];
 }
 
 } // End of namespace Scumm
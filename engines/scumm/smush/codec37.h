@@ -50,8 +50,15 @@ protected:
 	void proc3WithoutFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
 	void proc4WithFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
 	void proc4WithoutFDFE(byte *dst, const byte *src, int32, int, int, int, int16 *);
+	void copyBlockRun(byte *&dst, int32 nextOffs, int32 length, int32 &i, int bw, int &bh, int pitch);
 public:
 	void decode(byte *dst, const byte *src);
+
+	/**
+	 * Decode a frame into the internal buffers without copying it out.
+	 * The returned frame stays valid until the next decode call.
+	 */
+	const byte *decodeFrame(const byte *src);
 };
 
 } // End of namespace Scumm
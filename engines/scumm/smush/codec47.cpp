@@ -44,23 +44,45 @@ namespace Scumm {
 		(dst)[1] = (src)[1];    \
 	} while (0)
 
+#define COPY_8X1_LINE(dst, src)                 \
+	do {                                        \
+		COPY_4X1_LINE(dst, src);                \
+		COPY_4X1_LINE((dst) + 4, (src) + 4);    \
+	} while (0)
+
+#define FILL_4X1_LINE(dst, val) \
+	do {                        \
+		(dst)[0] = val;         \
+		(dst)[1] = val;         \
+		(dst)[2] = val;         \
+		(dst)[3] = val;         \
+	} while (0)
 
 #else /* SCUMM_NEED_ALIGNMENT */
 
+// Blocks are moved a whole line at a time. The 8 pixel wide lines of the
+// top level blocks are copied with a single 64-bit move, which is one
+// register move on 64-bit targets and two 32-bit moves elsewhere. Fills
+// replicate the color into a word instead of storing single bytes.
+
 #define COPY_4X1_LINE(dst, src)               \
 	*(uint32 *)(dst) = *(const uint32 *)(src)
 
 #define COPY_2X1_LINE(dst, src)               \
 	*(uint16 *)(dst) = *(const uint16 *)(src)
 
+#define COPY_8X1_LINE(dst, src)               \
+	*(uint64 *)(dst) = *(const uint64 *)(src)
+
+#define FILL_4X1_LINE(dst, val)               \
+	*(uint32 *)(dst) = (byte)(val) * 0x01010101U
+
 #endif
 
-#define FILL_4X1_LINE(dst, val) \
-	do {                        \
-		(dst)[0] = val;         \
-		(dst)[1] = val;         \
-		(dst)[2] = val;         \
-		(dst)[3] = val;         \
+#define FILL_8X1_LINE(dst, val)          \
+	do {                                 \
+		FILL_4X1_LINE(dst, val);         \
+		FILL_4X1_LINE((dst) + 4, val);   \
 	} while (0)
 
 #define FILL_2X1_LINE(dst, val) \
@@ -463,8 +485,7 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	if (code < MOTION_OFFSET_TABLE_SIZE) {
 		tmp = _table[code] + _offset1;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _dPitch;
 		}
 	} else if (code == PROCESS_SUBBLOCKS) {
@@ -478,8 +499,7 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	} else if (code == FILL_SINGLE_COLOR) {
 		byte t = *_dSrc++;
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _dPitch;
 		}
 	} else if (code == DRAW_GLYPH) {
@@ -502,15 +522,13 @@ void SmushDeltaGlyphsDecoder::level1(byte *d_dst) {
 	} else if (code == COPY_PREV_BUFFER) {
 		tmp = _offset2;
 		for (i = 0; i < 8; i++) {
-			COPY_4X1_LINE(d_dst + 0, d_dst + tmp);
-			COPY_4X1_LINE(d_dst + 4, d_dst + tmp + 4);
+			COPY_8X1_LINE(d_dst, d_dst + tmp);
 			d_dst += _dPitch;
 		}
 	} else {
 		byte t = _paramPtr[code];
 		for (i = 0; i < 8; i++) {
-			FILL_4X1_LINE(d_dst, t);
-			FILL_4X1_LINE(d_dst + 4, t);
+			FILL_8X1_LINE(d_dst, t);
 			d_dst += _dPitch;
 		}
 	}
@@ -574,9 +592,18 @@ SmushDeltaGlyphsDecoder::~SmushDeltaGlyphsDecoder() {
 }
 
 bool SmushDeltaGlyphsDecoder::decode(byte *dst, const byte *src) {
-	if ((_tableBig == nullptr) || (_tableSmall == nullptr) || (_deltaBuf == nullptr))
+	const byte *frame = decodeFrame(src);
+	if (!frame)
 		return false;
 
+	memcpy(dst, frame, _frameSize);
+	return true;
+}
+
+const byte *SmushDeltaGlyphsDecoder::decodeFrame(const byte *src) {
+	if ((_tableBig == nullptr) || (_tableSmall == nullptr) || (_deltaBuf == nullptr))
+		return nullptr;
+
 	_offset1 = _deltaBufs[1] - _curBuf;
 	_offset2 = _deltaBufs[0] - _curBuf;
 
@@ -621,7 +648,8 @@ bool SmushDeltaGlyphsDecoder::decode(byte *dst, const byte *src) {
 		break;
 	}
 
-	memcpy(dst, _curBuf, _frameSize);
+	// The buffer swap below keeps this frame intact until the next call
+	const byte *frame = _curBuf;
 
 	if (seqNb == _prevSeqNb + 1) {
 		if (src[3] == 1) {
@@ -633,7 +661,7 @@ bool SmushDeltaGlyphsDecoder::decode(byte *dst, const byte *src) {
 	}
 	_prevSeqNb = seqNb;
 
-	return true;
+	return frame;
 }
 
 } // End of namespace Scumm
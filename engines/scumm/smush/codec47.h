@@ -55,6 +55,12 @@ public:
 	SmushDeltaGlyphsDecoder(int width, int height);
 	~SmushDeltaGlyphsDecoder();
 	bool decode(byte *dst, const byte *src);
+
+	/**
+	 * Decode a frame into the internal buffers without copying it out.
+	 * The returned frame stays valid until the next decode call.
+	 */
+	const byte *decodeFrame(const byte *src);
 };
 
 } // End of namespace Scumm
@@ -231,6 +231,8 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm, IMuseDigital *imuseDigital, Insa
 	_specialBuffer = nullptr;
 
 	_seekPos = -1;
+	_aheadPos = -1;
+	_aheadFrame = nullptr;
 
 	_skipNext = false;
 	_dst = nullptr;
@@ -277,6 +279,8 @@ void SmushPlayer::init(int32 speed) {
 	_frame = 0;
 	_speed = speed;
 	_endOfFile = false;
+	_aheadPos = -1;
+	_aheadFrame = nullptr;
 
 	_vm->_smushVideoShouldFinish = false;
 	_vm->_smushActive = true;
@@ -334,6 +338,9 @@ void SmushPlayer::release() {
 	_deltaBlocksCodec = 0;
 	delete _deltaGlyphsCodec;
 	_deltaGlyphsCodec = 0;
+
+	_aheadPos = -1;
+	_aheadFrame = nullptr;
 }
 
 void SmushPlayer::handleStore(int32 subSize, Common::SeekableReadStream &b) {
@@ -772,12 +779,23 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		smushDecodeRLE(_dst, src, left, top, width, height, _vm->_screenWidth);
 		break;
 	case SMUSH_CODEC_DELTA_BLOCKS:
+		if (_aheadFrame) {
+			// Already decoded by decodeAhead()
+			memcpy(_dst, _aheadFrame, width * height);
+			_aheadFrame = nullptr;
+			break;
+		}
 		if (!_deltaBlocksCodec)
 			_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
 		if (_deltaBlocksCodec)
 			_deltaBlocksCodec->decode(_dst, src);
 		break;
 	case SMUSH_CODEC_DELTA_GLYPHS:
+		if (_aheadFrame) {
+			memcpy(_dst, _aheadFrame, width * height);
+			_aheadFrame = nullptr;
+			break;
+		}
 		if (!_deltaGlyphsCodec)
 			_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
 		if (_deltaGlyphsCodec)
@@ -847,6 +865,13 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	b.readUint16LE();
 	b.readUint16LE();
 
+	if (_aheadPos >= 0 && _aheadPos == b.pos()) {
+		// The data was consumed when the frame was decoded ahead
+		_aheadPos = -1;
+		decodeFrameObject(codec, nullptr, left, top, width, height);
+		return;
+	}
+
 	int32 chunk_size = subSize - 14;
 	byte *chunk_buffer = (byte *)malloc(chunk_size);
 	assert(chunk_buffer);
@@ -1093,6 +1118,78 @@ void SmushPlayer::parseNextFrame() {
 	_vm->_imuseDigital->flushTracks();
 }
 
+/**
+ * Decode the frame object of the next frame while the player is waiting
+ * for it to be due, so that the decoding time is taken out of the frame
+ * presentation path. Only full screen frames of the delta codecs are
+ * handled: those decode into buffers owned by the codec, which stay valid
+ * until the next decode call, and are always the first thing in the
+ * frame to touch the codec state. The chunk is located by peeking at the
+ * stream; handleFrameObject() recognizes it by its position and copies
+ * the decoded picture instead of decoding it again.
+ */
+void SmushPlayer::decodeAhead() {
+	if (_aheadPos >= 0 || _insanity || _seekPos >= 0 || _endOfFile || !_base)
+		return;
+
+	const int32 startPos = _base->pos();
+	if (_base->readUint32BE() != MKTAG('F','R','M','E')) {
+		_base->seek(startPos, SEEK_SET);
+		return;
+	}
+
+	int32 frameSize = _base->readUint32BE();
+	while (frameSize > 0 && !_base->eos() && _base->pos() < (int32)_baseSize) {
+		const uint32 subType = _base->readUint32BE();
+		const int32 subSize = _base->readUint32BE();
+		const int32 subOffset = _base->pos();
+
+		if (subType == MKTAG('F','O','B','J') && subSize >= 14) {
+			int codec = _base->readUint16LE();
+			_base->skip(4);
+			int width = _base->readUint16LE();
+			int height = _base->readUint16LE();
+			_base->skip(4);
+
+			if ((codec == SMUSH_CODEC_DELTA_BLOCKS || codec == SMUSH_CODEC_DELTA_GLYPHS) &&
+				width == _vm->_screenWidth && height == _vm->_screenHeight) {
+				int32 chunkSize = subSize - 14;
+				byte *chunkBuffer = (byte *)malloc(chunkSize);
+				assert(chunkBuffer);
+				_base->read(chunkBuffer, chunkSize);
+
+				if (codec == SMUSH_CODEC_DELTA_BLOCKS) {
+					if (!_deltaBlocksCodec)
+						_deltaBlocksCodec = new SmushDeltaBlocksDecoder(width, height);
+					_aheadFrame = _deltaBlocksCodec->decodeFrame(chunkBuffer);
+				} else {
+					if (!_deltaGlyphsCodec)
+						_deltaGlyphsCodec = new SmushDeltaGlyphsDecoder(width, height);
+					_aheadFrame = _deltaGlyphsCodec->decodeFrame(chunkBuffer);
+				}
+				free(chunkBuffer);
+
+				if (_aheadFrame)
+					_aheadPos = subOffset + 14;
+			}
+			break;
+		}
+
+		// Anything else that decodes pictures has to be handled in order
+		if (subType == MKTAG('Z','F','O','B'))
+			break;
+
+		frameSize -= subSize + 8;
+		_base->seek(subOffset + subSize, SEEK_SET);
+		if (subSize & 1) {
+			_base->skip(1);
+			frameSize--;
+		}
+	}
+
+	_base->seek(startPos, SEEK_SET);
+}
+
 void SmushPlayer::setPalette(const byte *palette) {
 	memcpy(_pal, palette, 0x300);
 	setDirtyColors(0, 255);
@@ -1135,6 +1232,8 @@ void SmushPlayer::seekSan(const char *file, int32 pos, int32 contFrame) {
 	_seekPos = pos;
 	_seekFrame = contFrame;
 	_pauseTime = 0;
+	_aheadPos = -1;
+	_aheadFrame = nullptr;
 }
 
 void SmushPlayer::tryCmpFile(const char *filename) {
@@ -1308,6 +1407,7 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			_imuseDigital->stopSMUSHAudio(); // For DIG & COMI
 			break;
 		}
+		decodeAhead();
 		_vm->_system->delayMillis(10);
 	}
 
@@ -149,6 +149,11 @@ private:
 	bool _skipNext;
 	uint32 _frame;
 
+	// Frame object of the next frame which was already decoded while
+	// waiting for its presentation time (see decodeAhead())
+	int32 _aheadPos;
+	const byte *_aheadFrame;
+
 	Audio::SoundHandle *_IACTchannel;
 	Audio::QueuingAudioStream *_IACTstream;
 
@@ -228,6 +233,7 @@ protected:
 private:
 	SmushFont *getFont(int font);
 	void parseNextFrame();
+	void decodeAhead();
 	void init(int32 spped);
 	void setupAnim(const char *file);
 	void updateScreen();
@@ -116,6 +116,11 @@ struct DrawStep {
 
 VectorRenderer *createRenderer(int mode);
 
+/**
+ * Create a renderer for the given pixel format instead of the overlay format.
+ */
+VectorRenderer *createRenderer(int mode, const PixelFormat &format);
+
 /**
  * VectorRenderer: The core Vector Renderer Class
  *
@@ -294,6 +299,28 @@ public:
 	 */
 	virtual void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) = 0;
 
+	/** The colors currently set, in the format of the active surface. */
+	struct Colors {
+		uint32 fg, bg, bevel;
+		uint32 gradientStart, gradientEnd;
+
+		bool operator==(const Colors &c) const {
+			return fg == c.fg && bg == c.bg && bevel == c.bevel &&
+				gradientStart == c.gradientStart && gradientEnd == c.gradientEnd;
+		}
+	};
+
+	/**
+	 * Return the colors currently set. Drawing steps which do not set all
+	 * the colors themselves use the ones left by the previous steps.
+	 */
+	virtual Colors getColors() const = 0;
+
+	/**
+	 * Set the colors specified by a draw step, as done when drawing it.
+	 */
+	void setStepColors(const DrawStep &step);
+
 	/**
 	 * Sets the active drawing surface. All drawing from this
 	 * point on will be done on that surface.
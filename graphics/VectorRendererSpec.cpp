@@ -425,14 +425,12 @@ namespace Graphics {
 /**
  * Fills several pixels in a row with a given color.
  *
- * This is a replacement function for Common::fill, using an unrolled
- * loop to maximize performance on most architectures.
- * This function may (and should) be overloaded in any child renderers
- * for portable platforms with platform-specific assembly code.
+ * This is a replacement function for Common::fill. Longer spans are filled
+ * 64 bits at a time once the pointer is aligned, which the compiler is free
+ * to widen further into vector stores.
  *
  * This fill operation is extensively used throughout the renderer, so this
- * counts as one of the main bottlenecks. Please replace it with assembly
- * when possible!
+ * counts as one of the main bottlenecks.
  *
  * @param first Pointer to the first pixel to fill.
  * @param last Pointer to the last pixel to fill.
@@ -441,22 +439,35 @@ namespace Graphics {
 template<typename PixelType>
 void colorFill(PixelType *first, PixelType *last, PixelType color) {
 	int count = (last - first);
-	if (!count)
+	if (count <= 0)
 		return;
-	int n = (count + 7) >> 3;
-	switch (count % 8) {
-	default:
-	case 0:	do {
-	       		*first++ = color; // fall through
-	case 7:		*first++ = color; // fall through
-	case 6:		*first++ = color; // fall through
-	case 5:		*first++ = color; // fall through
-	case 4:		*first++ = color; // fall through
-	case 3:		*first++ = color; // fall through
-	case 2:		*first++ = color; // fall through
-	case 1:		*first++ = color;
-	       	} while (--n > 0);
+
+	const int perWord = 8 / sizeof(PixelType);
+	if (count >= perWord * 4) {
+		while (((uintptr)first & 7) && count) {
+			*first++ = color;
+			count--;
+		}
+
+		uint64 pattern = color;
+		for (uint bits = sizeof(PixelType) * 8; bits < 64; bits *= 2)
+			pattern |= pattern << bits;
+
+		for (; count >= perWord * 4; count -= perWord * 4) {
+			memcpy(first, &pattern, 8);
+			memcpy(first + perWord, &pattern, 8);
+			memcpy(first + perWord * 2, &pattern, 8);
+			memcpy(first + perWord * 3, &pattern, 8);
+			first += perWord * 4;
+		}
+		for (; count >= perWord; count -= perWord) {
+			memcpy(first, &pattern, 8);
+			first += perWord;
+		}
 	}
+
+	while (count--)
+		*first++ = color;
 }
 
 template<typename PixelType>
@@ -481,23 +492,36 @@ void colorFillClip(PixelType *first, PixelType *last, PixelType color, int realX
 		count -= diff;
 	}
 
-	if (!count)
+	colorFill<PixelType>(first, first + count, color);
+}
+
+/**
+ * Fills several pixels in a row with two alternating colors, as used by the
+ * dithered gradients.
+ *
+ * @param first Pointer to the first pixel to fill.
+ * @param last Pointer to the last pixel to fill.
+ * @param x Horizontal coordinate of the first pixel, selecting the phase.
+ * @param even Color of the pixels in even columns.
+ * @param odd Color of the pixels in odd columns.
+ */
+template<typename PixelType>
+void colorFillAlternate(PixelType *first, PixelType *last, int x, PixelType even, PixelType odd) {
+	if (even == odd) {
+		colorFill<PixelType>(first, last, even);
 		return;
+	}
 
-	int n = (count + 7) >> 3;
-	switch (count % 8) {
-	default:
-	case 0:	do {
-	       		*first++ = color; // fall through
-	case 7:		*first++ = color; // fall through
-	case 6:		*first++ = color; // fall through
-	case 5:		*first++ = color; // fall through
-	case 4:		*first++ = color; // fall through
-	case 3:		*first++ = color; // fall through
-	case 2:		*first++ = color; // fall through
-	case 1:		*first++ = color;
-	       	} while (--n > 0);
+	if ((x & 1) && first < last)
+		*first++ = odd;
+
+	for (; last - first >= 2; first += 2) {
+		first[0] = even;
+		first[1] = odd;
 	}
+
+	if (first < last)
+		*first = even;
 }
 
 /**
@@ -550,28 +574,31 @@ void colorVFillClip(PixelType *first, PixelType *last, int pitch, PixelType colo
 
 
 VectorRenderer *createRenderer(int mode) {
+	return createRenderer(mode, g_system->getOverlayFormat());
+}
+
+VectorRenderer *createRenderer(int mode, const PixelFormat &format) {
 #ifdef DISABLE_FANCY_THEMES
 	assert(mode == GUI::ThemeEngine::kGfxStandard);
 #endif
 
-	PixelFormat format = g_system->getOverlayFormat();
 	switch (mode) {
 	case GUI::ThemeEngine::kGfxStandard:
-		if (g_system->getOverlayFormat().bytesPerPixel == 4)
+		if (format.bytesPerPixel == 4)
 			return new VectorRendererSpec<uint32>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 2)
+		else if (format.bytesPerPixel == 2)
 			return new VectorRendererSpec<uint16>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 1)
+		else if (format.bytesPerPixel == 1)
 			return new VectorRendererSpec<uint8>(format);
 		break;
 #ifndef DISABLE_FANCY_THEMES
 	case GUI::ThemeEngine::kGfxAntialias:
-		if (g_system->getOverlayFormat().bytesPerPixel == 4)
+		if (format.bytesPerPixel == 4)
 			return new VectorRendererAA<uint32>(format);
-		else if (g_system->getOverlayFormat().bytesPerPixel == 2)
+		else if (format.bytesPerPixel == 2)
 			return new VectorRendererAA<uint16>(format);
 		// No AA with 8-bit
-		else if (g_system->getOverlayFormat().bytesPerPixel == 1)
+		else if (format.bytesPerPixel == 1)
 			return new VectorRendererSpec<uint8>(format);
 		break;
 #endif
@@ -595,6 +622,11 @@ VectorRendererSpec(PixelFormat format) :
 
 	_fgColor = _bgColor = _bevelColor = 0;
 	_gradientStart = _gradientEnd = 0;
+
+	_byteChannels = sizeof(PixelType) == 4 &&
+		format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+		(format.rShift % 8) == 0 && (format.gShift % 8) == 0 && (format.bShift % 8) == 0 &&
+		(format.aLoss == 8 || (format.aLoss == 0 && (format.aShift % 8) == 0));
 }
 
 /****************************
@@ -618,6 +650,18 @@ setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2) {
 	}
 }
 
+template<typename PixelType>
+VectorRenderer::Colors VectorRendererSpec<PixelType>::
+getColors() const {
+	Colors colors;
+	colors.fg = _fgColor;
+	colors.bg = _bgColor;
+	colors.bevel = _bevelColor;
+	colors.gradientStart = _gradientStart;
+	colors.gradientEnd = _gradientEnd;
+	return colors;
+}
+
 template<typename PixelType>
 inline PixelType VectorRendererSpec<PixelType>::
 calcGradient(uint32 pos, uint32 max) {
@@ -684,16 +728,10 @@ gradientFill(PixelType *ptr, int width, int x, int y) {
 	} else if (grad == 3 && ox) {
 		colorFill<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1]);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		// The pattern only depends on the parity of the column
+		const PixelType even = ((grad == 2 || grad == 3) && ox) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		colorFillAlternate<PixelType>(ptr, ptr + width, x, even, odd);
 	}
 }
 
@@ -726,17 +764,14 @@ gradientFillClip(PixelType *ptr, int width, int x, int y, int realX, int realY)
 	} else if (grad == 3 && ox) {
 		colorFillClip<PixelType>(ptr, ptr + width, _gradCache[curGrad + 1], realX, realY, _clippingArea);
 	} else {
-		for (int j = x; j < x + width; j++, ptr++) {
-			if (realX + j - x < _clippingArea.left || realX + j - x >= _clippingArea.right) continue;
-			bool oy = ((j & 1) == 1);
-
-			if ((ox && oy) ||
-				((grad == 2 || grad == 3) && ox && !oy) ||
-				(grad == 3 && oy))
-				*ptr = _gradCache[curGrad + 1];
-			else
-				*ptr = _gradCache[curGrad];
-		}
+		const int left = MAX(_clippingArea.left - realX, 0);
+		const int right = MIN(_clippingArea.right - realX, width);
+		if (left >= right)
+			return;
+
+		const PixelType even = ((grad == 2 || grad == 3) && ox) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		const PixelType odd = (ox || grad == 3) ? _gradCache[curGrad + 1] : _gradCache[curGrad];
+		colorFillAlternate<PixelType>(ptr + left, ptr + right, x + left, even, odd);
 	}
 }
 
@@ -911,6 +946,75 @@ blendPixelPtr(PixelType *ptr, PixelType color, uint8 alpha) {
 	}
 }
 
+template<typename PixelType>
+void VectorRendererSpec<PixelType>::
+blendFill(PixelType *first, PixelType *last, PixelType color, uint8 alpha) {
+	if (first >= last)
+		return;
+
+	if (alpha == 0xff) {
+		colorFill<PixelType>(first, last, color | _alphaMask);
+		return;
+	} else if (sizeof(PixelType) == 1) {
+		if (alpha & 0x80)
+			colorFill<PixelType>(first, last, color);
+		return;
+	}
+
+	// Same as blendPixelPtr(), with the source terms hoisted out of the loop:
+	// d + ((s - d) * alpha >> 8) == (d * (256 - alpha) + s * alpha) >> 8
+	const uint32 inv = 256 - alpha;
+
+	if (_byteChannels) {
+		// Blend the red/blue and the green/alpha bytes (in whatever order
+		// they are) pairwise in 16-bit lanes. The destination alpha blends
+		// towards opaque, and any padding byte ends up cleared.
+		const uint32 mask = _redMask | _greenMask | _blueMask | _alphaMask;
+		const uint32 src = color | _alphaMask;
+		const uint32 srcLo = (src & 0x00FF00FF) * alpha;
+		const uint32 srcHi = ((src >> 8) & 0x00FF00FF) * alpha;
+
+		for (; first < last; first++) {
+			const uint32 dst = *first;
+			const uint32 lo = (((dst & 0x00FF00FF) * inv + srcLo) >> 8) & 0x00FF00FF;
+			const uint32 hi = (((dst >> 8) & 0x00FF00FF) * inv + srcHi) & 0xFF00FF00;
+			*first = (PixelType)((lo | hi) & mask);
+		}
+	} else if (sizeof(PixelType) == 4) {
+		const uint32 sR = ((color & _redMask) >> _format.rShift) * alpha;
+		const uint32 sG = ((color & _greenMask) >> _format.gShift) * alpha;
+		const uint32 sB = ((color & _blueMask) >> _format.bShift) * alpha;
+		const uint32 sA = 0xff * alpha;
+
+		for (; first < last; first++) {
+			const uint32 dst = *first;
+			const uint32 dR = (((byte)((dst & _redMask) >> _format.rShift)) * inv + sR) >> 8;
+			const uint32 dG = (((byte)((dst & _greenMask) >> _format.gShift)) * inv + sG) >> 8;
+			const uint32 dB = (((byte)((dst & _blueMask) >> _format.bShift)) * inv + sB) >> 8;
+			const uint32 dA = (((byte)((dst & _alphaMask) >> _format.aShift)) * inv + sA) >> 8;
+
+			*first = ((dR << _format.rShift) & _redMask)
+			       | ((dG << _format.gShift) & _greenMask)
+			       | ((dB << _format.bShift) & _blueMask)
+			       | ((dA << _format.aShift) & _alphaMask);
+		}
+	} else {
+		const uint32 sR = (color & _redMask) * alpha;
+		const uint32 sG = (color & _greenMask) * alpha;
+		const uint32 sB = (color & _blueMask) * alpha;
+		const uint32 sA = _alphaMask * alpha;
+
+		for (; first < last; first++) {
+			const uint32 dst = *first;
+			*first = (PixelType)(
+				((((dst & _redMask) * inv + sR) >> 8) & _redMask) |
+				((((dst & _greenMask) * inv + sG) >> 8) & _greenMask) |
+				((((dst & _blueMask) * inv + sB) >> 8) & _blueMask) |
+				((((dst & _alphaMask) * inv + sA) >> 8) & _alphaMask));
+		}
+	}
+}
+
 template<typename PixelType>
 inline void VectorRendererSpec<PixelType>::
 blendPixelPtrClip(PixelType *ptr, PixelType color, uint8 alpha, int x, int y) {
@@ -30,6 +30,12 @@ struct Point;
 }
 
 class BlendBlitUnfilteredTestSuite;
+class CrossBlitTestSuite;
+class TransBlitTestSuite;
+
+namespace Benchmark {
+class BlitSuite;
+}
 
 namespace Graphics {
 
@@ -233,6 +239,7 @@ private:
 	typedef void(*BlitFunc)(Args &, const TSpriteBlendMode &, const AlphaType &);
 	static BlitFunc blitFunc;
 	friend class ::BlendBlitUnfilteredTestSuite;
+	friend class ::Benchmark::BlitSuite;
 	friend class BlendBlitImpl;
 
 public:
@@ -310,6 +317,131 @@ public:
 
 }; // End of class BlendBlit
 
+// This is a class so that we can declare certain things as private
+class KeyBlit {
+private:
+	struct Args {
+		byte *dst;
+		const byte *src;
+		uint dstPitch, srcPitch;
+		uint width, height;
+		uint bytesPerPixel;
+		uint32 key, mask;
+		const uint32 *map;
+	};
+
+#ifdef SCUMMVM_NEON
+	static void blitNEON(const Args &args);
+#endif
+#ifdef SCUMMVM_SSE2
+	static void blitSSE2(const Args &args);
+#endif
+#ifdef SCUMMVM_AVX2
+	static void blitAVX2(const Args &args);
+	static void blitMapAVX2(const Args &args);
+#endif
+	static void blitGeneric(const Args &args);
+	static void blitMapGeneric(const Args &args);
+
+	typedef void(*BlitFunc)(const Args &);
+	static BlitFunc blitFunc, blitMapFunc;
+	static void selectFuncs();
+	friend class ::CrossBlitTestSuite;
+	friend class ::TransBlitTestSuite;
+	friend class ::Benchmark::BlitSuite;
+
+public:
+	/**
+	 * Blits a rectangle with a transparent color key, using the fastest
+	 * implementation the cpu supports.
+	 *
+	 * Pixels equal to @p key are skipped, all others are written as
+	 * (color & mask). The source and destination must not overlap.
+	 *
+	 * @param bytesPerPixel	the number of bytes per pixel (1, 2 or 4)
+	 * @param key			the transparent color key
+	 * @param mask			the mask applied to the copied pixels
+	 */
+	static void blit(byte *dst, const byte *src,
+			  const uint dstPitch, const uint srcPitch,
+			  const uint w, const uint h,
+			  const uint bytesPerPixel, const uint32 key,
+			  const uint32 mask = 0xFFFFFFFF);
+
+	/**
+	 * Blits a rectangle of CLUT8 pixels through a color map, skipping
+	 * source pixels equal to @p key, using the fastest implementation the
+	 * cpu supports. The source and destination must not overlap.
+	 *
+	 * @param bytesPerPixel	the number of bytes per destination pixel (1, 2 or 4)
+	 * @param map			256 destination colors, as for crossBlitMap()
+	 * @param key			the transparent color key of the source, a key
+	 *						above 255 makes all pixels opaque
+	 */
+	static void blitMap(byte *dst, const byte *src,
+			  const uint dstPitch, const uint srcPitch,
+			  const uint w, const uint h,
+			  const uint bytesPerPixel, const uint32 *map, const uint32 key);
+
+}; // End of class KeyBlit
+
+// This is a class so that we can declare certain things as private
+class CrossBlit {
+private:
+	struct Args {
+		byte *dst;
+		const byte *src;
+		uint dstPitch, srcPitch;
+		uint width, height;
+		const PixelFormat *dstFmt, *srcFmt;
+		byte shuffle[4];
+		uint32 fill;
+	};
+
+	/** One of the converters compiled for a fixed pair of formats. */
+	typedef void(*ConvertFunc)(const Args &);
+	template<class SrcFormat, class DstFormat>
+	static void convertLogic(const Args &args);
+	struct Converter;
+	static const Converter kConverters[];
+	static const Converter *lastConverter;
+	static const Converter *findConverter(const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+	static bool getShuffle(Args &args);
+	static bool canExpand(const Args &args);
+
+#ifdef SCUMMVM_AVX2
+	static void shuffleAVX2(const Args &args);
+	static void expandAVX2(const Args &args);
+#endif
+	static void shuffleGeneric(const Args &args);
+
+	typedef void(*BlitFunc)(const Args &);
+	static BlitFunc shuffleFunc, expandFunc;
+	static bool funcsSelected;
+	static void selectFuncs();
+	friend class ::CrossBlitTestSuite;
+	friend class ::Benchmark::BlitSuite;
+
+public:
+	/**
+	 * Converts a rectangle between two of the common pixel formats, with
+	 * converters specialized for the pair of formats, using the fastest
+	 * implementation the cpu supports.
+	 *
+	 * The results are identical to those of converting each pixel with
+	 * PixelFormat::colorToARGB() and PixelFormat::ARGBToColor(), and
+	 * conversion in place is supported as for crossBlit().
+	 *
+	 * @return	false if there is no specialized converter for the formats
+	 */
+	static bool blit(byte *dst, const byte *src,
+			  const uint dstPitch, const uint srcPitch,
+			  const uint w, const uint h,
+			  const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+}; // End of class CrossBlit
+
 /** @} */
 } // End of namespace Graphics
 
@@ -464,4 +464,228 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
     }
 }
 
+template<typename Size>
+static inline void keyBlitTail(byte *dst, const byte *src, uint width, const uint32 key, const uint32 mask) {
+	for (; width; --width) {
+		const uint32 color = *(const Size *)src;
+		if (color != key)
+			*(Size *)dst = color & mask;
+		src += sizeof(Size);
+		dst += sizeof(Size);
+	}
+}
+
+template<typename Size>
+static inline __m256i keyBlitCompare(__m256i src, __m256i key) {
+	if (sizeof(Size) == 1)
+		return _mm256_cmpeq_epi8(src, key);
+	else if (sizeof(Size) == 2)
+		return _mm256_cmpeq_epi16(src, key);
+	else
+		return _mm256_cmpeq_epi32(src, key);
+}
+
+template<typename Size>
+static void keyBlitLogic(byte *dst, const byte *src, const uint width, const uint height,
+                         const uint dstPitch, const uint srcPitch, const uint32 key, const uint32 mask) {
+	const uint pixelsPerVector = 32 / sizeof(Size);
+	__m256i keyVec, maskVec;
+	if (sizeof(Size) == 1) {
+		keyVec = _mm256_set1_epi8((char)key);
+		maskVec = _mm256_set1_epi8((char)mask);
+	} else if (sizeof(Size) == 2) {
+		keyVec = _mm256_set1_epi16((short)key);
+		maskVec = _mm256_set1_epi16((short)mask);
+	} else {
+		keyVec = _mm256_set1_epi32(key);
+		maskVec = _mm256_set1_epi32(mask);
+	}
+
+	for (uint y = 0; y < height; ++y) {
+		const byte *in = src;
+		byte *out = dst;
+		uint x = width;
+		for (; x >= pixelsPerVector; x -= pixelsPerVector) {
+			const __m256i s = _mm256_loadu_si256((const __m256i *)in);
+			const __m256i d = _mm256_loadu_si256((const __m256i *)out);
+			const __m256i transparent = keyBlitCompare<Size>(s, keyVec);
+			_mm256_storeu_si256((__m256i *)out, _mm256_blendv_epi8(_mm256_and_si256(s, maskVec), d, transparent));
+			in += 32;
+			out += 32;
+		}
+		keyBlitTail<Size>(out, in, x, key, mask);
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void KeyBlit::blitAVX2(const Args &args) {
+	if (args.bytesPerPixel == 1) {
+		keyBlitLogic<uint8>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else if (args.bytesPerPixel == 2) {
+		keyBlitLogic<uint16>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else {
+		assert(args.bytesPerPixel == 4);
+		keyBlitLogic<uint32>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	}
+}
+
+// Looks up eight CLUT8 pixels at once with a gather, for 16 and 32 bit
+// destinations. 8 bit destinations are left to the generic version.
+void KeyBlit::blitMapAVX2(const Args &args) {
+	if (args.bytesPerPixel == 1) {
+		blitMapGeneric(args);
+		return;
+	}
+
+	const __m256i keyVec = _mm256_set1_epi32(args.key);
+	const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+	const int *map = (const int *)args.map;
+	const byte *src = args.src;
+	byte *dst = args.dst;
+
+	for (uint y = 0; y < args.height; ++y) {
+		const byte *in = src;
+		byte *out = dst;
+		uint x = args.width;
+		for (; x >= 8; x -= 8) {
+			const __m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)in));
+			const __m256i color = _mm256_i32gather_epi32(map, index, 4);
+			const __m256i transparent = _mm256_cmpeq_epi32(index, keyVec);
+			if (args.bytesPerPixel == 2) {
+				// Pack to 16 bits, the 128 bit lanes are interleaved by the packs
+				const __m256i color16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(_mm256_and_si256(color, lowMask), _mm256_setzero_si256()), 0xD8);
+				const __m256i transparent16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(transparent, _mm256_setzero_si256()), 0xD8);
+				const __m128i d = _mm_loadu_si128((const __m128i *)out);
+				_mm_storeu_si128((__m128i *)out, _mm_blendv_epi8(_mm256_castsi256_si128(color16), d, _mm256_castsi256_si128(transparent16)));
+				out += 16;
+			} else {
+				const __m256i d = _mm256_loadu_si256((const __m256i *)out);
+				_mm256_storeu_si256((__m256i *)out, _mm256_blendv_epi8(color, d, transparent));
+				out += 32;
+			}
+			in += 8;
+		}
+
+		for (; x; --x) {
+			const byte color = *in++;
+			if (args.bytesPerPixel == 2) {
+				if (color != args.key)
+					*(uint16 *)out = args.map[color];
+				out += 2;
+			} else {
+				if (color != args.key)
+					*(uint32 *)out = args.map[color];
+				out += 4;
+			}
+		}
+
+		src += args.srcPitch;
+		dst += args.dstPitch;
+	}
+}
+
+// Moves the bytes of eight 32 bit pixels at once
+void CrossBlit::shuffleAVX2(const Args &args) {
+	// The byte shuffle works within each 128 bit lane
+	byte control[32];
+	for (int i = 0; i < 32; i++) {
+		const byte index = args.shuffle[i % 4];
+		control[i] = (index & 0x80) ? 0x80 : (i & 12) + index;
+	}
+	const __m256i controlVec = _mm256_loadu_si256((const __m256i *)control);
+	const __m256i fillVec = _mm256_set1_epi32(args.fill);
+
+	const byte *src = args.src;
+	byte *dst = args.dst;
+	for (uint y = 0; y < args.height; ++y) {
+		const byte *in = src;
+		byte *out = dst;
+		uint x = args.width;
+		for (; x >= 8; x -= 8) {
+			const __m256i color = _mm256_loadu_si256((const __m256i *)in);
+			_mm256_storeu_si256((__m256i *)out, _mm256_or_si256(_mm256_shuffle_epi8(color, controlVec), fillVec));
+			in += 32;
+			out += 32;
+		}
+
+		for (; x; --x) {
+			byte color[4], result[4];
+			memcpy(color, in, 4);
+			for (int i = 0; i < 4; i++)
+				result[i] = (args.shuffle[i] & 0x80) ? 0 : color[args.shuffle[i]];
+			uint32 value;
+			memcpy(&value, result, 4);
+			*(uint32 *)out = value | args.fill;
+			in += 4;
+			out += 4;
+		}
+
+		src += args.srcPitch;
+		dst += args.dstPitch;
+	}
+}
+
+// Converts eight 16 bit pixels at once to a 32 bit format with 8 bits per
+// channel. The channels are expanded with a multiplication, which repeats the
+// bits of a channel just like ColorComponent does.
+void CrossBlit::expandAVX2(const Args &args) {
+	static const uint16 kExpandMul[9] = { 0, 255, 85, 73, 17, 33, 65, 129, 1 };
+	static const byte kExpandShift[9] = { 0, 0, 0, 1, 0, 2, 4, 6, 0 };
+
+	const PixelFormat &srcFmt = *args.srcFmt, &dstFmt = *args.dstFmt;
+	const uint srcBits[4] = { srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits(), srcFmt.aBits() };
+	const uint dstBits[4] = { dstFmt.rBits(), dstFmt.gBits(), dstFmt.bBits(), dstFmt.aBits() };
+	const uint srcShift[4] = { srcFmt.rShift, srcFmt.gShift, srcFmt.bShift, srcFmt.aShift };
+	const uint dstShift[4] = { dstFmt.rShift, dstFmt.gShift, dstFmt.bShift, dstFmt.aShift };
+
+	__m128i srcShiftVec[4], expandShiftVec[4], dstShiftVec[4];
+	__m256i maskVec[4], mulVec[4];
+	uint32 fill = 0;
+	int channels = 0;
+	for (int i = 0; i < 4; i++) {
+		if (!dstBits[i])
+			continue;
+		if (!srcBits[i]) {
+			// A missing alpha channel is opaque, a missing color channel 0
+			if (i == 3)
+				fill |= 0xFFU << dstShift[i];
+			continue;
+		}
+		srcShiftVec[channels] = _mm_cvtsi32_si128(srcShift[i]);
+		expandShiftVec[channels] = _mm_cvtsi32_si128(kExpandShift[srcBits[i]]);
+		dstShiftVec[channels] = _mm_cvtsi32_si128(dstShift[i]);
+		maskVec[channels] = _mm256_set1_epi32((1 << srcBits[i]) - 1);
+		mulVec[channels] = _mm256_set1_epi32(kExpandMul[srcBits[i]]);
+		channels++;
+	}
+	const __m256i fillVec = _mm256_set1_epi32(fill);
+
+	// Convert from bottom right to top left, so that the source is not
+	// overwritten when converting in place, as in crossBlit()
+	for (uint y = args.height; y--; ) {
+		const byte *src = args.src + y * args.srcPitch;
+		byte *dst = args.dst + y * args.dstPitch;
+		uint x = args.width;
+		while (x >= 8) {
+			x -= 8;
+			const __m256i color = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + x * 2)));
+			__m256i result = fillVec;
+			for (int i = 0; i < channels; i++) {
+				__m256i value = _mm256_and_si256(_mm256_srl_epi32(color, srcShiftVec[i]), maskVec[i]);
+				value = _mm256_srl_epi32(_mm256_mullo_epi16(value, mulVec[i]), expandShiftVec[i]);
+				result = _mm256_or_si256(result, _mm256_sll_epi32(value, dstShiftVec[i]));
+			}
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), result);
+		}
+
+		while (x--) {
+			byte a, r, g, b;
+			srcFmt.colorToARGB(*(const uint16 *)(src + x * 2), a, r, g, b);
+			*(uint32 *)(dst + x * 4) = dstFmt.ARGBToColor(a, r, g, b);
+		}
+	}
+}
+
 } // End of namespace Graphics
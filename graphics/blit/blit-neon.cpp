@@ -462,4 +462,71 @@ void BlendBlit::blitNEON(Args &args, const TSpriteBlendMode &blendMode, const Al
     }
 }
 
+template<typename Size>
+static inline void keyBlitTail(byte *dst, const byte *src, uint width, const uint32 key, const uint32 mask) {
+	for (; width; --width) {
+		const uint32 color = *(const Size *)src;
+		if (color != key)
+			*(Size *)dst = color & mask;
+		src += sizeof(Size);
+		dst += sizeof(Size);
+	}
+}
+
+template<typename Size>
+static inline uint8x16_t keyBlitCompare(uint8x16_t src, uint8x16_t key) {
+	if (sizeof(Size) == 1)
+		return vceqq_u8(src, key);
+	else if (sizeof(Size) == 2)
+		return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(src), vreinterpretq_u16_u8(key)));
+	else
+		return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(src), vreinterpretq_u32_u8(key)));
+}
+
+template<typename Size>
+static void keyBlitLogic(byte *dst, const byte *src, const uint width, const uint height,
+                         const uint dstPitch, const uint srcPitch, const uint32 key, const uint32 mask) {
+	const uint pixelsPerVector = 16 / sizeof(Size);
+	uint8x16_t keyVec, maskVec;
+	if (sizeof(Size) == 1) {
+		keyVec = vdupq_n_u8(key);
+		maskVec = vdupq_n_u8(mask);
+	} else if (sizeof(Size) == 2) {
+		keyVec = vreinterpretq_u8_u16(vdupq_n_u16(key));
+		maskVec = vreinterpretq_u8_u16(vdupq_n_u16(mask));
+	} else {
+		keyVec = vreinterpretq_u8_u32(vdupq_n_u32(key));
+		maskVec = vreinterpretq_u8_u32(vdupq_n_u32(mask));
+	}
+
+	for (uint y = 0; y < height; ++y) {
+		const byte *in = src;
+		byte *out = dst;
+		uint x = width;
+		for (; x >= pixelsPerVector; x -= pixelsPerVector) {
+			const uint8x16_t s = vld1q_u8(in);
+			const uint8x16_t d = vld1q_u8(out);
+			const uint8x16_t transparent = keyBlitCompare<Size>(s, keyVec);
+			vst1q_u8(out, vbslq_u8(transparent, d, vandq_u8(s, maskVec)));
+			in += 16;
+			out += 16;
+		}
+		keyBlitTail<Size>(out, in, x, key, mask);
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void KeyBlit::blitNEON(const Args &args) {
+	if (args.bytesPerPixel == 1) {
+		keyBlitLogic<uint8>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else if (args.bytesPerPixel == 2) {
+		keyBlitLogic<uint16>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else {
+		assert(args.bytesPerPixel == 4);
+		keyBlitLogic<uint32>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	}
+}
+
 } // end of namespace Graphics
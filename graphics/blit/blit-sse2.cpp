@@ -465,4 +465,71 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
     }
 }
 
+template<typename Size>
+static inline void keyBlitTail(byte *dst, const byte *src, uint width, const uint32 key, const uint32 mask) {
+	for (; width; --width) {
+		const uint32 color = *(const Size *)src;
+		if (color != key)
+			*(Size *)dst = color & mask;
+		src += sizeof(Size);
+		dst += sizeof(Size);
+	}
+}
+
+template<typename Size>
+static inline __m128i keyBlitCompare(__m128i src, __m128i key) {
+	if (sizeof(Size) == 1)
+		return _mm_cmpeq_epi8(src, key);
+	else if (sizeof(Size) == 2)
+		return _mm_cmpeq_epi16(src, key);
+	else
+		return _mm_cmpeq_epi32(src, key);
+}
+
+template<typename Size>
+static void keyBlitLogic(byte *dst, const byte *src, const uint width, const uint height,
+                         const uint dstPitch, const uint srcPitch, const uint32 key, const uint32 mask) {
+	const uint pixelsPerVector = 16 / sizeof(Size);
+	__m128i keyVec, maskVec;
+	if (sizeof(Size) == 1) {
+		keyVec = _mm_set1_epi8((char)key);
+		maskVec = _mm_set1_epi8((char)mask);
+	} else if (sizeof(Size) == 2) {
+		keyVec = _mm_set1_epi16((short)key);
+		maskVec = _mm_set1_epi16((short)mask);
+	} else {
+		keyVec = _mm_set1_epi32(key);
+		maskVec = _mm_set1_epi32(mask);
+	}
+
+	for (uint y = 0; y < height; ++y) {
+		const byte *in = src;
+		byte *out = dst;
+		uint x = width;
+		for (; x >= pixelsPerVector; x -= pixelsPerVector) {
+			const __m128i s = _mm_loadu_si128((const __m128i *)in);
+			const __m128i d = _mm_loadu_si128((const __m128i *)out);
+			const __m128i transparent = keyBlitCompare<Size>(s, keyVec);
+			_mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, _mm_and_si128(s, maskVec))));
+			in += 16;
+			out += 16;
+		}
+		keyBlitTail<Size>(out, in, x, key, mask);
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void KeyBlit::blitSSE2(const Args &args) {
+	if (args.bytesPerPixel == 1) {
+		keyBlitLogic<uint8>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else if (args.bytesPerPixel == 2) {
+		keyBlitLogic<uint16>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	} else {
+		assert(args.bytesPerPixel == 4);
+		keyBlitLogic<uint32>(args.dst, args.src, args.width, args.height, args.dstPitch, args.srcPitch, args.key, args.mask);
+	}
+}
+
 } // End of namespace Graphics
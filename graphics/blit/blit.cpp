@@ -19,6 +19,7 @@
  *
  */
 
+#include "common/system.h"
 #include "graphics/blit.h"
 #include "graphics/pixelformat.h"
 
@@ -50,12 +51,12 @@ namespace {
 
 template<typename Size>
 inline void keyBlitLogic(byte *dst, const byte *src, const uint w, const uint h,
-						 const uint srcDelta, const uint dstDelta, const uint32 key) {
+						 const uint srcDelta, const uint dstDelta, const uint32 key, const uint32 mask) {
 	for (uint y = 0; y < h; ++y) {
 		for (uint x = 0; x < w; ++x) {
 			uint32 color = *(const Size *)src;
 			if (color != key)
-				*(Size *)dst = color;
+				*(Size *)dst = color & mask;
 
 			src += sizeof(Size);
 			dst += sizeof(Size);
@@ -76,23 +77,84 @@ bool keyBlit(byte *dst, const byte *src,
 	if (dst == src)
 		return true;
 
-	// Faster, but larger, to provide optimized handling for each case.
-	const uint srcDelta = (srcPitch - w * bytesPerPixel);
-	const uint dstDelta = (dstPitch - w * bytesPerPixel);
-
-	if (bytesPerPixel == 1) {
-		keyBlitLogic<uint8>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else if (bytesPerPixel == 2) {
-		keyBlitLogic<uint16>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else if (bytesPerPixel == 4) {
-		keyBlitLogic<uint32>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else {
+	if (bytesPerPixel != 1 && bytesPerPixel != 2 && bytesPerPixel != 4)
 		return false;
-	}
 
+	KeyBlit::blit(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, key);
 	return true;
 }
 
+// Initialize these to nullptr at the start
+KeyBlit::BlitFunc KeyBlit::blitFunc = nullptr;
+KeyBlit::BlitFunc KeyBlit::blitMapFunc = nullptr;
+
+void KeyBlit::selectFuncs() {
+	blitFunc = blitGeneric;
+	blitMapFunc = blitMapGeneric;
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) blitFunc = blitNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) blitFunc = blitSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		blitFunc = blitAVX2;
+		blitMapFunc = blitMapAVX2;
+	}
+#endif
+}
+
+void KeyBlit::blit(byte *dst, const byte *src,
+				   const uint dstPitch, const uint srcPitch,
+				   const uint w, const uint h,
+				   const uint bytesPerPixel, const uint32 key, const uint32 mask) {
+	if (w == 0 || h == 0)
+		return;
+
+	// If no function has been selected yet, detect and select
+	if (!blitFunc)
+		selectFuncs();
+
+	const Args args = { dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, key, mask, nullptr };
+
+	// A key which does not fit into a pixel never matches, which the
+	// vectorized versions do not handle
+	if (bytesPerPixel < 4 && (key >> (bytesPerPixel * 8)) != 0)
+		blitGeneric(args);
+	else
+		blitFunc(args);
+}
+
+void KeyBlit::blitMap(byte *dst, const byte *src,
+					  const uint dstPitch, const uint srcPitch,
+					  const uint w, const uint h,
+					  const uint bytesPerPixel, const uint32 *map, const uint32 key) {
+	if (w == 0 || h == 0)
+		return;
+
+	// If no function has been selected yet, detect and select
+	if (!blitMapFunc)
+		selectFuncs();
+
+	const Args args = { dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, key, 0xFFFFFFFF, map };
+	blitMapFunc(args);
+}
+
+void KeyBlit::blitGeneric(const Args &args) {
+	const uint srcDelta = (args.srcPitch - args.width * args.bytesPerPixel);
+	const uint dstDelta = (args.dstPitch - args.width * args.bytesPerPixel);
+
+	if (args.bytesPerPixel == 1) {
+		keyBlitLogic<uint8>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.key, args.mask);
+	} else if (args.bytesPerPixel == 2) {
+		keyBlitLogic<uint16>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.key, args.mask);
+	} else {
+		assert(args.bytesPerPixel == 4);
+		keyBlitLogic<uint32>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.key, args.mask);
+	}
+}
+
 namespace {
 
 template<typename SrcColor, typename DstColor, bool backward, bool hasKey>
@@ -195,6 +257,349 @@ inline void crossBlitLogic3BppSource(byte *dst, const byte *src, const uint w, c
 
 } // End of anonymous namespace
 
+namespace {
+
+/**
+ * A pixel format known at compile time, for the converters specialized for
+ * a pair of formats. Colors are converted exactly as PixelFormat does.
+ */
+template<uint BytesPerPixel, uint RBits, uint GBits, uint BBits, uint ABits,
+		 uint RShift, uint GShift, uint BShift, uint AShift>
+struct FixedFormat {
+	static const uint kBytesPerPixel = BytesPerPixel;
+	static const uint kRBits = RBits, kGBits = GBits, kBBits = BBits, kABits = ABits;
+	static const uint kRShift = RShift, kGShift = GShift, kBShift = BShift, kAShift = AShift;
+
+	static inline uint32 read(const byte *src) {
+		if (BytesPerPixel == 2)
+			return *(const uint16 *)src;
+		if (BytesPerPixel == 4)
+			return *(const uint32 *)src;
+#ifdef SCUMM_BIG_ENDIAN
+		return (src[0] << 16) | (src[1] << 8) | src[2];
+#else
+		return src[0] | (src[1] << 8) | (src[2] << 16);
+#endif
+	}
+
+	static inline void write(byte *dst, const uint32 color) {
+		if (BytesPerPixel == 2)
+			*(uint16 *)dst = color;
+		else
+			*(uint32 *)dst = color;
+	}
+};
+
+typedef FixedFormat<2, 5, 6, 5, 0, 11, 5, 0, 0> FormatRGB565;
+typedef FixedFormat<2, 5, 5, 5, 0, 10, 5, 0, 0> FormatRGB555;
+typedef FixedFormat<2, 5, 5, 5, 1, 10, 5, 0, 15> FormatARGB1555;
+typedef FixedFormat<2, 5, 5, 5, 1, 11, 6, 1, 0> FormatRGBA5551;
+typedef FixedFormat<2, 4, 4, 4, 4, 12, 8, 4, 0> FormatRGBA4444;
+typedef FixedFormat<3, 8, 8, 8, 0, 16, 8, 0, 0> FormatRGB888;
+typedef FixedFormat<3, 8, 8, 8, 0, 0, 8, 16, 0> FormatBGR888;
+typedef FixedFormat<4, 8, 8, 8, 8, 24, 16, 8, 0> FormatRGBA8888;
+typedef FixedFormat<4, 8, 8, 8, 8, 16, 8, 0, 24> FormatARGB8888;
+typedef FixedFormat<4, 8, 8, 8, 8, 0, 8, 16, 24> FormatABGR8888;
+typedef FixedFormat<4, 8, 8, 8, 8, 8, 16, 24, 0> FormatBGRA8888;
+typedef FixedFormat<4, 8, 8, 8, 0, 16, 8, 0, 0> FormatXRGB8888;
+
+template<class SrcFormat, class DstFormat>
+inline uint32 convertColor(const uint32 color) {
+	const uint a = SrcFormat::kABits == 0 ? 0xFF : ColorComponent<SrcFormat::kABits>::expand(color >> SrcFormat::kAShift);
+	const uint r = ColorComponent<SrcFormat::kRBits>::expand(color >> SrcFormat::kRShift);
+	const uint g = ColorComponent<SrcFormat::kGBits>::expand(color >> SrcFormat::kGShift);
+	const uint b = ColorComponent<SrcFormat::kBBits>::expand(color >> SrcFormat::kBShift);
+	return ((a >> (8 - DstFormat::kABits)) << DstFormat::kAShift) |
+	       ((r >> (8 - DstFormat::kRBits)) << DstFormat::kRShift) |
+	       ((g >> (8 - DstFormat::kGBits)) << DstFormat::kGShift) |
+	       ((b >> (8 - DstFormat::kBBits)) << DstFormat::kBShift);
+}
+
+/** Returns the offset in memory of the byte of a 32 bit pixel holding the given bit. */
+inline byte byteIndex(const uint shift) {
+#ifdef SCUMM_BIG_ENDIAN
+	return 3 - shift / 8;
+#else
+	return shift / 8;
+#endif
+}
+
+} // End of anonymous namespace
+
+template<class SrcFormat, class DstFormat>
+void CrossBlit::convertLogic(const Args &args) {
+	if (DstFormat::kBytesPerPixel > SrcFormat::kBytesPerPixel) {
+		// Convert from bottom right to top left, so that the source is not
+		// overwritten when converting in place, as in crossBlit()
+		for (uint y = args.height; y--; ) {
+			const byte *src = args.src + y * args.srcPitch + args.width * SrcFormat::kBytesPerPixel;
+			byte *dst = args.dst + y * args.dstPitch + args.width * DstFormat::kBytesPerPixel;
+			for (uint x = args.width; x; --x) {
+				src -= SrcFormat::kBytesPerPixel;
+				dst -= DstFormat::kBytesPerPixel;
+				DstFormat::write(dst, convertColor<SrcFormat, DstFormat>(SrcFormat::read(src)));
+			}
+		}
+	} else {
+		const byte *src = args.src;
+		byte *dst = args.dst;
+		for (uint y = 0; y < args.height; ++y) {
+			for (uint x = 0; x < args.width; ++x) {
+				DstFormat::write(dst + x * DstFormat::kBytesPerPixel,
+					convertColor<SrcFormat, DstFormat>(SrcFormat::read(src + x * SrcFormat::kBytesPerPixel)));
+			}
+			src += args.srcPitch;
+			dst += args.dstPitch;
+		}
+	}
+}
+
+struct CrossBlit::Converter {
+	struct Format {
+		byte bytesPerPixel;
+		byte rBits, gBits, bBits, aBits;
+		byte rShift, gShift, bShift, aShift;
+
+		bool matches(const PixelFormat &format) const {
+			// The alpha shift doesn't matter without an alpha channel
+			return bytesPerPixel == format.bytesPerPixel &&
+			       rBits == format.rBits() && gBits == format.gBits() &&
+			       bBits == format.bBits() && aBits == format.aBits() &&
+			       rShift == format.rShift && gShift == format.gShift &&
+			       bShift == format.bShift && (!aBits || aShift == format.aShift);
+		}
+	};
+
+	Format src, dst;
+	ConvertFunc func;
+};
+
+#define CONVERTER_FORMAT(FORMAT) \
+	{ FORMAT::kBytesPerPixel, FORMAT::kRBits, FORMAT::kGBits, FORMAT::kBBits, FORMAT::kABits, \
+	  FORMAT::kRShift, FORMAT::kGShift, FORMAT::kBShift, FORMAT::kAShift }
+
+#define CONVERTER(SRC, DST) \
+	{ CONVERTER_FORMAT(SRC), CONVERTER_FORMAT(DST), convertLogic<SRC, DST> }
+
+#define CONVERTERS_FROM_24BPP(DST) \
+	CONVERTER(FormatRGB888, DST), \
+	CONVERTER(FormatBGR888, DST)
+
+#define CONVERTERS_TO_32BPP(DST) \
+	CONVERTER(FormatRGB565, DST), \
+	CONVERTER(FormatRGB555, DST), \
+	CONVERTER(FormatARGB1555, DST), \
+	CONVERTER(FormatRGBA5551, DST), \
+	CONVERTER(FormatRGBA4444, DST), \
+	CONVERTERS_FROM_24BPP(DST)
+
+#define CONVERTERS_TO_16BPP(DST) \
+	CONVERTER(FormatRGBA8888, DST), \
+	CONVERTER(FormatARGB8888, DST), \
+	CONVERTER(FormatABGR8888, DST), \
+	CONVERTER(FormatBGRA8888, DST), \
+	CONVERTER(FormatXRGB8888, DST), \
+	CONVERTERS_FROM_24BPP(DST)
+
+// The formats used by the backends and most engines. Conversions between
+// the 32 bit formats are only listed for cpus without a faster byte shuffle.
+const CrossBlit::Converter CrossBlit::kConverters[] = {
+	CONVERTERS_TO_32BPP(FormatRGBA8888),
+	CONVERTERS_TO_32BPP(FormatARGB8888),
+	CONVERTERS_TO_32BPP(FormatABGR8888),
+	CONVERTERS_TO_32BPP(FormatBGRA8888),
+	CONVERTERS_TO_32BPP(FormatXRGB8888),
+
+	// The conversions between 16 bit formats are listed separately
+	CONVERTERS_TO_16BPP(FormatRGB565),
+	CONVERTER(FormatRGB555, FormatRGB565),
+	CONVERTER(FormatARGB1555, FormatRGB565),
+	CONVERTER(FormatRGBA5551, FormatRGB565),
+	CONVERTER(FormatRGBA4444, FormatRGB565),
+
+	CONVERTERS_TO_16BPP(FormatRGB555),
+	CONVERTER(FormatRGB565, FormatRGB555),
+	CONVERTER(FormatARGB1555, FormatRGB555),
+	CONVERTER(FormatRGBA5551, FormatRGB555),
+	CONVERTER(FormatRGBA4444, FormatRGB555),
+
+	CONVERTERS_TO_16BPP(FormatARGB1555),
+	CONVERTER(FormatRGB565, FormatARGB1555),
+	CONVERTER(FormatRGB555, FormatARGB1555),
+	CONVERTER(FormatRGBA5551, FormatARGB1555),
+	CONVERTER(FormatRGBA4444, FormatARGB1555),
+
+	CONVERTERS_TO_16BPP(FormatRGBA5551),
+	CONVERTER(FormatRGB565, FormatRGBA5551),
+	CONVERTER(FormatRGB555, FormatRGBA5551),
+	CONVERTER(FormatARGB1555, FormatRGBA5551),
+	CONVERTER(FormatRGBA4444, FormatRGBA5551),
+
+	CONVERTERS_TO_16BPP(FormatRGBA4444),
+	CONVERTER(FormatRGB565, FormatRGBA4444),
+	CONVERTER(FormatRGB555, FormatRGBA4444),
+	CONVERTER(FormatARGB1555, FormatRGBA4444),
+	CONVERTER(FormatRGBA5551, FormatRGBA4444),
+
+	CONVERTER(FormatRGBA8888, FormatARGB8888),
+	CONVERTER(FormatRGBA8888, FormatABGR8888),
+	CONVERTER(FormatRGBA8888, FormatBGRA8888),
+	CONVERTER(FormatRGBA8888, FormatXRGB8888),
+	CONVERTER(FormatARGB8888, FormatRGBA8888),
+	CONVERTER(FormatARGB8888, FormatABGR8888),
+	CONVERTER(FormatARGB8888, FormatBGRA8888),
+	CONVERTER(FormatARGB8888, FormatXRGB8888),
+	CONVERTER(FormatABGR8888, FormatRGBA8888),
+	CONVERTER(FormatABGR8888, FormatARGB8888),
+	CONVERTER(FormatABGR8888, FormatBGRA8888),
+	CONVERTER(FormatABGR8888, FormatXRGB8888),
+	CONVERTER(FormatBGRA8888, FormatRGBA8888),
+	CONVERTER(FormatBGRA8888, FormatARGB8888),
+	CONVERTER(FormatBGRA8888, FormatABGR8888),
+	CONVERTER(FormatBGRA8888, FormatXRGB8888),
+	CONVERTER(FormatXRGB8888, FormatRGBA8888),
+	CONVERTER(FormatXRGB8888, FormatARGB8888),
+	CONVERTER(FormatXRGB8888, FormatABGR8888),
+	CONVERTER(FormatXRGB8888, FormatBGRA8888)
+};
+
+#undef CONVERTERS_TO_16BPP
+#undef CONVERTERS_TO_32BPP
+#undef CONVERTERS_FROM_24BPP
+#undef CONVERTER
+#undef CONVERTER_FORMAT
+
+// Initialize these to nullptr at the start
+const CrossBlit::Converter *CrossBlit::lastConverter = nullptr;
+CrossBlit::BlitFunc CrossBlit::shuffleFunc = nullptr;
+CrossBlit::BlitFunc CrossBlit::expandFunc = nullptr;
+bool CrossBlit::funcsSelected = false;
+
+void CrossBlit::selectFuncs() {
+	shuffleFunc = nullptr;
+	expandFunc = nullptr;
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		shuffleFunc = shuffleAVX2;
+		expandFunc = expandAVX2;
+	}
+#endif
+	funcsSelected = true;
+}
+
+const CrossBlit::Converter *CrossBlit::findConverter(const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	// The same pair of formats is usually converted over and over again, so
+	// remember the last converter used
+	const Converter *converter = lastConverter;
+	if (converter && converter->src.matches(srcFmt) && converter->dst.matches(dstFmt))
+		return converter;
+
+	for (uint i = 0; i < ARRAYSIZE(kConverters); i++) {
+		converter = &kConverters[i];
+		if (converter->src.matches(srcFmt) && converter->dst.matches(dstFmt)) {
+			lastConverter = converter;
+			return converter;
+		}
+	}
+	return nullptr;
+}
+
+// Checks whether the conversion between two 32 bit formats only moves the
+// bytes of a pixel around, and sets up the byte order and the bits to set
+// for the shuffling converters if so
+bool CrossBlit::getShuffle(Args &args) {
+	const PixelFormat &srcFmt = *args.srcFmt, &dstFmt = *args.dstFmt;
+	if (srcFmt.bytesPerPixel != 4 || dstFmt.bytesPerPixel != 4)
+		return false;
+
+	const uint srcBits[4] = { srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits(), srcFmt.aBits() };
+	const uint dstBits[4] = { dstFmt.rBits(), dstFmt.gBits(), dstFmt.bBits(), dstFmt.aBits() };
+	const uint srcShift[4] = { srcFmt.rShift, srcFmt.gShift, srcFmt.bShift, srcFmt.aShift };
+	const uint dstShift[4] = { dstFmt.rShift, dstFmt.gShift, dstFmt.bShift, dstFmt.aShift };
+
+	memset(args.shuffle, 0x80, sizeof(args.shuffle));
+	args.fill = 0;
+	for (int i = 0; i < 4; i++) {
+		if (!dstBits[i])
+			continue;
+		if (dstBits[i] != 8 || dstShift[i] % 8 != 0)
+			return false;
+
+		if (srcBits[i] == 8 && srcShift[i] % 8 == 0)
+			args.shuffle[byteIndex(dstShift[i])] = byteIndex(srcShift[i]);
+		else if (srcBits[i] == 0 && i == 3)
+			args.fill = 0xFFU << dstShift[i]; // Opaque alpha
+		else if (srcBits[i] != 0)
+			return false;
+	}
+	return true;
+}
+
+// Checks whether the conversion is from a 16 bit format to a 32 bit format
+// with 8 bits per channel, as supported by expandAVX2()
+bool CrossBlit::canExpand(const Args &args) {
+	const PixelFormat &dstFmt = *args.dstFmt;
+	return args.srcFmt->bytesPerPixel == 2 && dstFmt.bytesPerPixel == 4 &&
+	       (dstFmt.rLoss == 0 || dstFmt.rLoss == 8) && (dstFmt.gLoss == 0 || dstFmt.gLoss == 8) &&
+	       (dstFmt.bLoss == 0 || dstFmt.bLoss == 8) && (dstFmt.aLoss == 0 || dstFmt.aLoss == 8);
+}
+
+void CrossBlit::shuffleGeneric(const Args &args) {
+	const byte *src = args.src;
+	byte *dst = args.dst;
+	for (uint y = 0; y < args.height; ++y) {
+		for (uint x = 0; x < args.width; ++x) {
+			byte color[4], result[4];
+			memcpy(color, src + x * 4, 4);
+			for (int i = 0; i < 4; i++)
+				result[i] = (args.shuffle[i] & 0x80) ? 0 : color[args.shuffle[i]];
+			uint32 value;
+			memcpy(&value, result, 4);
+			*(uint32 *)(dst + x * 4) = value | args.fill;
+		}
+		src += args.srcPitch;
+		dst += args.dstPitch;
+	}
+}
+
+bool CrossBlit::blit(byte *dst, const byte *src,
+					 const uint dstPitch, const uint srcPitch,
+					 const uint w, const uint h,
+					 const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	if (w == 0 || h == 0)
+		return true;
+
+	// If no function has been selected yet, detect and select
+	if (!funcsSelected)
+		selectFuncs();
+
+	Args args = { dst, src, dstPitch, srcPitch, w, h, &dstFmt, &srcFmt, { 0, 0, 0, 0 }, 0 };
+	const bool shuffle = getShuffle(args);
+
+	// The vectorized versions are preferred over the converters below
+	if (shuffle && shuffleFunc) {
+		shuffleFunc(args);
+		return true;
+	}
+	if (expandFunc && canExpand(args)) {
+		expandFunc(args);
+		return true;
+	}
+
+	const Converter *converter = findConverter(dstFmt, srcFmt);
+	if (converter) {
+		converter->func(args);
+		return true;
+	}
+
+	// Any other conversion between 32 bit formats which only moves bytes
+	if (shuffle) {
+		shuffleGeneric(args);
+		return true;
+	}
+	return false;
+}
+
 // Function to blit a rect from one color format to another
 bool crossBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
@@ -212,6 +617,10 @@ bool crossBlit(byte *dst, const byte *src,
 		return true;
 	}
 
+	// Use the converters specialized for the formats, if there are any
+	if (CrossBlit::blit(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt))
+		return true;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * srcFmt.bytesPerPixel);
 	const uint dstDelta = (dstPitch - w * dstFmt.bytesPerPixel);
@@ -320,6 +729,13 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if ((bytesPerPixel == 3) || (!bytesPerPixel))
 		return false;
 
+	// Use the vectorized lookups if the conversion is not done in place.
+	// No key matches a key above 255.
+	if (bytesPerPixel != 1 && (dst >= src + h * srcPitch || src >= dst + h * dstPitch)) {
+		KeyBlit::blitMap(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map, 0x100);
+		return true;
+	}
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w);
 	const uint dstDelta = (dstPitch - w * bytesPerPixel);
@@ -389,4 +805,18 @@ bool crossKeyBlitMap(byte *dst, const byte *src,
 	return true;
 }
 
+void KeyBlit::blitMapGeneric(const Args &args) {
+	const uint srcDelta = (args.srcPitch - args.width);
+	const uint dstDelta = (args.dstPitch - args.width * args.bytesPerPixel);
+
+	if (args.bytesPerPixel == 1) {
+		crossBlitLogic1BppSource<uint8, false, true>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.map, args.key);
+	} else if (args.bytesPerPixel == 2) {
+		crossBlitLogic1BppSource<uint16, false, true>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.map, args.key);
+	} else {
+		assert(args.bytesPerPixel == 4);
+		crossBlitLogic1BppSource<uint32, false, true>(args.dst, args.src, args.width, args.height, srcDelta, dstDelta, args.map, args.key);
+	}
+}
+
 } // End of namespace Graphics
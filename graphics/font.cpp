@@ -49,13 +49,67 @@ Common::Rect Font::getBoundingBox(uint32 chr) const {
 
 namespace {
 
+// Only strings of characters are laid out by the fonts
+const Font::TextRun *getTextRun(const Font &font, const Common::String &str) {
+	return nullptr;
+}
+
+const Font::TextRun *getTextRun(const Font &font, const Common::U32String &str) {
+	return font.getTextRun(str);
+}
+
+Common::Rect getBoundingBoxImpl(const Font::TextRun &run, int x, int y, int leftX, int rightX) {
+	bool first = true;
+	Common::Rect bbox;
+
+	for (uint i = 0; i < run.chars.size(); ++i) {
+		const Font::TextRun::Char &cur = run.chars[i];
+		const int charX = x + cur.x;
+		if (charX + cur.box.right > rightX)
+			break;
+		if (charX + cur.box.right >= leftX) {
+			Common::Rect charBox = cur.box;
+			charBox.translate(charX, y);
+			if (first) {
+				bbox = charBox;
+				first = false;
+			} else {
+				bbox.extend(charBox);
+			}
+		}
+	}
+
+	return bbox;
+}
+
+template<class SurfaceType>
+void drawStringImpl(const Font &font, SurfaceType *dst, const Font::TextRun &run, int x, int y, int leftX, int rightX, uint32 color) {
+	// The visible characters are passed on in batches, only split where
+	// characters are skipped at the left edge
+	uint first = 0, i;
+	for (i = 0; i < run.chars.size(); ++i) {
+		const Font::TextRun::Char &cur = run.chars[i];
+		if (x + cur.x + cur.box.right > rightX)
+			break;
+		if (x + cur.x + cur.box.right < leftX) {
+			if (first < i)
+				font.drawTextRun(dst, run, first, i, x, y, color);
+			first = i + 1;
+		}
+	}
+
+	if (first < i)
+		font.drawTextRun(dst, run, first, i, x, y, color);
+}
+
 template<class StringType>
 Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x, int y, int w, TextAlign align, int deltax) {
 	// We follow the logic of drawStringImpl here. The only exception is
 	// that we do allow an empty width to be specified here. This allows us
 	// to obtain the complete bounding box of a string.
 	const int leftX = x, rightX = w ? (x + w + 1) : 0x7FFFFFFF;
-	int width = font.getStringWidth(str);
+	const Font::TextRun *run = getTextRun(font, str);
+	int width = run ? run->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -63,6 +117,9 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 		x = x + w - width;
 	x += deltax;
 
+	if (run)
+		return getBoundingBoxImpl(*run, x, y, leftX, rightX);
+
 	bool first = true;
 	Common::Rect bbox;
 
@@ -91,8 +148,11 @@ Common::Rect getBoundingBoxImpl(const Font &font, const StringType &str, int x,
 	return bbox;
 }
 
+// Same as getStringWidthImpl, but without asking the font for a laid out
+// run. This is used for the temporary strings of the word wrapping, which
+// would otherwise fill the run cache of the font.
 template<class StringType>
-int getStringWidthImpl(const Font &font, const StringType &str) {
+int getCharsWidth(const Font &font, const StringType &str) {
 	int space = 0;
 	typename StringType::unsigned_type last = 0;
 
@@ -105,6 +165,15 @@ int getStringWidthImpl(const Font &font, const StringType &str) {
 	return space;
 }
 
+template<class StringType>
+int getStringWidthImpl(const Font &font, const StringType &str) {
+	const Font::TextRun *run = getTextRun(font, str);
+	if (run)
+		return run->width;
+
+	return getCharsWidth(font, str);
+}
+
 template<class SurfaceType, class StringType>
 void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, int x, int y, int w, uint32 color, TextAlign align, int deltax) {
 	// The logic in getBoundingImpl is the same as we use here. In case we
@@ -112,7 +181,8 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 	assert(dst != 0);
 
 	const int leftX = x, rightX = x + w + 1;
-	int width = font.getStringWidth(str);
+	const Font::TextRun *run = getTextRun(font, str);
+	int width = run ? run->width : font.getStringWidth(str);
 
 	if (align == kTextAlignCenter)
 		x = x + (w - width)/2;
@@ -120,6 +190,11 @@ void drawStringImpl(const Font &font, SurfaceType *dst, const StringType &str, i
 		x = x + w - width;
 	x += deltax;
 
+	if (run) {
+		drawStringImpl(font, dst, *run, x, y, leftX, rightX, color);
+		return;
+	}
+
 	typename StringType::unsigned_type last = 0;
 	for (typename StringType::const_iterator i = str.begin(), end = str.end(); i != end; ++i) {
 		const typename StringType::unsigned_type cur = *i;
@@ -294,7 +369,7 @@ int wordWrapTextImpl(const Font &font, const StringType &str, int maxWidth, Comm
 						tmpStr.deleteChar(0);
 						// This is not very fast, but it is the simplest way to
 						// assure we do not mess something up because of kerning.
-						tmpWidth = font.getStringWidth(tmpStr);
+						tmpWidth = getCharsWidth(font, tmpStr);
 					}
 
 					if (tmpStr.empty()) {
@@ -461,6 +536,16 @@ void Font::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color)
 	dst->addDirtyRect(charBox);
 }
 
+void Font::drawTextRun(Surface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const {
+	for (uint i = first; i < end; ++i)
+		drawChar(dst, run.chars[i].chr, x + run.chars[i].x, y, color);
+}
+
+void Font::drawTextRun(ManagedSurface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const {
+	for (uint i = first; i < end; ++i)
+		drawChar(dst, run.chars[i].chr, x + run.chars[i].x, y, color);
+}
+
 void Font::drawString(Surface *dst, const Common::String &str, int x, int y, int w, uint32 color, TextAlign align, int deltax, bool useEllipsis) const {
 	Common::String renderStr = useEllipsis ? handleEllipsis(*this, str, w) : str;
 	drawStringImpl(*this, dst, renderStr, x, y, w, color, align, deltax);
@@ -22,14 +22,11 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/ustr.h"
 #include "common/rect.h"
 
-namespace Common {
-template<class T> class Array;
-}
-
 namespace Graphics {
 
 /**
@@ -290,6 +287,42 @@ public:
 	 */
 	void scaleSingleGlyph(Surface *scaleSurface, int *grayScaleMap, int grayScaleMapSize, int width, int height, int xOffset, int yOffset, int grayLevel, int chr, int srcheight, int srcwidth, float scale) const;
 
+	/**
+	 * A string laid out by the font. See getTextRun.
+	 */
+	struct TextRun {
+		struct Char {
+			uint32 chr;        ///< The character.
+			int x;             ///< Position of the character in the string, including kerning.
+			Common::Rect box;  ///< Bounding box of the character, as returned by getBoundingBox.
+		};
+
+		Common::Array<Char> chars;
+		int width;             ///< Width of the string, as returned by getStringWidth.
+	};
+
+	/**
+	 * Return the string @p str laid out by the font, or nullptr if the font
+	 * does not support this.
+	 *
+	 * Fonts for which looking up glyphs and kerning is expensive can keep
+	 * the layout of recently used strings, which is then used by drawString,
+	 * getStringWidth and getBoundingBox instead of querying every character.
+	 * The returned run is only valid until the next call.
+	 *
+	 * The default implementation returns nullptr.
+	 */
+	virtual const TextRun *getTextRun(const Common::U32String &str) const { return nullptr; }
+
+	/**
+	 * Draw the characters @p first up to (excluding) @p end of a run returned
+	 * by getTextRun, with the string starting at position (@p x, @p y).
+	 *
+	 * The default implementation draws the characters one by one with drawChar.
+	 */
+	virtual void drawTextRun(Surface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const;
+	virtual void drawTextRun(ManagedSurface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const;
+
 };
 /** @} */
 } // End of namespace Graphics
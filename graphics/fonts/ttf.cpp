@@ -161,6 +161,10 @@ public:
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+	const TextRun *getTextRun(const Common::U32String &str) const override;
+	void drawTextRun(Surface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const override;
+	void drawTextRun(ManagedSurface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const override;
+
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -171,8 +175,15 @@ private:
 	int _width, _height;
 	int _ascent, _descent;
 
+	enum {
+		kGlyphTableSize = 256,
+		kAtlasPageSize = 256,
+		kTextRunCacheSize = 256,
+		kMaxTextRunLength = 256
+	};
+
 	struct Glyph {
-		Surface image;
+		Surface image; ///< Area of an atlas page
 		int xOffset, yOffset;
 		int advance;
 		FT_UInt slot;
@@ -182,7 +193,27 @@ private:
 	typedef Common::HashMap<uint32, Glyph> GlyphCache;
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+	const Glyph *findGlyph(uint32 chr) const;
+
+	// Direct lookup of the first glyphs. The entries of _glyphs are never
+	// moved, so they can be pointed to.
+	mutable const Glyph *_glyphTable[kGlyphTableSize];
+	mutable Common::HashMap<uint32, bool> _missingGlyphs;
+
+	// The glyph images are packed into shelves of larger surfaces
+	mutable Common::Array<Surface *> _atlasPages;
+	mutable Surface *_atlasPage;
+	mutable int _atlasX, _atlasY, _atlasShelfHeight;
+	void allocateGlyphImage(Surface &image, int w, int h) const;
+
+	// Kerning offsets by pair of glyph slots
+	mutable Common::HashMap<uint32, int> _kerningCache;
+
+	typedef Common::HashMap<Common::U32String, TextRun> TextRunCache;
+	mutable TextRunCache _textRuns;
+
+	void drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
@@ -203,7 +234,9 @@ private:
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
 	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
-	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
+	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false),
+	  _atlasPage(nullptr), _atlasX(0), _atlasY(0), _atlasShelfHeight(0) {
+	memset(_glyphTable, 0, sizeof(_glyphTable));
 }
 
 TTFFont::~TTFFont() {
@@ -213,11 +246,13 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
+
+	for (uint i = 0; i < _atlasPages.size(); ++i) {
+		_atlasPages[i]->free();
+		delete _atlasPages[i];
+	}
 }
 
 bool TTFFont::load(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode,
@@ -553,57 +588,78 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return 0;
-	else
-		return glyphEntry->_value.advance;
+	const Glyph *glyph = findGlyph(chr);
+	return glyph ? glyph->advance : 0;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
-	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
-
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
-	} else {
+	const Glyph *leftGlyph = findGlyph(left);
+	const Glyph *rightGlyph = findGlyph(right);
+	if (!leftGlyph || !rightGlyph || !leftGlyph->slot || !rightGlyph->slot)
 		return 0;
-	}
-
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
-	} else {
-		return 0;
-	}
 
-	if (!leftGlyph || !rightGlyph)
-		return 0;
+	const bool cacheable = leftGlyph->slot <= 0xFFFF && rightGlyph->slot <= 0xFFFF;
+	const uint32 key = (leftGlyph->slot << 16) | rightGlyph->slot;
+	int offset;
+	if (cacheable && _kerningCache.tryGetVal(key, offset))
+		return offset;
 
 	FT_Vector kerningVector;
-	FT_Get_Kerning(_face, leftGlyph, rightGlyph, FT_KERNING_DEFAULT, &kerningVector);
-	return (kerningVector.x / 64);
+	FT_Get_Kerning(_face, leftGlyph->slot, rightGlyph->slot, FT_KERNING_DEFAULT, &kerningVector);
+	offset = kerningVector.x / 64;
+
+	if (cacheable)
+		_kerningCache.setVal(key, offset);
+	return offset;
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = findGlyph(chr);
+	if (!glyph)
 		return Common::Rect();
-	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+
+	return Common::Rect(glyph->xOffset, glyph->yOffset, glyph->xOffset + glyph->image.w, glyph->yOffset + glyph->image.h);
+}
+
+const Font::TextRun *TTFFont::getTextRun(const Common::U32String &str) const {
+	if (str.size() > kMaxTextRunLength)
+		return nullptr;
+
+	TextRunCache::const_iterator cached = _textRuns.find(str);
+	if (cached != _textRuns.end())
+		return &cached->_value;
+
+	if (_textRuns.size() >= kTextRunCacheSize)
+		_textRuns.clear();
+
+	TextRun &run = _textRuns.getOrCreateVal(str);
+	run.chars.resize(str.size());
+
+	int x = 0;
+	uint32 last = 0;
+	for (uint i = 0; i < str.size(); ++i) {
+		const uint32 cur = str[i];
+		x += getKerningOffset(last, cur);
+		last = cur;
+
+		TextRun::Char &chr = run.chars[i];
+		chr.chr = cur;
+		chr.x = x;
+
+		const Glyph *glyph = findGlyph(cur);
+		if (glyph) {
+			chr.box = Common::Rect(glyph->xOffset, glyph->yOffset, glyph->xOffset + glyph->image.w, glyph->yOffset + glyph->image.h);
+			x += glyph->advance;
+		} else {
+			chr.box = Common::Rect();
+		}
 	}
+	run.width = x;
+
+	return &run;
 }
 
 namespace {
@@ -659,6 +715,36 @@ void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) con
 	drawChar(dst, chr, x, y, color, nullptr);
 }
 
+void TTFFont::drawTextRun(Surface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const {
+	for (uint i = first; i < end; ++i) {
+		const Glyph *glyph = findGlyph(run.chars[i].chr);
+		if (glyph)
+			drawGlyph(dst, *glyph, x + run.chars[i].x, y, color, nullptr);
+	}
+}
+
+void TTFFont::drawTextRun(ManagedSurface *dst, const TextRun &run, uint first, uint end, int x, int y, uint32 color) const {
+	uint32 transColor = dst->hasTransparentColor() ? dst->getTransparentColor() : 0;
+	const uint32 *transparentColor = dst->hasTransparentColor() ? &transColor : nullptr;
+
+	// Mark the whole batch as dirty at once
+	Common::Rect dirtyRect;
+	for (uint i = first; i < end; ++i) {
+		const TextRun::Char &chr = run.chars[i];
+		const Glyph *glyph = findGlyph(chr.chr);
+		if (glyph)
+			drawGlyph(dst->surfacePtr(), *glyph, x + chr.x, y, color, transparentColor);
+
+		Common::Rect charBox = chr.box;
+		charBox.translate(x + chr.x, y);
+		if (i == first)
+			dirtyRect = charBox;
+		else
+			dirtyRect.extend(charBox);
+	}
+	dst->addDirtyRect(dirtyRect);
+}
+
 void TTFFont::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const {
 	if (dst->hasTransparentColor()) {
 		uint32 transColor = dst->getTransparentColor();
@@ -672,15 +758,15 @@ void TTFFont::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 col
 	dst->addDirtyRect(charBox);
 }
 
-void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
+void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color,
 		const uint32 *transparentColor) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
-
-	const Glyph &glyph = glyphEntry->_value;
+	const Glyph *glyph = findGlyph(chr);
+	if (glyph)
+		drawGlyph(dst, *glyph, x, y, color, transparentColor);
+}
 
+void TTFFont::drawGlyph(Surface *dst, const Glyph &glyph, int x, int y, uint32 color,
+		const uint32 *transparentColor) const {
 	x += glyph.xOffset;
 	y += glyph.yOffset;
 
@@ -813,7 +899,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	allocateGlyphImage(glyph.image, bitmap->width, bitmap->rows);
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -841,6 +927,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 				++dst;
 			}
 
+			dst += glyph.image.pitch - bitmap->width;
 			src += srcPitch;
 		}
 		break;
@@ -855,7 +942,6 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 
 	default:
 		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
 		return false;
 	}
 
@@ -868,15 +954,58 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	return true;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
+void TTFFont::allocateGlyphImage(Surface &image, int w, int h) const {
+	if (w > kAtlasPageSize || h > kAtlasPageSize) {
+		// Too large for the atlas, use a page of its own
+		Surface *page = new Surface();
+		page->create(w, h, PixelFormat::createFormatCLUT8());
+		_atlasPages.push_back(page);
+		image = *page;
 		return;
 	}
 
-	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
+	// Start a new shelf, or a new page, when the glyph does not fit
+	if (_atlasPage && _atlasX + w > kAtlasPageSize) {
+		_atlasX = 0;
+		_atlasY += _atlasShelfHeight;
+		_atlasShelfHeight = 0;
+	}
+
+	if (!_atlasPage || _atlasY + h > kAtlasPageSize) {
+		_atlasPage = new Surface();
+		_atlasPage->create(kAtlasPageSize, kAtlasPageSize, PixelFormat::createFormatCLUT8());
+		_atlasPages.push_back(_atlasPage);
+		_atlasX = _atlasY = _atlasShelfHeight = 0;
+	}
+
+	image.init(w, h, _atlasPage->pitch, _atlasPage->getBasePtr(_atlasX, _atlasY), _atlasPage->format);
+	_atlasX += w;
+	_atlasShelfHeight = MAX(_atlasShelfHeight, h);
+}
+
+const TTFFont::Glyph *TTFFont::findGlyph(uint32 chr) const {
+	if (chr < kGlyphTableSize && _glyphTable[chr])
+		return _glyphTable[chr];
+
+	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry == _glyphs.end()) {
+		if (!chr || !_allowLateCaching || _missingGlyphs.contains(chr))
+			return nullptr;
+
+		Glyph newGlyph;
+		if (!cacheGlyph(newGlyph, chr)) {
+			_missingGlyphs.setVal(chr, true);
+			return nullptr;
+		}
+
+		_glyphs.setVal(chr, newGlyph);
+		glyphEntry = _glyphs.find(chr);
 	}
+
+	const Glyph *glyph = &glyphEntry->_value;
+	if (chr < kGlyphTableSize)
+		_glyphTable[chr] = glyph;
+	return glyph;
 }
 
 Font *loadTTFFont(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
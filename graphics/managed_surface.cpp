@@ -696,6 +696,101 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+template<typename T>
+static void reverseRow(byte *dst, const byte *src, uint width) {
+	const T *in = (const T *)src + width;
+	T *out = (T *)dst;
+	while (width--)
+		*out++ = *--in;
+}
+
+/**
+ * Handles the common unscaled and opaque blits, where each pixel is either
+ * skipped because of the color key or replaced with a value only depending
+ * on the source pixel, with the keyed blitters from graphics/blit. Gives the
+ * same results as transBlit, and returns false for the cases it can't handle.
+ */
+static bool transBlitKeyed(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		uint32 transColor, bool flipped, uint32 overrideColor, uint32 srcAlpha, const byte *srcPalette,
+		const byte *dstPalette, const Surface *mask, bool maskOnly) {
+	if (mask || maskOnly || srcAlpha != 0xff || src.getPixels() == dest.getPixels())
+		return false;
+	if (SCALE_THRESHOLD * srcRect.width() / destRect.width() != SCALE_THRESHOLD ||
+			SCALE_THRESHOLD * srcRect.height() / destRect.height() != SCALE_THRESHOLD)
+		return false;
+
+	const uint srcBpp = src.format.bytesPerPixel;
+	const uint destBpp = dest.format.bytesPerPixel;
+	uint32 map[256];
+	bool useMap = false;
+	uint32 key, rgbMask = 0xFFFFFFFF;
+
+	if (src.format.isCLUT8() && dest.format.isCLUT8()) {
+		key = (byte)transColor;
+		if (overrideColor || (srcPalette && dstPalette)) {
+			byte *lookup = (srcPalette && dstPalette) ? createPaletteLookup(srcPalette, dstPalette) : nullptr;
+			for (int i = 0; i < 256; i++) {
+				const byte color = overrideColor ? overrideColor : i;
+				map[i] = lookup ? lookup[color] : color;
+			}
+			delete[] lookup;
+			useMap = true;
+		}
+	} else if (src.format.isCLUT8() && srcPalette && (destBpp == 2 || destBpp == 4)) {
+		key = (byte)transColor;
+		for (int i = 0; i < 256; i++)
+			map[i] = dest.format.ARGBToColor(0xff, srcPalette[i * 3], srcPalette[i * 3 + 1], srcPalette[i * 3 + 2]);
+		useMap = true;
+	} else if (src.format == dest.format && src.format.aBits() == 0 && (srcBpp == 2 || srcBpp == 4)) {
+		// Decoding and encoding the pixels only drops the unused bits
+		key = (srcBpp == 2) ? (uint16)transColor : transColor;
+		rgbMask = dest.format.ARGBToColor(0, 0xff, 0xff, 0xff);
+	} else {
+		return false;
+	}
+
+	const int left = MAX<int>(destRect.left, 0), right = MIN<int>(destRect.right, dest.w);
+	const int top = MAX<int>(destRect.top, 0), bottom = MIN<int>(destRect.bottom, dest.h);
+	if (left >= right || top >= bottom)
+		return true;
+
+	const uint width = right - left;
+	const uint height = bottom - top;
+	byte *destPtr = (byte *)dest.getBasePtr(left, top);
+
+	if (!flipped) {
+		const byte *srcPtr = (const byte *)src.getBasePtr(srcRect.left + left - destRect.left, srcRect.top + top - destRect.top);
+		if (useMap)
+			KeyBlit::blitMap(destPtr, srcPtr, dest.pitch, src.pitch, width, height, destBpp, map, key);
+		else
+			KeyBlit::blit(destPtr, srcPtr, dest.pitch, src.pitch, width, height, destBpp, key, rgbMask);
+		return true;
+	}
+
+	// Flipped rows are reversed into a temporary buffer first. Like in
+	// transBlit, they're mirrored around the full source width.
+	byte *row = (byte *)malloc(width * srcBpp);
+	const int first = src.w - (right - destRect.left);
+	for (uint y = 0; y < height; y++) {
+		const byte *srcPtr = (const byte *)src.getBasePtr(srcRect.left + first, srcRect.top + top - destRect.top + y);
+		if (srcBpp == 1)
+			reverseRow<uint8>(row, srcPtr, width);
+		else if (srcBpp == 2)
+			reverseRow<uint16>(row, srcPtr, width);
+		else
+			reverseRow<uint32>(row, srcPtr, width);
+
+		if (useMap)
+			KeyBlit::blitMap(destPtr, row, dest.pitch, width, width, 1, destBpp, map, key);
+		else
+			KeyBlit::blit(destPtr, row, dest.pitch, width * srcBpp, width, 1, destBpp, key, rgbMask);
+		destPtr += dest.pitch;
+	}
+	free(row);
+
+	return true;
+}
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly); \
@@ -712,16 +807,18 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
-	HANDLE_BLIT(1, 1, uint8,  uint8)
-	HANDLE_BLIT(1, 2, uint8,  uint16)
-	HANDLE_BLIT(1, 4, uint8,  uint32)
-	HANDLE_BLIT(2, 1, uint16, uint8)
-	HANDLE_BLIT(2, 2, uint16, uint16)
-	HANDLE_BLIT(2, 4, uint16, uint32)
-	HANDLE_BLIT(4, 1, uint32, uint8)
-	HANDLE_BLIT(4, 2, uint32, uint16)
-	HANDLE_BLIT(4, 4, uint32, uint32)
-	error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	if (!transBlitKeyed(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly)) {
+		HANDLE_BLIT(1, 1, uint8,  uint8)
+		HANDLE_BLIT(1, 2, uint8,  uint16)
+		HANDLE_BLIT(1, 4, uint8,  uint32)
+		HANDLE_BLIT(2, 1, uint16, uint8)
+		HANDLE_BLIT(2, 2, uint16, uint16)
+		HANDLE_BLIT(2, 4, uint16, uint32)
+		HANDLE_BLIT(4, 1, uint32, uint8)
+		HANDLE_BLIT(4, 2, uint32, uint16)
+		HANDLE_BLIT(4, 4, uint32, uint32)
+		error("Surface::transBlitFrom: bytesPerPixel must be 1, 2, or 4");
+	}
 
 	// Mark the affected area
 	addDirtyRect(destRect);
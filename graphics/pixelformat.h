@@ -53,7 +53,7 @@ struct ColorComponent<0> {
 template<>
 struct ColorComponent<1> {
 	static inline uint expand(uint value) {
-		return value ? 0xff : 0;
+		return (value & 1) ? 0xff : 0;
 	}
 };
 /** Template to expand a 2-bit component into an 8-bit component. */
@@ -20,6 +20,7 @@
 
 #include "graphics/svg.h"
 
+#include "common/array.h"
 #include "common/endian.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -37,17 +38,89 @@
 
 namespace Graphics {
 
-SVGBitmap::SVGBitmap(Common::SeekableReadStream *in, int dw, int dh)
-	: ManagedSurface(dw, dh, PIXELFORMAT) {
-	if (dw == 0 || dh == 0)
-		return;
+namespace {
+
+enum {
+	kMaxCachedDocuments = 32,
+	kMaxCachedBitmapBytes = 8 * 1024 * 1024
+};
+
+struct CachedDocument {
+	uint64 hash;
+	int64 size;
+	NSVGimage *image;
+	uint32 lastUse;
+};
+
+struct CachedBitmap {
+	NSVGimage *image;
+	int w, h;
+	Surface surface;
+	uint32 lastUse;
+};
+
+struct SVGCache {
+	Common::Array<CachedDocument> documents;
+	Common::Array<CachedBitmap> bitmaps;
+	uint32 bitmapBytes;
+	uint32 useCounter;
+	NSVGrasterizer *rasterizer;
+
+	SVGCache() : bitmapBytes(0), useCounter(0), rasterizer(nullptr) {}
+
+	~SVGCache() {
+		for (uint i = 0; i < bitmaps.size(); i++)
+			bitmaps[i].surface.free();
+		for (uint i = 0; i < documents.size(); i++)
+			nsvgDelete(documents[i].image);
+		if (rasterizer)
+			nsvgDeleteRasterizer(rasterizer);
+	}
 
+	void removeBitmap(uint index) {
+		bitmapBytes -= bitmaps[index].surface.pitch * bitmaps[index].surface.h;
+		bitmaps[index].surface.free();
+		bitmaps.remove_at(index);
+	}
+
+	void removeDocument(uint index) {
+		for (uint i = bitmaps.size(); i-- > 0; ) {
+			if (bitmaps[i].image == documents[index].image)
+				removeBitmap(i);
+		}
+		nsvgDelete(documents[index].image);
+		documents.remove_at(index);
+	}
+
+	NSVGimage *getDocument(Common::SeekableReadStream *in);
+	const Surface *getBitmap(NSVGimage *image, int w, int h);
+	void addBitmap(NSVGimage *image, const Surface &surface);
+};
+
+SVGCache *g_svgCache = nullptr;
+
+NSVGimage *SVGCache::getDocument(Common::SeekableReadStream *in) {
 	int64 size = in->size();
 	char *data = new char[size + 1];
 
 	in->read(data, size);
 	data[size] = '\0';
 
+	// 64-bit FNV-1a of the document
+	uint64 hash = 14695981039346656037ULL;
+	for (int64 i = 0; i < size; i++) {
+		hash ^= (byte)data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	for (uint i = 0; i < documents.size(); i++) {
+		if (documents[i].hash == hash && documents[i].size == size) {
+			delete[] data;
+			documents[i].lastUse = ++useCounter;
+			return documents[i].image;
+		}
+	}
+
 	NSVGimage *svg = nsvgParse(data, "px", 96);
 	if (svg == NULL)
 		error("Cannot parse SVG image");
@@ -55,17 +128,94 @@ SVGBitmap::SVGBitmap(Common::SeekableReadStream *in, int dw, int dh)
 	delete[] data;
 	data = nullptr;
 
+	// Drop the least recently used document, and the bitmaps rendered from it
+	if (documents.size() >= kMaxCachedDocuments) {
+		uint oldest = 0;
+		for (uint i = 1; i < documents.size(); i++) {
+			if (documents[i].lastUse < documents[oldest].lastUse)
+				oldest = i;
+		}
+		removeDocument(oldest);
+	}
+
+	CachedDocument document;
+	document.hash = hash;
+	document.size = size;
+	document.image = svg;
+	document.lastUse = ++useCounter;
+	documents.push_back(document);
+	return svg;
+}
+
+const Surface *SVGCache::getBitmap(NSVGimage *image, int w, int h) {
+	for (uint i = 0; i < bitmaps.size(); i++) {
+		if (bitmaps[i].image == image && bitmaps[i].w == w && bitmaps[i].h == h) {
+			bitmaps[i].lastUse = ++useCounter;
+			return &bitmaps[i].surface;
+		}
+	}
+	return nullptr;
+}
+
+void SVGCache::addBitmap(NSVGimage *image, const Surface &surface) {
+	const uint32 bytes = surface.pitch * surface.h;
+	if (bytes > kMaxCachedBitmapBytes / 4)
+		return;
+
+	// Drop the least recently used bitmaps until the new one fits
+	while (!bitmaps.empty() && bitmapBytes + bytes > kMaxCachedBitmapBytes) {
+		uint oldest = 0;
+		for (uint i = 1; i < bitmaps.size(); i++) {
+			if (bitmaps[i].lastUse < bitmaps[oldest].lastUse)
+				oldest = i;
+		}
+		removeBitmap(oldest);
+	}
+
+	bitmaps.push_back(CachedBitmap());
+	CachedBitmap &bitmap = bitmaps.back();
+	bitmap.image = image;
+	bitmap.w = surface.w;
+	bitmap.h = surface.h;
+	bitmap.surface.copyFrom(surface);
+	bitmap.lastUse = ++useCounter;
+	bitmapBytes += bytes;
+}
+
+} // end of anonymous namespace
+
+SVGBitmap::SVGBitmap(Common::SeekableReadStream *in, int dw, int dh)
+	: ManagedSurface(dw, dh, PIXELFORMAT) {
+	if (dw == 0 || dh == 0)
+		return;
+
+	if (!g_svgCache)
+		g_svgCache = new SVGCache();
+
+	NSVGimage *svg = g_svgCache->getDocument(in);
+
+	const Surface *cached = g_svgCache->getBitmap(svg, dw, dh);
+	if (cached) {
+		copyRectToSurface(*cached, 0, 0, Common::Rect(dw, dh));
+		return;
+	}
+
 	// Maintain aspect ratio
 	float xRatio = 1.0f * dw / svg->width;
 	float yRatio = 1.0f * dh / svg->height;
 	float ratio = xRatio < yRatio ? xRatio : yRatio;
 
-	NSVGrasterizer *rasterizer = nsvgCreateRasterizer();
+	if (!g_svgCache->rasterizer)
+		g_svgCache->rasterizer = nsvgCreateRasterizer();
 
-	nsvgRasterize(rasterizer, svg, 0, 0, ratio, (byte *)getPixels(), dw, dh, pitch);
+	nsvgRasterize(g_svgCache->rasterizer, svg, 0, 0, ratio, (byte *)getPixels(), dw, dh, pitch);
+
+	g_svgCache->addBitmap(svg, rawSurface());
+}
 
-	nsvgDeleteRasterizer(rasterizer);
-	nsvgDelete(svg);
+void SVGBitmap::clearCache() {
+	delete g_svgCache;
+	g_svgCache = nullptr;
 }
 
 } // end of namespace Graphics
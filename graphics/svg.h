@@ -31,10 +31,19 @@ namespace Graphics {
 
 /**
  * A derived graphics surface, which renders bitmap data from a SVG stream.
+ *
+ * Parsed documents are cached by their contents, and rendered bitmaps by
+ * their document and size, so that creating the same image again, or the
+ * same document at another size, does not parse or render it again.
  */
 class SVGBitmap : public ManagedSurface {
 public:
 	SVGBitmap(Common::SeekableReadStream *in, int dw, int dh);
+
+	/**
+	 * Release the cached documents and bitmaps.
+	 */
+	static void clearCache();
 };
 
 } // end of namespace Graphics
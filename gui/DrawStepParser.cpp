@@ -0,0 +1,473 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/DrawStepParser.h"
+
+#include "graphics/VectorRenderer.h"
+
+#include "common/textconsole.h"
+#include "common/tokenizer.h"
+
+namespace GUI {
+
+#define SCALEVALUE(val) (val > 0 ? val * _scaleFactor : val)
+#define FORCESCALEVALUE(val) (val * _scaleFactor)
+
+DrawStepParser::DrawStepParser() : XMLParser() {
+	_defaultStepGlobal = defaultDrawStep();
+	_defaultStepLocal = nullptr;
+
+	_baseWidth = _baseHeight = 0;
+	_scaleFactor = 1.0f;
+}
+
+DrawStepParser::~DrawStepParser() {
+	delete _defaultStepGlobal;
+	delete _defaultStepLocal;
+}
+
+void DrawStepParser::cleanup() {
+	delete _defaultStepGlobal;
+	delete _defaultStepLocal;
+
+	_defaultStepGlobal = defaultDrawStep();
+	_defaultStepLocal = nullptr;
+	_palette.clear();
+}
+
+Graphics::DrawStep *DrawStepParser::defaultDrawStep() {
+	Graphics::DrawStep *step = new Graphics::DrawStep;
+
+	step->xAlign = Graphics::DrawStep::kVectorAlignManual;
+	step->yAlign = Graphics::DrawStep::kVectorAlignManual;
+	step->factor = 1;
+	step->autoWidth = true;
+	step->autoHeight = true;
+	step->fillMode = Graphics::VectorRenderer::kFillDisabled;
+	step->scale = (1 << 16);
+	step->radius = 0xFF;
+	step->shadowIntensity = SCALEVALUE((1 << 16));
+
+	return step;
+}
+
+Graphics::DrawStep *DrawStepParser::newDrawStep() {
+	assert(_defaultStepGlobal);
+	Graphics::DrawStep *step = nullptr; //new DrawStep;
+
+	if (_defaultStepLocal) {
+		step = new Graphics::DrawStep(*_defaultStepLocal);
+	} else {
+		step = new Graphics::DrawStep(*_defaultStepGlobal);
+	}
+
+	return step;
+}
+
+bool DrawStepParser::parserCallback_defaults(ParserNode *node) {
+	ParserNode *parentNode = getParentNode(node);
+	Graphics::DrawStep *step = nullptr;
+
+	if (parentNode->name == "render_info") {
+		step = _defaultStepGlobal;
+	} else if (parentNode->name == "drawdata") {
+		if (_defaultStepLocal == nullptr)
+			_defaultStepLocal = new Graphics::DrawStep(*_defaultStepGlobal);
+
+		step = _defaultStepLocal;
+	} else {
+		return parserError("<default> key out of scope. Must be inside <drawdata> or <render_info> keys.");
+	}
+
+	return parseDrawStep(node, step, false);
+}
+
+bool DrawStepParser::parserCallback_palette(ParserNode *node) {
+	return true;
+}
+
+bool DrawStepParser::parserCallback_color(ParserNode *node) {
+	Common::String name = node->values["name"];
+
+	if (_palette.contains(name))
+		return parserError("Color '" + name + "' has already been defined.");
+
+	int red, green, blue;
+
+	if (parseIntegerKey(node->values["rgb"], 3, &red, &green, &blue) == false ||
+		red < 0 || red > 255 || green < 0 || green > 255 || blue < 0 || blue > 255)
+		return parserError("Error parsing RGB values for palette color '" + name + "'");
+
+	_palette[name].r = red;
+	_palette[name].g = green;
+	_palette[name].b = blue;
+
+	return true;
+}
+
+
+static Graphics::DrawingFunctionCallback getDrawingFunctionCallback(const Common::String &name) {
+
+	if (name == "circle")
+		return &Graphics::VectorRenderer::drawCallback_CIRCLE;
+	if (name == "square")
+		return &Graphics::VectorRenderer::drawCallback_SQUARE;
+	if (name == "roundedsq")
+		return &Graphics::VectorRenderer::drawCallback_ROUNDSQ;
+	if (name == "bevelsq")
+		return &Graphics::VectorRenderer::drawCallback_BEVELSQ;
+	if (name == "line")
+		return &Graphics::VectorRenderer::drawCallback_LINE;
+	if (name == "triangle")
+		return &Graphics::VectorRenderer::drawCallback_TRIANGLE;
+	if (name == "fill")
+		return &Graphics::VectorRenderer::drawCallback_FILLSURFACE;
+	if (name == "tab")
+		return &Graphics::VectorRenderer::drawCallback_TAB;
+	if (name == "void")
+		return &Graphics::VectorRenderer::drawCallback_VOID;
+	if (name == "bitmap")
+		return &Graphics::VectorRenderer::drawCallback_BITMAP;
+	if (name == "cross")
+		return &Graphics::VectorRenderer::drawCallback_CROSS;
+
+	return nullptr;
+}
+
+
+Graphics::DrawStep *DrawStepParser::createDrawStep(ParserNode *node) {
+	Graphics::DrawStep *drawstep = newDrawStep();
+
+	Common::String functionName = node->values["func"];
+
+	drawstep->drawingCall = getDrawingFunctionCallback(functionName);
+
+	if (drawstep->drawingCall == nullptr) {
+		delete drawstep;
+		parserError(functionName + " is not a valid drawing function name");
+		return nullptr;
+	}
+
+	if (!parseDrawStep(node, drawstep, true)) {
+		delete drawstep;
+		return nullptr;
+	}
+
+	return drawstep;
+}
+
+bool DrawStepParser::parseDrawStep(ParserNode *stepNode, Graphics::DrawStep *drawstep, bool functionSpecific) {
+	int red, green, blue, x;
+	Common::String val;
+
+/**
+ * Helper macro to sanitize and assign an integer value from a key
+ * to the draw step.
+ *
+ * @param struct_name Name of the field of a DrawStep struct that must be
+ *                    assigned.
+ * @param key_name Name as STRING of the key identifier as it appears in the
+ *                 theme description format.
+ * @param force Sets if the key is optional or necessary.
+ */
+#define PARSER_ASSIGN_INT(struct_name, key_name, force) \
+	if (stepNode->values.contains(key_name)) { \
+		if (!parseIntegerKey(stepNode->values[key_name], 1, &x)) \
+			return parserError("Error parsing key value for '" + Common::String(key_name) + "'."); \
+		\
+		drawstep->struct_name = x; \
+	} else if (force) { \
+		return parserError("Missing necessary key '" + Common::String(key_name) + "'."); \
+	}
+
+#define PARSER_ASSIGN_INT_SCALED(struct_name, key_name, force) \
+	PARSER_ASSIGN_INT(struct_name, key_name, force); \
+	drawstep->struct_name = SCALEVALUE(drawstep->struct_name);
+
+/**
+ * Helper macro to sanitize and assign a RGB value from a key to the draw
+ * step. RGB values have the following syntax: "R, G, B".
+ *
+ * @param struct_name Name of the field of a DrawStep struct that must be
+ *                    assigned.
+ * @param key_name Name as STRING of the key identifier as it appears in the
+ *                 theme description format.
+ */
+#define PARSER_ASSIGN_RGB(struct_name, key_name) \
+	if (stepNode->values.contains(key_name)) { \
+		val = stepNode->values[key_name]; \
+		if (_palette.contains(val)) { \
+			red = _palette[val].r; \
+			green = _palette[val].g; \
+			blue = _palette[val].b; \
+		} else if (parseIntegerKey(val, 3, &red, &green, &blue) == false || \
+			red < 0 || red > 255 || green < 0 || green > 255 || blue < 0 || blue > 255) \
+			return parserError("Error parsing color struct '" + val + "'");\
+		\
+		drawstep->struct_name.r = red; \
+		drawstep->struct_name.g = green; \
+		drawstep->struct_name.b = blue; \
+		drawstep->struct_name.set = true; \
+	}
+
+	PARSER_ASSIGN_INT_SCALED(stroke, "stroke", false);
+	PARSER_ASSIGN_INT_SCALED(bevel, "bevel", false);
+	PARSER_ASSIGN_INT_SCALED(shadow, "shadow", false);
+	PARSER_ASSIGN_INT(factor, "gradient_factor", false);
+
+	PARSER_ASSIGN_RGB(fgColor, "fg_color");
+	PARSER_ASSIGN_RGB(bgColor, "bg_color");
+	PARSER_ASSIGN_RGB(gradColor1, "gradient_start");
+	PARSER_ASSIGN_RGB(gradColor2, "gradient_end");
+	PARSER_ASSIGN_RGB(bevelColor, "bevel_color");
+
+	if (functionSpecific) {
+		assert(stepNode->values.contains("func"));
+		Common::String functionName = stepNode->values["func"];
+
+		if (functionName == "bitmap") {
+			if (!stepNode->values.contains("file"))
+				return parserError("Need to specify a filename for Bitmap blitting.");
+
+			drawstep->blitSrc = getImageSurface(stepNode->values["file"]);
+
+			if (!drawstep->blitSrc)
+				return parserError("The given filename hasn't been loaded into the GUI.");
+		}
+
+		if (functionName == "roundedsq" || functionName == "circle" || functionName == "tab") {
+			if (stepNode->values.contains("radius") && stepNode->values["radius"] == "auto") {
+				drawstep->radius = 0xFF;
+			} else {
+				PARSER_ASSIGN_INT_SCALED(radius, "radius", true);
+			}
+		}
+
+		if (functionName == "triangle") {
+			drawstep->extraData = Graphics::VectorRenderer::kTriangleUp;
+
+			if (stepNode->values.contains("orientation")) {
+				val = stepNode->values["orientation"];
+
+				if (val == "top")
+					drawstep->extraData = Graphics::VectorRenderer::kTriangleUp;
+				else if (val == "bottom")
+					drawstep->extraData = Graphics::VectorRenderer::kTriangleDown;
+				else if (val == "left")
+					drawstep->extraData = Graphics::VectorRenderer::kTriangleLeft;
+				else if (val == "right")
+					drawstep->extraData = Graphics::VectorRenderer::kTriangleRight;
+				else
+					return parserError("'" + val + "' is not a valid value for triangle orientation.");
+			}
+		}
+
+		if (stepNode->values.contains("size")) {
+			warning("The <size> keyword has been deprecated. Use <width> and <height> instead");
+		}
+
+		if (stepNode->values.contains("width") && stepNode->values["width"] != "auto") {
+			drawstep->autoWidth = false;
+
+			val = stepNode->values["width"];
+			if (parseIntegerKey(val, 1, &x))
+				drawstep->w = SCALEVALUE(x);
+			else if (val == "height")
+				drawstep->w = -1;
+			else return parserError("Invalid value for vector width.");
+
+			if (stepNode->values.contains("xpos")) {
+				val = stepNode->values["xpos"];
+
+				if (parseIntegerKey(val, 1, &x))
+					drawstep->x = SCALEVALUE(x);
+				else if (val == "center")
+					drawstep->xAlign = Graphics::DrawStep::kVectorAlignCenter;
+				else if (val == "left")
+					drawstep->xAlign = Graphics::DrawStep::kVectorAlignLeft;
+				else if (val == "right")
+					drawstep->xAlign = Graphics::DrawStep::kVectorAlignRight;
+				else
+					return parserError("Invalid value for X Position");
+			} else {
+				return parserError("When width is not set to 'auto', a <xpos> tag must be included.");
+			}
+		}
+
+		if (stepNode->values.contains("height") && stepNode->values["height"] != "auto") {
+			drawstep->autoHeight = false;
+
+			val = stepNode->values["height"];
+			if (parseIntegerKey(val, 1, &x))
+				drawstep->h = SCALEVALUE(x);
+			else if (val == "width")
+				drawstep->h = -1;
+			else return parserError("Invalid value for vector height.");
+
+			if (stepNode->values.contains("ypos")) {
+				val = stepNode->values["ypos"];
+
+				if (parseIntegerKey(val, 1, &x))
+					drawstep->y = SCALEVALUE(x);
+				else if (val == "center")
+					drawstep->yAlign = Graphics::DrawStep::kVectorAlignCenter;
+				else if (val == "top")
+					drawstep->yAlign = Graphics::DrawStep::kVectorAlignTop;
+				else if (val == "bottom")
+					drawstep->yAlign = Graphics::DrawStep::kVectorAlignBottom;
+				else
+					return parserError("Invalid value for Y Position");
+			} else {
+				return parserError("When height is not set to 'auto', a <ypos> tag must be included.");
+			}
+		}
+
+		if (drawstep->h == -1 && drawstep->w == -1)
+			return parserError("Cross-reference in Vector Size: Height is set to width and width is set to height.");
+	}
+
+	if (stepNode->values.contains("fill")) {
+		val = stepNode->values["fill"];
+		if (val == "none")
+			drawstep->fillMode = Graphics::VectorRenderer::kFillDisabled;
+		else if (val == "foreground")
+			drawstep->fillMode = Graphics::VectorRenderer::kFillForeground;
+		else if (val == "background")
+			drawstep->fillMode = Graphics::VectorRenderer::kFillBackground;
+		else if (val == "gradient")
+			drawstep->fillMode = Graphics::VectorRenderer::kFillGradient;
+		else
+			return parserError("'" + stepNode->values["fill"] + "' is not a valid fill mode for a shape.");
+	}
+
+	if (stepNode->values.contains("padding")) {
+		val = stepNode->values["padding"];
+		int pr, pt, pl, pb;
+		if (parseIntegerKey(val, 4, &pl, &pt, &pr, &pb)) {
+			drawstep->padding.left = SCALEVALUE(pl);
+			drawstep->padding.top = SCALEVALUE(pt);
+			drawstep->padding.right = SCALEVALUE(pr);
+			drawstep->padding.bottom = SCALEVALUE(pb);
+		}
+	}
+
+	if (stepNode->values.contains("clip")) {
+		val = stepNode->values["clip"];
+		int cl, ct, cr, cb;
+		if (parseIntegerKey(val, 4, &cl, &ct, &cr, &cb)) {
+			// Values could be less than 0 which is legit
+			drawstep->clip.left = FORCESCALEVALUE(cl);
+			drawstep->clip.top = FORCESCALEVALUE(ct);
+			drawstep->clip.right = FORCESCALEVALUE(cr);
+			drawstep->clip.bottom = FORCESCALEVALUE(cb);
+		}
+	}
+
+#undef PARSER_ASSIGN_INT
+#undef PARSER_ASSIGN_RGB
+
+	return true;
+}
+
+bool DrawStepParser::resolutionCheck(const Common::String &resolution) {
+	if (resolution.empty())
+		return true;
+
+	Common::StringTokenizer globTokenizer(resolution, ", ");
+	Common::String cur;
+
+	while (!globTokenizer.empty()) {
+		cur = globTokenizer.nextToken();
+
+		bool lt;
+		int val;
+
+		if (cur.size() < 3) {
+			warning("Invalid theme 'resolution' token '%s'", resolution.c_str());
+			return false;
+		}
+
+		if (cur[0] == 'x') {
+			val = _baseWidth;
+		} else if (cur[0] == 'y') {
+			val = _baseHeight;
+		} else {
+			warning("Error parsing theme 'resolution' token '%s'", resolution.c_str());
+			return false;
+		}
+
+		if (cur[1] == '<') {
+			lt = true;
+		} else if (cur[1] == '>') {
+			lt = false;
+		} else {
+			warning("Error parsing theme 'resolution' token '%s'", resolution.c_str());
+			return false;
+		}
+
+		bool eq = false;
+		int offset = 2;
+
+		if (cur[2] == '=') {
+			eq = true;
+			offset++;
+		}
+
+		int token;
+
+		if (cur[offset] == 'W') { // Reported threshold width
+			token = 320;
+		} else if (cur[offset] == 'H') { // Reported threshold height
+#ifndef IPHONE
+			token = 400;
+#else
+			// HACK. Think about API to move it to OSystem?
+			// iPhone SE (gen3) is 375 × 667 @2, iPhone 14 is 390 × 844 @3
+			//
+			// Hence, we are setting height to 375, so we have highres
+			// theme by default
+			token = 375;
+#endif
+		} else if (cur[offset] == 'x') {
+			token = _baseWidth;
+		} else if (cur[offset] == 'y') {
+			token = _baseHeight;
+		} else {
+			token = atoi(cur.c_str() + offset);
+		}
+
+		if (eq && val == token)
+			return true;
+
+		// check inverse for unfulfilled requirements
+		if (lt) {
+			if (val >= token)
+				return false;
+		} else {
+			if (val <= token)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_DRAWSTEP_PARSER_H
+#define GUI_DRAWSTEP_PARSER_H
+
+#include "common/scummsys.h"
+#include "common/formats/xmlparser.h"
+
+namespace Graphics {
+struct DrawStep;
+class ManagedSurface;
+}
+
+namespace GUI {
+
+/**
+ * Base of the theme parsers, handling the palette, the drawing step defaults
+ * and the drawing steps of a theme description. It does not depend on the
+ * ThemeEngine, so that the drawing steps can also be parsed without one.
+ * Derived classes provide the layout of the keys and store the steps.
+ */
+class DrawStepParser : public Common::XMLParser {
+public:
+	DrawStepParser();
+
+	~DrawStepParser() override;
+
+	void setBaseResolution(int w, int h, float s) {
+		_baseWidth = w;
+		_baseHeight = h;
+		_scaleFactor = s;
+	}
+
+	bool getPaletteColor(const Common::String &name, int &r, int &g, int &b) {
+		if (!_palette.contains(name))
+			return false;
+
+		r = _palette[name].r;
+		g = _palette[name].g;
+		b = _palette[name].b;
+
+		return true;
+	}
+
+protected:
+	bool parserCallback_defaults(ParserNode *node);
+	bool parserCallback_palette(ParserNode *node);
+	bool parserCallback_color(ParserNode *node);
+
+	/**
+	 * Create the drawing step of a drawstep key, starting from the current
+	 * defaults. Returns nullptr on a parser error.
+	 */
+	Graphics::DrawStep *createDrawStep(ParserNode *node);
+
+	/** Return the image blitted by bitmap steps, or nullptr if it is not loaded. */
+	virtual Graphics::ManagedSurface *getImageSurface(const Common::String &name) const { return nullptr; }
+
+	bool resolutionCheck(const Common::String &resolution);
+
+	void cleanup() override;
+
+	Graphics::DrawStep *newDrawStep();
+	Graphics::DrawStep *defaultDrawStep();
+	bool parseDrawStep(ParserNode *stepNode, Graphics::DrawStep *drawstep, bool functionSpecific);
+
+	Graphics::DrawStep *_defaultStepGlobal;
+	Graphics::DrawStep *_defaultStepLocal;
+
+	int16 _baseWidth, _baseHeight;
+	float _scaleFactor;
+
+	struct PaletteColor {
+		uint8 r, g, b;
+	};
+
+	Common::HashMap<Common::String, PaletteColor, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _palette;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -100,6 +100,25 @@ struct WidgetDrawData {
 	void calcBackgroundOffset();
 };
 
+/**
+ * A DrawData item drawn before, with the pixels and renderer colors it was
+ * drawn with. The drawing steps only depend on these, so drawing the same
+ * item over the same pixels again gives the same result, which is copied
+ * instead.
+ */
+struct CachedLayer {
+	const Graphics::ManagedSurface *surface;
+	DrawData type;
+	Common::Rect area;
+	Common::Rect clip;
+	uint32 dynamic;
+	Graphics::VectorRenderer::Colors colors;
+
+	Common::Rect rect;             ///< Area modified by drawing
+	Graphics::Surface background;  ///< Pixels of rect before drawing
+	Graphics::Surface result;      ///< Pixels of rect after drawing
+};
+
 /**********************************************************
  *  Data definitions for theme engine elements
  *********************************************************/
@@ -193,7 +212,7 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
 	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
-	_cursor(nullptr), _scaleFactor(1.0f) {
+	_cursor(nullptr), _scaleFactor(1.0f), _layerCacheSize(0) {
 
 	_baseWidth = 640;	// Default sane values
 	_baseHeight = 480;
@@ -249,6 +268,7 @@ ThemeEngine::~ThemeEngine() {
 	_screen.free();
 	_backBuffer.free();
 
+	clearLayerCache();
 	unloadTheme();
 	unloadExtraFont();
 
@@ -261,6 +281,7 @@ ThemeEngine::~ThemeEngine() {
 		}
 	}
 	_bitmaps.clear();
+	Graphics::SVGBitmap::clearCache();
 
 	delete _parser;
 	delete _themeEval;
@@ -470,6 +491,7 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	// list. Clearing it avoids invalid overlay writes when the backend
 	// resizes the overlay.
 	_dirtyScreen.clear();
+	clearLayerCache();
 }
 
 void WidgetDrawData::calcBackgroundOffset() {
@@ -788,6 +810,8 @@ void ThemeEngine::unloadTheme() {
 	if (!_themeOk)
 		return;
 
+	clearLayerCache();
+
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
 		_widgets[i] = nullptr;
@@ -947,15 +971,110 @@ void ThemeEngine::drawDD(DrawData type, const Common::Rect &r, uint32 dynamic, b
 		restoreBackground(extendedRect);
 
 	if (drawData->_layer == _layerToDraw) {
-		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
-			_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+		if (!drawCachedLayer(type, area, extendedRect, dynamic)) {
+			CachedLayer *layer = beginCachedLayer(type, area, extendedRect, dynamic);
+
+			Common::List<Graphics::DrawStep>::const_iterator step;
+			for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step) {
+				_vectorRenderer->drawStep(area, _clip, *step, dynamic);
+			}
+
+			if (layer)
+				cacheLayer(layer);
 		}
 
 		addDirtyRect(extendedRect);
 	}
 }
 
+bool ThemeEngine::drawCachedLayer(DrawData type, const Common::Rect &area, const Common::Rect &rect, uint32 dynamic) {
+	Graphics::ManagedSurface *surface = _vectorRenderer->getActiveSurface();
+	const Graphics::VectorRenderer::Colors colors = _vectorRenderer->getColors();
+
+	Common::List<CachedLayer *>::iterator it;
+	for (it = _layerCache.begin(); it != _layerCache.end(); ++it) {
+		const CachedLayer *layer = *it;
+		if (layer->surface == surface && layer->type == type && layer->area == area && layer->clip == _clip &&
+		        layer->dynamic == dynamic && layer->rect == rect && layer->colors == colors)
+			break;
+	}
+
+	if (it == _layerCache.end())
+		return false;
+
+	CachedLayer *layer = *it;
+	_layerCache.erase(it);
+
+	// The layer can only be reused when drawn over the same pixels
+	const uint rowSize = rect.width() * surface->format.bytesPerPixel;
+	for (int y = 0; y < rect.height(); ++y) {
+		if (memcmp(layer->background.getBasePtr(0, y), surface->getBasePtr(rect.left, rect.top + y), rowSize)) {
+			freeCachedLayer(layer);
+			return false;
+		}
+	}
+
+	surface->surfacePtr()->copyRectToSurface(layer->result, rect.left, rect.top, Common::Rect(rect.width(), rect.height()));
+
+	// Leave the renderer colors as drawing the steps would
+	const WidgetDrawData *drawData = _widgets[type];
+	Common::List<Graphics::DrawStep>::const_iterator step;
+	for (step = drawData->_steps.begin(); step != drawData->_steps.end(); ++step)
+		_vectorRenderer->setStepColors(*step);
+
+	// Keep the most recently used layers at the front
+	_layerCache.push_front(layer);
+	return true;
+}
+
+CachedLayer *ThemeEngine::beginCachedLayer(DrawData type, const Common::Rect &area, const Common::Rect &rect, uint32 dynamic) {
+	const Graphics::ManagedSurface *surface = _vectorRenderer->getActiveSurface();
+	if ((uint32)(rect.width() * rect.height() * surface->format.bytesPerPixel) > kMaxCachedLayerSize)
+		return nullptr;
+
+	CachedLayer *layer = new CachedLayer;
+	layer->surface = surface;
+	layer->type = type;
+	layer->area = area;
+	layer->clip = _clip;
+	layer->dynamic = dynamic;
+	layer->colors = _vectorRenderer->getColors();
+	layer->rect = rect;
+	layer->background.create(rect.width(), rect.height(), surface->format);
+	layer->background.copyRectToSurface(surface->rawSurface(), 0, 0, rect);
+	return layer;
+}
+
+void ThemeEngine::cacheLayer(CachedLayer *layer) {
+	const Graphics::ManagedSurface *surface = _vectorRenderer->getActiveSurface();
+
+	layer->result.create(layer->rect.width(), layer->rect.height(), surface->format);
+	layer->result.copyRectToSurface(surface->rawSurface(), 0, 0, layer->rect);
+
+	_layerCache.push_front(layer);
+	_layerCacheSize += layer->background.pitch * layer->background.h * 2;
+
+	// Drop the least recently used layers
+	while (_layerCacheSize > kLayerCacheSize) {
+		freeCachedLayer(_layerCache.back());
+		_layerCache.pop_back();
+	}
+}
+
+void ThemeEngine::freeCachedLayer(CachedLayer *layer) {
+	_layerCacheSize -= layer->background.pitch * layer->background.h * 2;
+	layer->background.free();
+	layer->result.free();
+	delete layer;
+}
+
+void ThemeEngine::clearLayerCache() {
+	for (Common::List<CachedLayer *>::iterator layer = _layerCache.begin(); layer != _layerCache.end(); ++layer)
+		freeCachedLayer(*layer);
+
+	_layerCache.clear();
+}
+
 void ThemeEngine::drawDDText(TextData type, TextColor color, const Common::Rect &r, const Common::U32String &text,
 	bool restoreBg, bool ellipsis, Graphics::TextAlign alignH, TextAlignVertical alignV,
 	int deltax, const Common::Rect &drawableTextArea) {
@@ -1540,7 +1659,28 @@ void ThemeEngine::updateDirtyScreen() {
 	if (_dirtyScreen.empty())
 		return;
 
-	Common::List<Common::Rect>::iterator i;
+	// Merge the rects for which the merged rect is not larger than both
+	// together. This avoids copying overlapping areas twice, and saves on
+	// overlay updates.
+	Common::List<Common::Rect>::iterator i, j;
+	bool merged;
+	do {
+		merged = false;
+		for (i = _dirtyScreen.begin(); i != _dirtyScreen.end(); ++i) {
+			for (j = i, ++j; j != _dirtyScreen.end();) {
+				Common::Rect rect = *i;
+				rect.extend(*j);
+				if (rect.width() * rect.height() <= i->width() * i->height() + j->width() * j->height()) {
+					*i = rect;
+					j = _dirtyScreen.erase(j);
+					merged = true;
+				} else {
+					++j;
+				}
+			}
+		}
+	} while (merged);
+
 	for (i = _dirtyScreen.begin(); i != _dirtyScreen.end(); ++i) {
 		_vectorRenderer->copyFrame(_system, *i);
 	}
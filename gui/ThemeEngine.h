@@ -36,7 +36,7 @@
 #include "graphics/pixelformat.h"
 
 
-#define SCUMMVM_THEME_VERSION_STR "SCUMMVM_STX0.9.12"
+#define SCUMMVM_THEME_VERSION_STR "SCUMMVM_STX0.9.13"
 
 class OSystem;
 
@@ -48,6 +48,7 @@ class VectorRenderer;
 namespace GUI {
 
 struct WidgetDrawData;
+struct CachedLayer;
 struct TextDrawData;
 struct TextColorData;
 class Dialog;
@@ -337,6 +338,11 @@ public:
 	/** Constant value to expand dirty rectangles, to make sure they are fully copied */
 	static const int kDirtyRectangleThreshold = 1;
 
+	enum {
+		kLayerCacheSize = 2 * 1024 * 1024,  ///< Maximal size of the cached DrawData layers, in bytes
+		kMaxCachedLayerSize = 256 * 1024    ///< Maximal size of a single cached DrawData layer, in bytes
+	};
+
 	struct Renderer {
 		const char *name;
 		const char *shortname;
@@ -695,10 +701,28 @@ protected:
 
 	/**
 	 * Dirty Screen handling function.
-	 * Draws all the dirty rectangles in the list to the overlay.
+	 * Merges the dirty rectangles where this does not increase the copied
+	 * area, and draws them to the overlay.
 	 */
 	void updateDirtyScreen();
 
+	/**
+	 * Draws a DrawData item from the layer cache, if it was drawn with the
+	 * same parameters over the same pixels before.
+	 *
+	 * @return true if the cached layer was drawn.
+	 */
+	bool drawCachedLayer(DrawData type, const Common::Rect &area, const Common::Rect &rect, uint32 dynamic);
+	void freeCachedLayer(CachedLayer *layer);
+
+	/**
+	 * Records the state before drawing a DrawData item, so that it can be
+	 * added to the layer cache with cacheLayer once drawn.
+	 */
+	CachedLayer *beginCachedLayer(DrawData type, const Common::Rect &area, const Common::Rect &rect, uint32 dynamic);
+	void cacheLayer(CachedLayer *layer);
+	void clearLayerCache();
+
 	/**
 	 * Draws a GUI element according to a DrawData descriptor.
 	 *
@@ -801,6 +825,10 @@ protected:
 	/** List of all the dirty screens that must be blitted to the overlay. */
 	Common::List<Common::Rect> _dirtyScreen;
 
+	/** Recently drawn DrawData items, the most recently used first. */
+	Common::List<CachedLayer *> _layerCache;
+	uint32 _layerCacheSize;
+
 	bool _initOk;  ///< Class and renderer properly initialized
 	bool _themeOk; ///< Theme data successfully loaded.
 	bool _enabled; ///< Whether the Theme is currently shown on the overlay
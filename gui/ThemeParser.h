@@ -25,33 +25,16 @@
 #include "common/scummsys.h"
 #include "common/formats/xmlparser.h"
 
+#include "gui/DrawStepParser.h"
+
 namespace GUI {
 
 class ThemeEngine;
 
-class ThemeParser : public Common::XMLParser {
+class ThemeParser : public DrawStepParser {
 public:
 	ThemeParser(ThemeEngine *parent);
 
-	~ThemeParser() override;
-
-	void setBaseResolution(int w, int h, float s) {
-		_baseWidth = w;
-		_baseHeight = h;
-		_scaleFactor = s;
-	}
-
-	bool getPaletteColor(const Common::String &name, int &r, int &g, int &b) {
-		if (!_palette.contains(name))
-			return false;
-
-		r = _palette[name].r;
-		g = _palette[name].g;
-		b = _palette[name].b;
-
-		return true;
-	}
-
 protected:
 	ThemeEngine *_theme;
 
@@ -234,14 +217,11 @@ protected:
 
 	/** Render info callbacks */
 	bool parserCallback_render_info(ParserNode *node);
-	bool parserCallback_defaults(ParserNode *node);
 	bool parserCallback_font(ParserNode *node);
 	bool parserCallback_text_color(ParserNode *node);
 	bool parserCallback_fonts(ParserNode *node);
 	bool parserCallback_language(ParserNode *node);
 	bool parserCallback_text(ParserNode *node);
-	bool parserCallback_palette(ParserNode *node);
-	bool parserCallback_color(ParserNode *node);
 	bool parserCallback_drawstep(ParserNode *node);
 	bool parserCallback_drawdata(ParserNode *node);
 	bool parserCallback_bitmaps(ParserNode *node) { return true; }
@@ -261,26 +241,9 @@ protected:
 
 	bool closedKeyCallback(ParserNode *node) override;
 
-	bool resolutionCheck(const Common::String &resolution);
+	Graphics::ManagedSurface *getImageSurface(const Common::String &name) const override;
 
-	void cleanup() override;
-
-	Graphics::DrawStep *newDrawStep();
-	Graphics::DrawStep *defaultDrawStep();
-	bool parseDrawStep(ParserNode *stepNode, Graphics::DrawStep *drawstep, bool functionSpecific);
 	bool parseCommonLayoutProps(ParserNode *node, const Common::String &var);
-
-	Graphics::DrawStep *_defaultStepGlobal;
-	Graphics::DrawStep *_defaultStepLocal;
-
-	int16 _baseWidth, _baseHeight;
-	float _scaleFactor;
-
-	struct PaletteColor {
-		uint8 r, g, b;
-	};
-
-	Common::HashMap<Common::String, PaletteColor, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> _palette;
 };
 
 } // End of namespace GUI
@@ -28,6 +28,9 @@
 #include "common/config-manager.h"
 #include "common/translation.h"
 #include "common/debug.h"
+#include "common/system.h"
+
+#include "audio/softsynth/fluidsynth.h"
 
 namespace GUI {
 
@@ -145,6 +148,10 @@ FluidSynthSettingsDialog::FluidSynthSettingsDialog()
 	_miscInterpolationPopUp->appendEntry(_("Fourth-order"), kInterpolation4thOrder);
 	_miscInterpolationPopUp->appendEntry(_("Seventh-order"), kInterpolation7thOrder);
 
+	_miscLoadDesc = new StaticTextWidget(_tabWidget, "FluidSynthSettings_Misc.LoadText", _("Load:"));
+	_miscLoadLabel = new StaticTextWidget(_tabWidget, "FluidSynthSettings_Misc.Load", Common::U32String());
+	_lastLoadUpdate = 0;
+
 	_tabWidget->setActiveTab(0);
 
 	new ButtonWidget(this, "FluidSynthSettings.ResetSettings", _("Reset"), _("Reset all FluidSynth settings to their default values."), kResetSettingsCmd);
@@ -163,6 +170,7 @@ void FluidSynthSettingsDialog::open() {
 	setResult(0);
 
 	readSettings();
+	updateLoad();
 }
 
 void FluidSynthSettingsDialog::close() {
@@ -224,6 +232,36 @@ void FluidSynthSettingsDialog::handleCommand(CommandSender *sender, uint32 cmd,
 	}
 }
 
+void FluidSynthSettingsDialog::handleTickle() {
+	// The load of a game playing in the background changes constantly, so
+	// only update it every now and then to keep it readable
+	if (g_system->getMillis() - _lastLoadUpdate >= 500)
+		updateLoad();
+
+	Dialog::handleTickle();
+}
+
+void FluidSynthSettingsDialog::updateLoad() {
+	_lastLoadUpdate = g_system->getMillis();
+
+	FluidSynth::Stats stats;
+	if (!FluidSynth::getStats(stats)) {
+		_miscLoadLabel->setLabel(_("Not playing"));
+		return;
+	}
+
+	Common::U32String load;
+	if (stats.activeVoices >= 0)
+		load = Common::U32String::format(_("%d of %d voices (peak %d)"), stats.activeVoices, stats.polyphony, stats.peakVoices);
+	else
+		load = Common::U32String::format(_("%d voices"), stats.polyphony);
+
+	if (stats.cpuLoad >= 0)
+		load += Common::U32String::format(_(", %d%% CPU"), stats.cpuLoad);
+
+	_miscLoadLabel->setLabel(load);
+}
+
 void FluidSynthSettingsDialog::setChorusSettingsState(bool enabled) {
 	_chorusVoiceCountDesc->setEnabled(enabled);
 	_chorusVoiceCountSlider->setEnabled(enabled);
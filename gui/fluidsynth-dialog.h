@@ -41,6 +41,7 @@ public:
 	void open() override;
 	void close() override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 
 protected:
 	void setChorusSettingsState(bool enabled);
@@ -51,6 +52,8 @@ protected:
 
 	void resetSettings();
 
+	void updateLoad();
+
 private:
 	Common::String _domain;
 
@@ -97,6 +100,10 @@ private:
 
 	StaticTextWidget *_miscInterpolationPopUpDesc;
 	PopUpWidget *_miscInterpolationPopUp;
+
+	StaticTextWidget *_miscLoadDesc;
+	StaticTextWidget *_miscLoadLabel;
+	uint32 _lastLoadUpdate;
 };
 
 } // End of namespace GUI
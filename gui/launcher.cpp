@@ -424,10 +424,12 @@ void LauncherDialog::massAddGame() {
 }
 
 Common::String LauncherDialog::getGameConfig(int item, Common::String key) {
-	if (ConfMan.hasKey(key, _domains[item])) {
-		return ConfMan.get(key, _domains[item]);
-	}
-	return "";
+	// This is called for every entry when filtering by a key, so look the domain up only once
+	const Common::ConfigManager::Domain *domain = ConfMan.getDomain(_domains[item]);
+	Common::String value;
+	if (domain)
+		domain->tryGetVal(key, value);
+	return value;
 }
 
 void LauncherDialog::removeGame(int item) {
@@ -1567,6 +1569,8 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	// The grid loads the thumbnails of the visible entries while idle
+	setTickleWidget(_grid);
 	// Populate the list
 	updateListing();
 
@@ -20,9 +20,13 @@
  */
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/language.h"
+#include "common/memstream.h"
 #include "common/platform.h"
+#include "common/substream.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 
@@ -341,56 +345,178 @@ void GridItemTray::handleMouseMoved(int x, int y, int button) {
 
 #pragma mark -
 
-// Load an image file by String name, provide additional render dimensions for SVG images.
-// TODO: Add BMP support, and add scaling of non-vector images.
-Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
+// Read an icon file into memory, so that it can be decoded without holding the icons set lock.
+static Common::SeekableReadStream *readIconFile(const Common::String &name) {
+	Common::SeekableReadStream *data = nullptr;
+	g_gui.lockIconsSet();
+	if (g_gui.getIconsSet().hasFile(name)) {
+		Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(name);
+		if (stream) {
+			data = stream->readStream(stream->size());
+			delete stream;
+		}
+	} else {
+		debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+	}
+	g_gui.unlockIconsSet();
+	return data;
+}
+
+// Decode an image by String name, provide additional render dimensions for SVG images.
+static Graphics::ManagedSurface *loadSurfaceFromStream(const Common::String &name, Common::SeekableReadStream &stream, int renderWidth = 0, int renderHeight = 0) {
 	Graphics::ManagedSurface *surf = nullptr;
 	if (name.hasSuffix(".png")) {
 #ifdef USE_PNG
-		const Graphics::Surface *srcSurface = nullptr;
 		Image::PNGDecoder decoder;
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(name)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(name);
-			if (!decoder.loadStream(*stream)) {
-				g_gui.unlockIconsSet();
-				warning("Error decoding PNG");
-				return surf;
-			}
+		if (!decoder.loadStream(stream)) {
+			warning("Error decoding PNG");
+			return surf;
+		}
 
-			srcSurface = decoder.getSurface();
-			delete stream;
-			if (!srcSurface) {
-				warning("Failed to load surface : %s", name.c_str());
-			} else if (srcSurface->format.bytesPerPixel != 1) {
-				surf = new Graphics::ManagedSurface(srcSurface);
-			}
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+		const Graphics::Surface *srcSurface = decoder.getSurface();
+		if (!srcSurface) {
+			warning("Failed to load surface : %s", name.c_str());
+		} else if (srcSurface->format.bytesPerPixel != 1) {
+			surf = new Graphics::ManagedSurface(srcSurface);
 		}
-		g_gui.unlockIconsSet();
 #else
 		error("No PNG support compiled");
 #endif
 	} else if (name.hasSuffix(".svg")) {
-		g_gui.lockIconsSet();
-		if (g_gui.getIconsSet().hasFile(name)) {
-			Common::SeekableReadStream *stream = g_gui.getIconsSet().createReadStreamForMember(name);
-			surf = new Graphics::SVGBitmap(stream, renderWidth, renderHeight);
-			delete stream;
-		} else {
-			debug(5, "GridWidget: Cannot read file '%s'", name.c_str());
+		surf = new Graphics::SVGBitmap(&stream, renderWidth, renderHeight);
+	}
+	return surf;
+}
+
+// Load an image file by String name, provide additional render dimensions for SVG images.
+// TODO: Add BMP support, and add scaling of non-vector images.
+Graphics::ManagedSurface *loadSurfaceFromFile(const Common::String &name, int renderWidth = 0, int renderHeight = 0) {
+	Common::SeekableReadStream *stream = readIconFile(name);
+	if (!stream)
+		return nullptr;
+
+	Graphics::ManagedSurface *surf = loadSurfaceFromStream(name, *stream, renderWidth, renderHeight);
+	delete stream;
+	return surf;
+}
+
+#ifdef USE_PNG
+// The scaled thumbnails are stored in the thumbnails directory of the save
+// path. The icon packs don't provide modification times, so an entry is keyed
+// by the path and size of the icon file and by the thumbnail size. The entries
+// are spread over a fixed number of files, each replacing the entry hashed to
+// the same file before, and large thumbnails are not stored, which bounds the
+// size of the cache on disk.
+enum {
+	kThumbnailCacheFiles = 512,
+	kThumbnailCacheMaxFileSize = 64 * 1024
+};
+
+static Common::String getThumbnailCacheName(const Common::String &key) {
+	uint32 hash = 2166136261U;
+	for (uint i = 0; i < key.size(); i++) {
+		hash ^= (byte)key[i];
+		hash *= 16777619;
+	}
+	return Common::String::format("thumb-%03u.dat", hash % kThumbnailCacheFiles);
+}
+
+static Graphics::ManagedSurface *readCachedThumbnail(const Common::FSNode &dir, const Common::String &key) {
+	if (!dir.isDirectory())
+		return nullptr;
+
+	const Common::FSNode file = dir.getChild(getThumbnailCacheName(key));
+	if (!file.exists())
+		return nullptr;
+
+	Common::SeekableReadStream *stream = file.createReadStream();
+	if (!stream)
+		return nullptr;
+
+	Graphics::ManagedSurface *surf = nullptr;
+	if (stream->readUint32BE() == MKTAG('T', 'H', 'M', 'B') && stream->readUint16BE() == key.size()) {
+		Common::String fileKey = stream->readString(0, key.size());
+		if (!stream->err() && fileKey == key) {
+			Common::SeekableSubReadStream png(stream, stream->pos(), stream->size());
+			surf = loadSurfaceFromStream("thumbnail.png", png);
 		}
-		g_gui.unlockIconsSet();
 	}
+	delete stream;
 	return surf;
 }
 
+static void writeCachedThumbnail(const Common::FSNode &dir, const Common::String &key, const Graphics::ManagedSurface &surf) {
+	Common::MemoryWriteStreamDynamic png(DisposeAfterUse::YES);
+	if (!Image::writePNG(png, surf.rawSurface()) || png.size() > kThumbnailCacheMaxFileSize)
+		return;
+
+	if (!dir.exists() && !dir.createDirectory()) {
+		debug(5, "GridWidget: Cannot create the thumbnail cache");
+		return;
+	}
+
+	const Common::String name = getThumbnailCacheName(key);
+	Common::WriteStream *out = dir.getChild(name).createWriteStream();
+	if (!out) {
+		debug(5, "GridWidget: Cannot write thumbnail '%s'", name.c_str());
+		return;
+	}
+	out->writeUint32BE(MKTAG('T', 'H', 'M', 'B'));
+	out->writeUint16BE(key.size());
+	out->writeString(key);
+	out->write(png.getData(), png.size());
+	out->finalize();
+	delete out;
+}
+#endif
+
+// Load an image file and scale it to fit the given size, going through the
+// thumbnail cache when there is a save path.
+static const Graphics::ManagedSurface *loadScaledSurfaceFromFile(const Common::String &name, int width, int height) {
+	Common::SeekableReadStream *stream = readIconFile(name);
+	if (!stream)
+		return nullptr;
+
+#ifdef USE_PNG
+	const Common::String savePath = ConfMan.get("savepath");
+	const Common::String key = Common::String::format("%s:%u:%dx%d", name.c_str(), (uint)stream->size(), width, height);
+	Common::FSNode cacheDir;
+	if (!savePath.empty()) {
+		cacheDir = Common::FSNode(savePath).getChild("thumbnails");
+		Graphics::ManagedSurface *surf = readCachedThumbnail(cacheDir, key);
+		if (surf) {
+			delete stream;
+			return surf;
+		}
+	}
+#endif
+
+	Graphics::ManagedSurface *surf = loadSurfaceFromStream(name, *stream);
+	delete stream;
+	if (!surf)
+		return nullptr;
+
+	const Graphics::ManagedSurface *scSurf = scaleGfx(surf, width, height, true);
+	if (surf != scSurf) {
+		surf->free();
+		delete surf;
+	}
+
+#ifdef USE_PNG
+	if (!savePath.empty())
+		writeCachedThumbnail(cacheDir, key, *scSurf);
+#endif
+
+	return scSurf;
+}
+
 #pragma mark -
 
 GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	: ContainerWidget(boss, name), CommandSender(boss) {
 
+	setFlags(WIDGET_WANT_TICKLE);
+
 	_thumbnailHeight = 0;
 	_thumbnailWidth = 0;
 	_flagIconHeight = 0;
@@ -400,6 +526,7 @@ GridWidget::GridWidget(GuiObject *boss, const Common::String &name)
 	_extraIconHeight = 0;
 	_extraIconWidth = 0;
 	_disabledIconOverlay = nullptr;
+	_thumbnailUseCounter = 0;
 
 	_minGridXSpacing = 0;
 	_minGridYSpacing = 0;
@@ -439,7 +566,7 @@ GridWidget::~GridWidget() {
 	unloadSurfaces(_platformIcons);
 	unloadSurfaces(_languageIcons);
 	unloadSurfaces(_extraIcons);
-	unloadSurfaces(_loadedSurfaces);
+	unloadThumbnails();
 	delete _disabledIconOverlay;
 	_gridItems.clear();
 	_dataEntryList.clear();
@@ -456,27 +583,47 @@ void GridWidget::unloadSurfaces(Common::HashMap<T, const Graphics::ManagedSurfac
 	surfaces.clear();
 }
 
+void GridWidget::unloadThumbnails() {
+	for (Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.begin(); i != _loadedSurfaces.end(); ++i) {
+		delete i->_value.surface;
+	}
+	_loadedSurfaces.clear();
+	_pendingThumbnails.clear();
+}
+
 const Graphics::ManagedSurface *GridWidget::filenameToSurface(const Common::String &name) {
 	if (name.empty())
 		return nullptr;
-	return _loadedSurfaces[name];
+
+	Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.find(name);
+	if (i == _loadedSurfaces.end())
+		return nullptr;
+
+	i->_value.lastUse = _thumbnailUseCounter;
+	return i->_value.surface;
 }
 
 const Graphics::ManagedSurface *GridWidget::languageToSurface(Common::Language languageCode) {
 	if (languageCode == Common::UNK_LANG)
 		return nullptr;
+	if (!_languageIcons.contains(languageCode))
+		return loadFlagIcon(languageCode);
 	return _languageIcons[languageCode];
 }
 
 const Graphics::ManagedSurface *GridWidget::platformToSurface(Common::Platform platformCode) {
 	if (platformCode == Common::kPlatformUnknown)
 		return nullptr;
+	if (!_platformIcons.contains(platformCode))
+		return loadPlatformIcon(platformCode);
 	return _platformIcons[platformCode];
 }
 
 const Graphics::ManagedSurface *GridWidget::demoToSurface(const Common::String extraString) {
 	if (! extraString.contains("Demo") )
 		return nullptr;
+	if (!_extraIcons.contains(0))
+		return loadExtraIcons();
 	return _extraIcons[0];
 }
 
@@ -489,6 +636,7 @@ void GridWidget::setEntryList(Common::Array<GridItemInfo> *list) {
 	_headerEntryList.clear();
 	_sortedEntryList.clear();
 	_visibleEntryList.clear();
+	_pendingThumbnails.clear();
 	_isGridInvalid = true;
 	_selectedEntry = nullptr;
 
@@ -682,91 +830,149 @@ void GridWidget::setGroupHeaderFormat(const Common::U32String &prefix, const Com
 }
 
 void GridWidget::reloadThumbnails() {
-	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
-	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+	// Only the thumbnails of the visible entries are loaded, in handleTickle().
+	// Until then, the items show the titles instead.
+	_pendingThumbnails.clear();
+	_thumbnailUseCounter++;
+
 	for (Common::Array<GridItemInfo *>::iterator iter = _visibleEntryList.begin(); iter != _visibleEntryList.end(); ++iter) {
 		GridItemInfo *entry = *iter;
 		if (entry->thumbPath.empty())
 			continue;
 
-		if (!_loadedSurfaces.contains(entry->thumbPath)) {
-			_loadedSurfaces[entry->thumbPath] = nullptr;
-			Common::String path = Common::String::format("icons/%s-%s.png", entry->engineid.c_str(), entry->gameid.c_str());
-			Graphics::ManagedSurface *surf = loadSurfaceFromFile(path);
-			if (!surf) {
-				path = Common::String::format("icons/%s.png", entry->engineid.c_str());
-				if (!_loadedSurfaces.contains(path)) {
-					surf = loadSurfaceFromFile(path);
-				} else {
-					const Graphics::ManagedSurface *scSurf = _loadedSurfaces[path];
-					_loadedSurfaces[entry->thumbPath] = new Graphics::ManagedSurface(*scSurf);
-				}
-			}
+		Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.find(entry->thumbPath);
+		if (i != _loadedSurfaces.end())
+			i->_value.lastUse = _thumbnailUseCounter;
+		else
+			_pendingThumbnails.push_back(entry);
+	}
 
-			if (surf) {
-				const Graphics::ManagedSurface *scSurf(scaleGfx(surf, thumbnailWidth, thumbnailHeight, true));
-				_loadedSurfaces[entry->thumbPath] = scSurf;
+	purgeThumbnails();
+}
 
-				if (path != entry->thumbPath) {
-					_loadedSurfaces[path] = new Graphics::ManagedSurface(*scSurf);
-				}
+void GridWidget::loadThumbnail(const GridItemInfo *entry) {
+	if (_loadedSurfaces.contains(entry->thumbPath))
+		return;
 
-				if (surf != scSurf) {
-					surf->free();
-					delete surf;
-				}
-			}
+	const int thumbnailWidth = MAX(_thumbnailWidth - 2 * _thumbnailMargin, 0);
+	const int thumbnailHeight = MAX(_thumbnailHeight - 2 * _thumbnailMargin, 0);
+
+	const Graphics::ManagedSurface *surf = loadScaledSurfaceFromFile(entry->thumbPath, thumbnailWidth, thumbnailHeight);
+	if (!surf) {
+		// Fall back to the engine icon
+		Common::String path = Common::String::format("icons/%s.png", entry->engineid.c_str());
+		Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.find(path);
+		if (i != _loadedSurfaces.end()) {
+			if (i->_value.surface)
+				surf = new Graphics::ManagedSurface(*i->_value.surface);
+		} else {
+			surf = loadScaledSurfaceFromFile(path, thumbnailWidth, thumbnailHeight);
+			LoadedThumbnail &engineIcon = _loadedSurfaces[path];
+			engineIcon.surface = surf ? new Graphics::ManagedSurface(*surf) : nullptr;
+			engineIcon.lastUse = _thumbnailUseCounter;
 		}
 	}
+
+	LoadedThumbnail &thumbnail = _loadedSurfaces[entry->thumbPath];
+	thumbnail.surface = surf;
+	thumbnail.lastUse = _thumbnailUseCounter;
 }
 
-void GridWidget::loadFlagIcons() {
-	const Common::LanguageDescription *l = Common::g_languages;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/flags/%s.svg", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
-		if (gfx) {
-			_languageIcons[l->id] = gfx;
-			continue;
-		} // if no .svg flag is available, search for a .png
-		path = Common::String::format("icons/flags/%s.png", l->code);
-		gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
-			_languageIcons[l->id] = scGfx;
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_languageIcons[l->id] = nullptr; // nothing found, set to nullptr
+void GridWidget::purgeThumbnails() {
+	// Keep the thumbnails of the visible entries, and of a few more pages
+	const uint cacheSize = MAX<uint>(kThumbnailCacheSize, 2 * _visibleEntryList.size());
+	if (_loadedSurfaces.size() <= cacheSize)
+		return;
+
+	// Unload the least recently used thumbnails
+	Common::Array<uint32> uses;
+	uses.reserve(_loadedSurfaces.size());
+	for (Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.begin(); i != _loadedSurfaces.end(); ++i)
+		uses.push_back(i->_value.lastUse);
+	Common::sort(uses.begin(), uses.end());
+	const uint32 oldestKept = uses[uses.size() - cacheSize];
+
+	Common::Array<Common::String> unused;
+	for (Common::HashMap<Common::String, LoadedThumbnail>::iterator i = _loadedSurfaces.begin(); i != _loadedSurfaces.end(); ++i) {
+		if (i->_value.lastUse < oldestKept)
+			unused.push_back(i->_key);
+	}
+
+	for (uint i = 0; i < unused.size(); ++i) {
+		delete _loadedSurfaces[unused[i]].surface;
+		_loadedSurfaces.erase(unused[i]);
+	}
+}
+
+void GridWidget::handleTickle() {
+	if (_pendingThumbnails.empty())
+		return;
+
+	const uint32 start = g_system->getMillis();
+
+	while (!_pendingThumbnails.empty() && (g_system->getMillis() - start) < kMaxThumbnailLoadTime) {
+		GridItemInfo *entry = _pendingThumbnails.remove_at(0);
+		loadThumbnail(entry);
+
+		// Replace the title of the item by the thumbnail
+		for (uint k = 0; k < _visibleEntryList.size() && k < _gridItems.size(); ++k) {
+			if (_visibleEntryList[k]->thumbPath == entry->thumbPath)
+				_gridItems[k]->update();
 		}
 	}
 }
 
-void GridWidget::loadPlatformIcons() {
-	const Common::PlatformDescription *l = Common::g_platforms;
-	for (; l->code; ++l) {
-		Common::String path = Common::String::format("icons/platforms/%s.png", l->code);
-		Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
-		if (gfx) {
-			const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
-			_platformIcons[l->id] = scGfx;
-			if (gfx != scGfx) {
-				gfx->free();
-				delete gfx;
-			}
-		} else {
-			_platformIcons[l->id] = nullptr;
+const Graphics::ManagedSurface *GridWidget::loadFlagIcon(Common::Language languageCode) {
+	const char *code = Common::getLanguageCode(languageCode);
+	if (!code)
+		return nullptr;
+
+	Common::String path = Common::String::format("icons/flags/%s.svg", code);
+	Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path, _flagIconWidth, _flagIconHeight);
+	if (gfx) {
+		_languageIcons[languageCode] = gfx;
+		return gfx;
+	} // if no .svg flag is available, search for a .png
+	path = Common::String::format("icons/flags/%s.png", code);
+	gfx = loadSurfaceFromFile(path);
+	if (gfx) {
+		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _flagIconWidth, _flagIconHeight, true);
+		_languageIcons[languageCode] = scGfx;
+		if (gfx != scGfx) {
+			gfx->free();
+			delete gfx;
+		}
+	} else {
+		_languageIcons[languageCode] = nullptr; // nothing found, set to nullptr
+	}
+	return _languageIcons[languageCode];
+}
+
+const Graphics::ManagedSurface *GridWidget::loadPlatformIcon(Common::Platform platformCode) {
+	const char *code = Common::getPlatformCode(platformCode);
+	if (!code)
+		return nullptr;
+
+	Common::String path = Common::String::format("icons/platforms/%s.png", code);
+	Graphics::ManagedSurface *gfx = loadSurfaceFromFile(path);
+	if (gfx) {
+		const Graphics::ManagedSurface *scGfx = scaleGfx(gfx, _platformIconWidth, _platformIconHeight, true);
+		_platformIcons[platformCode] = scGfx;
+		if (gfx != scGfx) {
+			gfx->free();
+			delete gfx;
 		}
+	} else {
+		_platformIcons[platformCode] = nullptr;
 	}
+	return _platformIcons[platformCode];
 }
 
-void GridWidget::loadExtraIcons() {  // for now only the demo icon is available
+const Graphics::ManagedSurface *GridWidget::loadExtraIcons() {  // for now only the demo icon is available
 	Graphics::ManagedSurface *gfx = loadSurfaceFromFile("icons/extra/demo.svg", _extraIconWidth, _extraIconHeight);
 	if (gfx) {
 		_extraIcons[0] = gfx;
-		return;
+		return gfx;
 	} // if no .svg file is available, search for a .png
 	gfx = loadSurfaceFromFile("icons/extra/demo.png");
 	if (gfx) {
@@ -779,6 +985,7 @@ void GridWidget::loadExtraIcons() {  // for now only the demo icon is available
 	} else {
 		_extraIcons[0] = nullptr;
 	}
+	return _extraIcons[0];
 }
 
 void GridWidget::destroyItems() {
@@ -1007,16 +1214,14 @@ void GridWidget::reflowLayout() {
 	if ((oldThumbnailHeight != _thumbnailHeight) ||
 		(oldThumbnailWidth != _thumbnailWidth) ||
 		(oldThumbnailMargin != _thumbnailMargin)) {
+		// The icons and thumbnails are loaded again when they are drawn
 		unloadSurfaces(_extraIcons);
 		unloadSurfaces(_platformIcons);
 		unloadSurfaces(_languageIcons);
-		unloadSurfaces(_loadedSurfaces);
+		unloadThumbnails();
+		markGridAsInvalid();
 		if (_disabledIconOverlay)
 			_disabledIconOverlay->free();
-		reloadThumbnails();
-		loadFlagIcons();
-		loadPlatformIcons();
-		loadExtraIcons();
 
 		Graphics::ManagedSurface *gfx = new Graphics::ManagedSurface(_thumbnailWidth, _thumbnailHeight, g_system->getOverlayFormat());
 		uint32 disabledThumbnailColor = gfx->format.ARGBToColor(153, 0, 0, 0);  // 60% opacity black
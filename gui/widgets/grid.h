@@ -98,12 +98,29 @@ public:
 /* GridWidget */
 class GridWidget : public ContainerWidget, public CommandSender {
 protected:
+	enum {
+		// Minimum number of thumbnails kept in memory
+		kThumbnailCacheSize = 256,
+		// Upper bound (in milliseconds) we want to spend loading thumbnails in handleTickle
+		kMaxThumbnailLoadTime = 20
+	};
+
+	struct LoadedThumbnail {
+		const Graphics::ManagedSurface *surface;
+		uint32 lastUse;
+	};
+
+	// The icons are loaded when they are first drawn
 	Common::HashMap<int, const Graphics::ManagedSurface *> _platformIcons;
 	Common::HashMap<int, const Graphics::ManagedSurface *> _languageIcons;
 	Common::HashMap<int, const Graphics::ManagedSurface *> _extraIcons;
 	Graphics::ManagedSurface *_disabledIconOverlay;
-	// Images are mapped by filename -> surface.
-	Common::HashMap<Common::String, const Graphics::ManagedSurface *> _loadedSurfaces;
+	// Scaled thumbnails are mapped by filename -> surface. The least recently
+	// used ones are unloaded when there are too many of them.
+	Common::HashMap<Common::String, LoadedThumbnail> _loadedSurfaces;
+	uint32 _thumbnailUseCounter;
+	// Visible entries whose thumbnails are loaded in handleTickle()
+	Common::Array<GridItemInfo *> _pendingThumbnails;
 
 	Common::Array<GridItemInfo>			_dataEntryList;
 	Common::Array<GridItemInfo>			_headerEntryList;
@@ -194,9 +211,12 @@ public:
 	void saveClosedGroups(const Common::U32String &groupName);
 
 	void reloadThumbnails();
-	void loadFlagIcons();
-	void loadPlatformIcons();
-	void loadExtraIcons();
+	void loadThumbnail(const GridItemInfo *entry);
+	void unloadThumbnails();
+	void purgeThumbnails();
+	const Graphics::ManagedSurface *loadFlagIcon(Common::Language languageCode);
+	const Graphics::ManagedSurface *loadPlatformIcon(Common::Platform platformCode);
+	const Graphics::ManagedSurface *loadExtraIcons();
 
 	void destroyItems();
 	void calcInnerHeight();
@@ -213,6 +233,7 @@ public:
 
 	void handleMouseWheel(int x, int y, int direction) override;
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data) override;
+	void handleTickle() override;
 	void reflowLayout() override;
 
 	bool wantsFocus() override { return true; }
@@ -88,18 +88,27 @@ void GroupedListWidget::groupByAttribute() {
 	}
 
 	for (uint i = 0; i < _dataList.size(); ++i) {
-		Common::U32StringArray::iterator attrVal = _attributeValues.begin() + i;
-		if (!_groupValueIndex.contains(*attrVal)) {
-			int newGroupID = _groupValueIndex.size();
-			_groupValueIndex.setVal(*attrVal, newGroupID);
-			_groupHeaders.push_back(*attrVal);
-			_groupExpanded.push_back(true);
+		if (!_groupValueIndex.contains(_attributeValues[i])) {
+			_groupValueIndex.setVal(_attributeValues[i], 0);
+			_groupHeaders.push_back(_attributeValues[i]);
 		}
-		int groupID = _groupValueIndex.getVal(*attrVal);
+	}
+
+	// Sort the groups once here, so that the group IDs match the display order
+	Common::sort(_groupHeaders.begin(), _groupHeaders.end(),
+		[](const Common::U32String &first, const Common::U32String &second) {
+			return first.empty() ? 0 : second.empty() ? 1 : first < second;
+		}
+	);
 
-		_itemsInGroup[groupID].push_back(i);
+	for (uint i = 0; i < _groupHeaders.size(); ++i) {
+		_groupValueIndex.setVal(_groupHeaders[i], i);
+		_groupExpanded.push_back(true);
 	}
 
+	for (uint i = 0; i < _dataList.size(); ++i)
+		_itemsInGroup[_groupValueIndex.getVal(_attributeValues[i])].push_back(i);
+
 	sortGroups();
 }
 
@@ -108,22 +117,16 @@ void GroupedListWidget::sortGroups() {
 	_list.clear();
 	_listIndex.clear();
 
-	Common::sort(_groupHeaders.begin(), _groupHeaders.end(),
-		[](const Common::String &first, const Common::String &second) {
-			return first.empty() ? 0 : second.empty() ? 1 : first < second;
-		}
-
-	);
-
-	for (uint i = 0; i != _groupHeaders.size(); ++i) {
-		Common::U32String header = _groupHeaders[i];
+	// The groups are already sorted by groupByAttribute()
+	for (uint groupID = 0; groupID != _groupHeaders.size(); ++groupID) {
+		const Common::U32String &header = _groupHeaders[groupID];
 		Common::U32String displayedHeader;
-		if (_metadataNames.contains(header)) {
-			displayedHeader = _metadataNames[header];
+		Common::String metadataName;
+		if (_metadataNames.tryGetVal(header, metadataName)) {
+			displayedHeader = metadataName;
 		} else {
 			displayedHeader = header;
 		}
-		uint groupID = _groupValueIndex[header];
 
 		if (_groupsVisible) {
 			_listIndex.push_back(kGroupTag - groupID);
@@ -168,7 +171,9 @@ void GroupedListWidget::loadClosedGroups(const Common::U32String &groupName) {
 				}
 			}
 		}
-		sortGroups();
+		// Keep the search results, the closed groups are applied once the filter is cleared
+		if (_filter.empty())
+			sortGroups();
 	}
 }
 
@@ -395,39 +400,14 @@ void GroupedListWidget::setFilter(const Common::U32String &filter, bool redraw)
 	if (_filter == filt) // Filter was not changed
 		return;
 
+	const bool narrowing = isNarrowingFilter(filt);
 	_filter = filt;
 
 	if (_filter.empty()) {
 		// No filter -> display everything
 		sortGroups();
 	} else {
-		// Restrict the list to everything which contains all words in _filter
-		// as substrings, ignoring case.
-
-		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
-
-		_list.clear();
-		_listIndex.clear();
-
-		for (auto i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = i->clean;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
-
-			if (matches) {
-				_list.push_back(i->orig);
-				_listIndex.push_back(n);
-			}
-		}
+		applyFilter(narrowing);
 	}
 
 	_currentPos = 0;
@@ -216,7 +216,12 @@ void ListWidget::append(const Common::String &s) {
 	_cleanedList.push_back(stripped);
 	_list.push_back(s);
 
-	setFilter(_filter, false);
+	if (!_filter.empty()) {
+		// The filter did not change, so force re-filtering the whole list
+		Common::U32String filter = _filter;
+		_filter.clear();
+		setFilter(filter, false);
+	}
 
 	scrollBarRecalc();
 }
@@ -750,6 +755,7 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 	if (_filter == filt) // Filter was not changed
 		return;
 
+	const bool narrowing = isNarrowingFilter(filt);
 	_filter = filt;
 
 	if (_filter.empty()) {
@@ -762,32 +768,7 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 
 		_listIndex.clear();
 	} else {
-		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
-
-		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
-
-		_list.clear();
-		_listIndex.clear();
-
-		for (auto i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = i->clean;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
-
-			if (matches) {
-				_list.push_back(i->orig);
-				_listIndex.push_back(n);
-			}
-		}
+		applyFilter(narrowing);
 	}
 
 	_currentPos = 0;
@@ -810,6 +791,55 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 	}
 }
 
+bool ListWidget::isNarrowingFilter(const Common::U32String &filter) const {
+	if (_filter.empty() || filter.size() < _filter.size())
+		return false;
+
+	for (uint i = 0; i < filter.size(); ++i) {
+		if (i < _filter.size() && filter[i] != _filter[i])
+			return false;
+		if (filter[i] == '!' || filter[i] == ':' || filter[i] == '=' || filter[i] == '~')
+			return false;
+	}
+
+	return true;
+}
+
+void ListWidget::applyFilter(bool narrowing) {
+	// Restrict the list to everything which matches all tokens in _filter, ignoring case.
+	// When narrowing down the previous filter, only its matches need to be checked.
+	Common::Array<int> candidates;
+	if (narrowing)
+		candidates = _listIndex;
+
+	Common::U32StringTokenizer tok(_filter);
+	const uint count = narrowing ? candidates.size() : _dataList.size();
+
+	_list.clear();
+	_listIndex.clear();
+
+	for (uint i = 0; i < count; ++i) {
+		const int n = narrowing ? candidates[i] : (int)i;
+		if (n < 0) // Group header
+			continue;
+
+		const ListData &data = _dataList[n];
+		bool matches = true;
+		tok.reset();
+		while (!tok.empty()) {
+			if (!_filterMatcher(_filterMatcherArg, n, data.search, tok.nextToken())) {
+				matches = false;
+				break;
+			}
+		}
+
+		if (matches) {
+			_list.push_back(data.orig);
+			_listIndex.push_back(n);
+		}
+	}
+}
+
 Common::U32String ListWidget::getThemeColor(byte r, byte g, byte b) {
 	return Common::U32String::format("\001c%02x%02x%02x", r, g, b);
 }
@@ -53,8 +53,9 @@ public:
 	struct ListData {
 		Common::U32String orig;
 		Common::U32String clean;
+		Common::U32String search;	///< Lowercased clean string, which the filter is matched against
 
-		ListData(const Common::U32String &o, const Common::U32String &c) { orig = o; clean = c; }
+		ListData(const Common::U32String &o, const Common::U32String &c) : orig(o), clean(c), search(c) { search.toLowercase(); }
 	};
 
 	typedef Common::Array<ListData> ListDataArray;
@@ -171,6 +172,16 @@ protected:
 
 	void copyListData(const Common::U32StringArray &list);
 
+	/**
+	 * Returns true if the entries matching filter are a subset of the entries
+	 * matching the current filter, so only those need to be checked again.
+	 * This is the case when filter extends the current filter, as long as no
+	 * negation or key operator is involved.
+	 */
+	bool isNarrowingFilter(const Common::U32String &filter) const;
+	/// Restricts the list to the entries matching _filter
+	void applyFilter(bool narrowing);
+
 	void receivedFocusWidget() override;
 	void lostFocusWidget() override;
 	void checkBounds();
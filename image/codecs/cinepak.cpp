@@ -302,9 +302,9 @@ void decodeVectorsTmpl(CinepakFrame &frame, const byte *clipTable, const byte *c
 
 	for (uint16 y = frame.strips[strip].rect.top; y < frame.strips[strip].rect.bottom; y += 4) {
 		iy[0] = (PixelInt *)frame.surface->getBasePtr(frame.strips[strip].rect.left, + y);
-		iy[1] = iy[0] + frame.width;
-		iy[2] = iy[1] + frame.width;
-		iy[3] = iy[2] + frame.width;
+		iy[1] = (PixelInt *)((byte *)iy[0] + frame.surface->pitch);
+		iy[2] = (PixelInt *)((byte *)iy[1] + frame.surface->pitch);
+		iy[3] = (PixelInt *)((byte *)iy[2] + frame.surface->pitch);
 
 		for (uint16 x = frame.strips[strip].rect.left; x < frame.strips[strip].rect.right; x += 4) {
 			if ((chunkID & 0x01) && !(mask >>= 1)) {
@@ -384,10 +384,7 @@ CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec(), _bitsPerPixel(bitsPe
 }
 
 CinepakDecoder::~CinepakDecoder() {
-	if (_curFrame.surface) {
-		_curFrame.surface->free();
-		delete _curFrame.surface;
-	}
+	freeSurface();
 
 	delete[] _curFrame.strips;
 	delete[] _clipTableBuf;
@@ -628,10 +625,24 @@ bool CinepakDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
 	if (_bitsPerPixel == 8)
 		return false;
 
+	if (format == _pixelFormat)
+		return true;
+
+	// Recreate the surface in the new format on the next frame
+	freeSurface();
 	_pixelFormat = format;
 	return true;
 }
 
+void CinepakDecoder::freeSurface() {
+	if (!_curFrame.surface)
+		return;
+
+	_curFrame.surface->free();
+	delete _curFrame.surface;
+	_curFrame.surface = 0;
+}
+
 bool CinepakDecoder::canDither(DitherType type) const {
 	return (type == kDitherTypeVFW || type == kDitherTypeQT) && _bitsPerPixel == 24;
 }
@@ -649,6 +660,9 @@ void CinepakDecoder::setDither(DitherType type, const byte *palette) {
 	_pixelFormat = Graphics::PixelFormat::createFormatCLUT8();
 	_ditherType = type;
 
+	// Any surface in the previous format is of no use anymore
+	freeSurface();
+
 	if (type == kDitherTypeVFW) {
 		_colorMap = new byte[221];
 
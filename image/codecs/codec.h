@@ -88,6 +88,9 @@ public:
 	/**
 	 * Select the preferred format to use, for codecs where this is faster than converting
 	 * the image afterwards. Returns true if supported, and false otherwise.
+	 *
+	 * This should be called before the first call to decodeFrame(), so that
+	 * no frame has to be decoded in one format and converted to another.
 	 */
 	virtual bool setOutputPixelFormat(const Graphics::PixelFormat &format) { return false; }
 
@@ -0,0 +1,183 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/g711.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+#include "../golden.h"
+
+// Golden output tests for the ADPCM and G.711 decoders. Pseudo-randomly
+// generated data with valid block headers is decoded with varying buffer
+// sizes and the output is hashed, so that optimizations of the decoders can
+// be checked to be bit exact.
+class ADPCMTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum Format {
+		kFormatOki,
+		kFormatDVI,
+		kFormatMSIma,
+		kFormatMS,
+		kFormatApple,
+		kFormatDK3,
+		kFormatXA,
+		kFormatALaw,
+		kFormatMuLaw
+	};
+
+	GoldenRandom _random;
+
+	void writeLE16(byte *dst, uint16 value) {
+		dst[0] = value & 0xFF;
+		dst[1] = value >> 8;
+	}
+
+	// Fills a block of blockAlign bytes, starting with a valid header
+	void makeBlock(Format format, byte *block, uint32 blockAlign, int channels, int rate) {
+		for (uint32 i = 0; i < blockAlign; i++)
+			block[i] = _random.next(256);
+
+		switch (format) {
+		case kFormatMSIma:
+			for (int i = 0; i < channels; i++) {
+				writeLE16(block + i * 4, _random.next(65536));
+				writeLE16(block + i * 4 + 2, _random.next(89));
+			}
+			break;
+		case kFormatMS:
+			for (int i = 0; i < channels; i++) {
+				block[i] = _random.next(7);
+				writeLE16(block + channels + i * 2, 16 + _random.next(2048));
+			}
+			break;
+		case kFormatDK3:
+			writeLE16(block + 2, rate);
+			block[14] = _random.next(89);
+			block[15] = _random.next(89);
+			break;
+		case kFormatXA:
+			for (int i = 4; i < 12; i++)
+				block[i] = (_random.next(5) << 4) | _random.next(13);
+			break;
+		default:
+			break;
+		}
+	}
+
+	uint32 decode(Format format, int channels, uint32 blockAlign, uint32 blocks, uint32 extra, int granularity) {
+		const int rate = 22050;
+		const uint32 size = blocks * blockAlign + extra;
+		byte *data = (byte *)malloc(size);
+
+		for (uint32 i = 0; i < blocks; i++)
+			makeBlock(format, data + i * blockAlign, blockAlign, channels, rate);
+		for (uint32 i = 0; i < extra; i++)
+			data[blocks * blockAlign + i] = _random.next(256);
+		if (format == kFormatMSIma || format == kFormatMS || format == kFormatDK3)
+			makeBlock(format, data + blocks * blockAlign, extra, channels, rate);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+		Common::ScopedPtr<Audio::SeekableAudioStream> audio;
+
+		switch (format) {
+		case kFormatOki:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMOki, rate, channels, blockAlign));
+			break;
+		case kFormatDVI:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMDVI, rate, channels, blockAlign));
+			break;
+		case kFormatMSIma:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMMSIma, rate, channels, blockAlign));
+			break;
+		case kFormatMS:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMMS, rate, channels, blockAlign));
+			break;
+		case kFormatApple:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMApple, rate, channels, blockAlign));
+			break;
+		case kFormatDK3:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMDK3, rate, channels, blockAlign));
+			break;
+		case kFormatXA:
+			audio.reset(Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, Audio::kADPCMXA, rate, channels, blockAlign));
+			break;
+		case kFormatALaw:
+			audio.reset(Audio::makeALawStream(stream, DisposeAfterUse::YES, rate, channels));
+			break;
+		case kFormatMuLaw:
+			audio.reset(Audio::makeMuLawStream(stream, DisposeAfterUse::YES, rate, channels));
+			break;
+		}
+
+		// Decode everything twice, to also cover rewinding
+		int16 buffer[2048];
+		uint32 hash = kFnv1aBasis;
+		for (int pass = 0; pass < 2; pass++) {
+			uint32 total = 0;
+			for (;;) {
+				const int samples = (1 + _random.next(ARRAYSIZE(buffer) / granularity)) * granularity;
+				const int count = audio->readBuffer(buffer, samples);
+				if (count <= 0)
+					break;
+
+				fnv1a(hash, buffer, count);
+				total += count;
+			}
+
+			fnv1a(hash, total);
+			audio->rewind();
+		}
+
+		return hash;
+	}
+
+public:
+	void test_oki() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatOki, 1, 0, 0, 20000, 1), 3982724269U);
+	}
+
+	void test_dvi() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatDVI, 1, 0, 0, 20000, 1), 3499041691U);
+		TS_ASSERT_EQUALS(decode(kFormatDVI, 2, 0, 0, 20001, 1), 2419876975U);
+	}
+
+	void test_ms_ima() {
+		_random.setSeed(12345);
+		// Only whole groups of eight samples per channel can be read
+		TS_ASSERT_EQUALS(decode(kFormatMSIma, 1, 512, 40, 260, 8), 2787122375U);
+		TS_ASSERT_EQUALS(decode(kFormatMSIma, 2, 1024, 20, 520, 16), 3393951235U);
+	}
+
+	void test_ms() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatMS, 1, 512, 40, 301, 1), 4027766607U);
+		TS_ASSERT_EQUALS(decode(kFormatMS, 2, 1024, 20, 501, 1), 3973438843U);
+	}
+
+	void test_apple() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatApple, 1, 34, 600, 0, 1), 1398082989U);
+		TS_ASSERT_EQUALS(decode(kFormatApple, 2, 34, 600, 0, 2), 629669543U);
+	}
+
+	void test_dk3() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatDK3, 2, 1024, 20, 301, 4), 130825989U);
+	}
+
+	void test_xa() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatXA, 1, 128, 150, 0, 1), 99503243U);
+		TS_ASSERT_EQUALS(decode(kFormatXA, 2, 128, 150, 0, 2), 1159313221U);
+	}
+
+	void test_g711() {
+		_random.setSeed(12345);
+		TS_ASSERT_EQUALS(decode(kFormatALaw, 1, 0, 0, 20000, 1), 987141597U);
+		TS_ASSERT_EQUALS(decode(kFormatMuLaw, 2, 0, 0, 20000, 2), 3586515373U);
+	}
+};
@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/fmopl.h"
+#include "audio/mixer.h"
+#include "common/ptr.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+// Checks that OPL::EmulatedOPL applies the register writes of the timer
+// callbacks at the sample position of their tick, and that it only splits
+// the rendering where such a write takes effect.
+class EmulatedOPLTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Outputs the last value written to a register as its samples
+	class TestOPL : public OPL::EmulatedOPL {
+	public:
+		TestOPL() : blocks(0), _value(0) {}
+
+		bool init() override { return true; }
+		void reset() override { _value = 0; }
+
+		void write(int a, int v) override {
+			if (queueWrite(a, v, false))
+				return;
+
+			if (a & 1)
+				_value = v;
+		}
+
+		byte read(int a) override { return 0; }
+
+		void writeReg(int r, int v) override {
+			if (queueWrite(r, v, true))
+				return;
+
+			_value = v;
+		}
+
+		bool isStereo() const override { return false; }
+
+		// Number of generateSamples() calls
+		int blocks;
+
+	protected:
+		void generateSamples(int16 *buffer, int numSamples) override {
+			for (int i = 0; i < numSamples; i++)
+				buffer[i] = _value;
+			blocks++;
+		}
+
+	private:
+		int _value;
+	};
+
+	TestOPL *_opl;
+	int _ticks;
+	int _writes;
+
+	// Writes the number of the write on every fourth tick
+	void onTimer() {
+		if (_ticks % 4 == 0) {
+			_writes++;
+			_opl->writeReg(0xA0, _writes);
+		}
+		_ticks++;
+	}
+
+public:
+	void test_write_offsets() {
+		Common::install_null_g_system();
+
+		const int frequency = 50;
+		const int rate = g_system->getMixer()->getOutputRate();
+		TS_ASSERT_EQUALS(rate % frequency, 0);
+		const int samplesPerTick = rate / frequency;
+
+		Common::ScopedPtr<TestOPL> opl(new TestOPL());
+		_opl = opl.get();
+		_ticks = 0;
+		_writes = 0;
+		opl->start(new Common::Functor0Mem<void, EmulatedOPLTestSuite>(this, &EmulatedOPLTestSuite::onTimer), frequency);
+
+		// The buffer sizes vary, so that the ticks fall at different
+		// positions in them
+		int16 buffer[1024];
+		int pos = 0;
+		int errors = 0;
+		const int buffers = 40;
+		for (int i = 0; i < buffers; i++) {
+			const int len = 100 + (i * 397) % 900;
+			opl->readBuffer(buffer, len);
+
+			for (int j = 0; j < len; j++, pos++) {
+				if (buffer[j] != pos / (4 * samplesPerTick) + 1)
+					errors++;
+			}
+		}
+
+		TS_ASSERT_EQUALS(errors, 0);
+		TS_ASSERT_EQUALS(_ticks, pos / samplesPerTick + 1);
+
+		// A buffer is only split at the writes, not at every tick
+		TS_ASSERT_LESS_THAN_EQUALS(opl->blocks, buffers + _writes);
+		TS_ASSERT_LESS_THAN(buffers + _writes, buffers + _ticks);
+
+		opl->stop();
+	}
+};
@@ -0,0 +1,291 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/opl/dbopl.h"
+#include "audio/softsynth/opl/nuked.h"
+#include "common/ptr.h"
+
+#include "../golden.h"
+
+static const int oplSlotOffsets[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+
+// Golden output tests for the Nuked OPL3 and DOSBox OPL cores. A fixed,
+// pseudo-randomly generated register log and the writes of a game driver
+// are played through each core and the output is hashed, so that
+// optimizations can be checked to be bit exact. The cores are driven
+// directly, since the OPL wrappers take their sample rate from the mixer,
+// which is not available to the tests.
+class OPLTestSuite : public CxxTest::TestSuite
+{
+private:
+	// The register logs are played through this, so that they can be
+	// shared by the cores
+	struct Core {
+		Core(uint32 outputRate) : rate(outputRate) {}
+		virtual ~Core() {}
+
+		virtual void write(uint16 reg, byte value) = 0;
+		// At most 512 frames at once
+		virtual void render(int frames, uint32 &hash) = 0;
+
+		uint32 rate;
+	};
+
+#ifndef DISABLE_NUKED_OPL
+	struct NukedCore : public Core {
+		NukedCore(uint32 outputRate) : Core(outputRate), chip(new OPL::NUKED::opl3_chip()) {
+			OPL::NUKED::OPL3_Reset(chip.get(), rate);
+		}
+
+		void write(uint16 reg, byte value) override {
+			OPL::NUKED::OPL3_WriteRegBuffered(chip.get(), reg, value);
+		}
+
+		void render(int frames, uint32 &hash) override {
+			OPL::NUKED::OPL3_GenerateStream(chip.get(), buffer, frames);
+			fnv1a(hash, buffer, frames * 2);
+		}
+
+		Common::ScopedPtr<OPL::NUKED::opl3_chip> chip;
+		int16 buffer[2 * 512];
+	};
+#endif
+
+#ifndef DISABLE_DOSBOX_OPL
+	struct DOSBoxCore : public Core {
+		DOSBoxCore(uint32 outputRate) : Core(outputRate), chip(new OPL::DOSBox::DBOPL::Chip()) {
+			OPL::DOSBox::DBOPL::InitTables();
+			chip->Setup(rate);
+		}
+
+		void write(uint16 reg, byte value) override {
+			chip->WriteReg(reg, value);
+		}
+
+		// The samples are hashed before being clipped to 16 bits by the
+		// OPL wrapper
+		void render(int frames, uint32 &hash) override {
+			if (chip->opl3Active) {
+				chip->GenerateBlock3(frames, buffer);
+				frames *= 2;
+			} else {
+				chip->GenerateBlock2(frames, buffer);
+			}
+			for (int i = 0; i < frames; i++)
+				fnv1a(hash, (uint32)buffer[i]);
+		}
+
+		Common::ScopedPtr<OPL::DOSBox::DBOPL::Chip> chip;
+		int32 buffer[2 * 512];
+	};
+#endif
+
+	static uint32 playLog(Core &core, bool opl3) {
+		GoldenRandom rng;
+		uint32 hash = kFnv1aBasis;
+		int banks = opl3 ? 2 : 1;
+
+		core.write(0x01, 0x20);
+		if (opl3) {
+			core.write(0x105, 0x01);
+			core.write(0x104, 0x09);
+		}
+
+		for (int event = 0; event < 400; event++) {
+			int bank = rng.next(banks) << 8;
+			int channel = rng.next(9);
+
+			switch (rng.next(8)) {
+			case 0:
+				// Rhythm mode and percussion key on/off
+				core.write(0xBD, rng.next(256));
+				break;
+			case 1:
+				// Key off
+				core.write(bank + 0xB0 + channel, rng.next(0x20));
+				break;
+			default:
+				// New instrument and note
+				for (int op = 0; op < 2; op++) {
+					int slot = bank + oplSlotOffsets[channel] + op * 3;
+					core.write(0x20 + slot, rng.next(256));
+					core.write(0x40 + slot, rng.next(0x40) | (rng.next(4) << 6));
+					core.write(0x60 + slot, rng.next(256) | 0x11);
+					core.write(0x80 + slot, rng.next(256));
+					core.write(0xE0 + slot, rng.next(8));
+				}
+				core.write(bank + 0xC0 + channel, rng.next(256));
+				core.write(bank + 0xA0 + channel, rng.next(256));
+				core.write(bank + 0xB0 + channel, 0x20 | rng.next(0x20));
+				break;
+			}
+
+			core.render(1 + rng.next(512), hash);
+		}
+
+		// Let the notes decay
+		for (int i = 0; i < 64; i++)
+			core.render(512, hash);
+
+		return hash;
+	}
+
+	// The register writes of the AdLib driver of The Lost Files of Sherlock
+	// Holmes (ADHOM.DRV, reimplemented in engines/sherlock): its reset
+	// sequence, then a chord progression played with instruments and
+	// frequencies dumped from the driver.
+	struct GameLog {
+		GameLog(Core &oplCore) : core(oplCore), hash(kFnv1aBasis) {}
+
+		Core &core;
+		uint32 hash;
+		const byte *instruments[9];
+
+		void write(uint16 reg, byte value) {
+			core.write(reg, value);
+		}
+
+		// The driver is called 60 times per second
+		void wait(int ticks) {
+			for (uint32 frames = ticks * core.rate / 60; frames; ) {
+				uint32 step = MIN<uint32>(frames, 512);
+				core.render(step, hash);
+				frames -= step;
+			}
+		}
+
+		void reset() {
+			static const byte operatorRegs[] = { 0x20, 0x60, 0x80 };
+			static const byte channelRegs[] = { 0xA0, 0xB0, 0xC0 };
+
+			write(0x01, 0x20);
+			write(0x04, 0xE0);
+			write(0x08, 0x00);
+			write(0xBD, 0x00);
+			for (int i = 0; i < ARRAYSIZE(operatorRegs); i++)
+				resetOperators(operatorRegs[i], 0x00);
+			for (int i = 0; i < ARRAYSIZE(channelRegs); i++) {
+				for (int channel = 0; channel < 9; channel++)
+					write(channelRegs[i] + channel, 0x00);
+			}
+			resetOperators(0xE0, 0x00);
+			resetOperators(0x40, 0x3F);
+		}
+
+		void resetOperators(byte reg, byte value) {
+			for (int op = 0; op < 0x16; op++) {
+				if ((op & 7) < 6)
+					write(reg + op, value);
+			}
+		}
+
+		void programChange(int channel, const byte *instrument) {
+			static const byte regs[] = { 0x20, 0x40, 0x60, 0x80, 0xE0 };
+			const int op1 = oplSlotOffsets[channel];
+
+			for (int i = 0; i < 5; i++)
+				write(regs[i] + op1, instrument[i]);
+			for (int i = 0; i < 5; i++)
+				write(regs[i] + op1 + 3, instrument[5 + i]);
+			write(0xC0 + channel, instrument[10]);
+			instruments[channel] = instrument;
+		}
+
+		void voiceOnOff(int channel, bool keyOn, byte note, byte velocity) {
+			static const uint16 frequencies[12] = {
+				0x0158, 0x016C, 0x0182, 0x0199, 0x01B1, 0x01CB, 0x01E6, 0x0203, 0x0222, 0x0242, 0x0265, 0x0289
+			};
+			const byte offset = note + instruments[channel][11];
+			const uint16 frequency = frequencies[offset % 12] | ((offset / 12) << 10);
+
+			if (keyOn)
+				write(0x40 + oplSlotOffsets[channel] + 3, instruments[channel][7] - (velocity >> 3));
+			write(0xA0 + channel, frequency & 0xFF);
+			write(0xB0 + channel, (frequency >> 8) | (keyOn ? 0x20 : 0x00));
+		}
+	};
+
+	static uint32 playGameLog(Core &core) {
+		// Instruments 0, 15, 28, 31, 46 and 57 of the driver
+		static const byte instruments[6][12] = {
+			{ 0x71, 0x89, 0x51, 0x11, 0x00, 0x61, 0x23, 0x42, 0x15, 0x01, 0x02, 0xF4 },
+			{ 0x64, 0xC9, 0xB0, 0x01, 0x00, 0x61, 0x1F, 0xF0, 0x86, 0x00, 0x02, 0xF4 },
+			{ 0x31, 0x45, 0xF1, 0x53, 0x00, 0x32, 0x1F, 0xF2, 0x27, 0x00, 0x06, 0xF4 },
+			{ 0x11, 0x0A, 0xFE, 0x04, 0x00, 0x11, 0x1F, 0xF2, 0xBD, 0x00, 0x08, 0xF4 },
+			{ 0xD7, 0x4F, 0xF2, 0x61, 0x00, 0xD2, 0x1F, 0xF1, 0xB2, 0x00, 0x08, 0xF4 },
+			{ 0x02, 0x29, 0xF5, 0x75, 0x00, 0x01, 0x9F, 0xF2, 0xF3, 0x00, 0x00, 0xF4 }
+		};
+		static const byte chords[4][4] = {
+			{ 48, 60, 64, 67 }, { 45, 57, 60, 64 }, { 41, 57, 60, 65 }, { 43, 55, 59, 62 }
+		};
+
+		GameLog log(core);
+		log.reset();
+		for (int channel = 0; channel < 6; channel++)
+			log.programChange(channel, instruments[channel]);
+
+		for (int bar = 0; bar < 8; bar++) {
+			const byte *chord = chords[bar % 4];
+
+			// Bass and a sustained chord
+			log.voiceOnOff(3, true, chord[0], 100);
+			for (int voice = 0; voice < 3; voice++)
+				log.voiceOnOff(voice, true, chord[1 + voice], 80 + voice * 8);
+
+			// Arpeggio and a percussive note on every beat
+			for (int beat = 0; beat < 4; beat++) {
+				const byte note = chord[1 + (beat + bar) % 3] + 12;
+				log.voiceOnOff(4, true, note, 96);
+				log.voiceOnOff(5, true, chord[0] + 12 * (beat & 1), 120);
+				log.wait(12);
+				log.voiceOnOff(5, false, chord[0] + 12 * (beat & 1), 0);
+				log.voiceOnOff(4, false, note, 0);
+				log.wait(6);
+			}
+
+			for (int voice = 0; voice < 4; voice++)
+				log.voiceOnOff(voice, false, chord[voice == 3 ? 0 : 1 + voice], 0);
+		}
+
+		// Let the notes decay
+		log.wait(120);
+
+		return log.hash;
+	}
+
+public:
+	void test_nuked_golden_output() {
+#ifndef DISABLE_NUKED_OPL
+		NukedCore opl2Low(22050), opl2(44100), opl3(44100), opl3Native(49716);
+		TS_ASSERT_EQUALS(playLog(opl2Low, false), 1247221681U);
+		TS_ASSERT_EQUALS(playLog(opl2, false), 4094197596U);
+		TS_ASSERT_EQUALS(playLog(opl3, true), 449351618U);
+		TS_ASSERT_EQUALS(playLog(opl3Native, true), 3858847112U);
+#endif
+	}
+
+	void test_nuked_game_log() {
+#ifndef DISABLE_NUKED_OPL
+		NukedCore low(22050), high(44100);
+		TS_ASSERT_EQUALS(playGameLog(low), 3057409993U);
+		TS_ASSERT_EQUALS(playGameLog(high), 259768577U);
+#endif
+	}
+
+	void test_dosbox_golden_output() {
+#ifndef DISABLE_DOSBOX_OPL
+		DOSBoxCore opl2Low(22050), opl2(44100), opl3(44100), opl3Native(49716);
+		TS_ASSERT_EQUALS(playLog(opl2Low, false), 2112869806U);
+		TS_ASSERT_EQUALS(playLog(opl2, false), 4274138635U);
+		TS_ASSERT_EQUALS(playLog(opl3, true), 279847015U);
+		TS_ASSERT_EQUALS(playLog(opl3Native, true), 4196915777U);
+#endif
+	}
+
+	void test_dosbox_game_log() {
+#ifndef DISABLE_DOSBOX_OPL
+		DOSBoxCore low(22050), high(44100);
+		TS_ASSERT_EQUALS(playGameLog(low), 2599228757U);
+		TS_ASSERT_EQUALS(playGameLog(high), 3045435681U);
+#endif
+	}
+};
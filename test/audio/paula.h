@@ -0,0 +1,84 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mods/paula.h"
+#include "common/ptr.h"
+
+#include "../golden.h"
+
+// Golden output test for the Paula mixer. Pseudo-randomly generated notes
+// are played on all voices and the output is hashed, so that optimizations
+// of the mixer can be checked to be bit exact.
+class PaulaTestSuite : public CxxTest::TestSuite
+{
+private:
+	class TestPaula : public Audio::Paula {
+	public:
+		TestPaula(bool stereo, FilterMode filterMode) :
+			Audio::Paula(stereo, 44100, 44100 / 50, filterMode), _ticks(0) {
+
+			for (int i = 0; i < ARRAYSIZE(_sample); i++)
+				_sample[i] = (int8)((i * 37 + (i >> 3) * 11) & 0xFF);
+			startPaula();
+		}
+
+		uint next(uint max) { return _random.next(max); }
+
+	protected:
+		void interrupt() override {
+			_ticks++;
+			setAudioFilter((_ticks & 0x40) != 0);
+
+			for (int voice = 0; voice < NUM_VOICES; voice++) {
+				switch (next(6)) {
+				case 0: {
+					// New note, looped or played once
+					const uint32 start = next(256) * 2;
+					const uint32 length = 2 + next(512) * 2;
+					const uint32 repeat = next(2) ? 2 + next(256) * 2 : 0;
+					setChannelData(voice, _sample + start, repeat ? _sample + start + length / 2 : nullptr, length, repeat);
+					setChannelPeriod(voice, 113 + next(800));
+					setChannelVolume(voice, next(65));
+					break;
+				}
+				case 1:
+					setChannelPeriod(voice, 113 + next(800));
+					break;
+				case 2:
+					setChannelVolume(voice, next(65));
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+	private:
+		int8 _sample[2048];
+		GoldenRandom _random;
+		uint _ticks;
+	};
+
+	static uint32 play(bool stereo, Audio::Paula::FilterMode filterMode, Audio::Paula::InterpolationMode interpolation) {
+		Common::ScopedPtr<TestPaula> paula(new TestPaula(stereo, filterMode));
+		paula->setInterpolation(interpolation);
+
+		int16 buffer[2 * 700];
+		uint32 hash = kFnv1aBasis;
+		for (int i = 0; i < 200; i++) {
+			const int samples = (1 + paula->next(700)) * (stereo ? 2 : 1);
+			paula->readBuffer(buffer, samples);
+			fnv1a(hash, buffer, samples);
+		}
+		return hash;
+	}
+
+public:
+	void test_golden_output() {
+		TS_ASSERT_EQUALS(play(false, Audio::Paula::kFilterModeNone, Audio::Paula::kInterpolationNone), 1341351522U);
+		TS_ASSERT_EQUALS(play(true, Audio::Paula::kFilterModeNone, Audio::Paula::kInterpolationNone), 3229813716U);
+		TS_ASSERT_EQUALS(play(true, Audio::Paula::kFilterModeA500, Audio::Paula::kInterpolationNone), 2694797726U);
+		TS_ASSERT_EQUALS(play(true, Audio::Paula::kFilterModeA1200, Audio::Paula::kInterpolationNone), 3469831342U);
+		TS_ASSERT_EQUALS(play(true, Audio::Paula::kFilterModeA1200, Audio::Paula::kInterpolationLinear), 4221957178U);
+		TS_ASSERT_EQUALS(play(true, Audio::Paula::kFilterModeA1200, Audio::Paula::kInterpolationCubic), 217690528U);
+	}
+};
@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/fmtowns_pc98/towns_pc98_fmsynth.h"
+#include "common/ptr.h"
+#include "common/system.h"
+#include "../null_osystem.h"
+#include "../golden.h"
+
+// Golden output test for the FM-Towns/PC-98 FM synth. The timer callbacks
+// write pseudo-randomly generated notes for the FM, SSG and rhythm channels,
+// and the output is hashed, so that optimizations of the renderer can be
+// checked to be bit exact.
+class TownsPC98FmSynthTestSuite : public CxxTest::TestSuite
+{
+private:
+	class TestSynth : public TownsPC98_FmSynth {
+	public:
+		TestSynth(EmuType type) : TownsPC98_FmSynth(g_system->getMixer(), type) {}
+
+		bool init() override {
+			if (!TownsPC98_FmSynth::init())
+				return false;
+
+			reset();
+			// Start timer A, which drives the register writes
+			writeReg(0, 0x24, 0xE0);
+			writeReg(0, 0x25, 0x00);
+			writeReg(0, 0x27, 0x15);
+			return true;
+		}
+
+	protected:
+		void timerCallbackA() override {
+			writeReg(0, 0x27, 0x15);
+
+			for (int event = _random.next(4); event; event--) {
+				const int channel = _random.next(_numChan);
+				const uint8 part = channel / 3;
+				const uint8 offset = channel % 3;
+
+				switch (_random.next(8)) {
+				case 0:
+				case 1: {
+					// New note
+					for (int slot = 0; slot < 4; slot++) {
+						const uint8 reg = offset + slot * 4;
+						writeReg(part, 0x30 + reg, _random.next(128));
+						writeReg(part, 0x40 + reg, 24 + _random.next(64));
+						writeReg(part, 0x50 + reg, (_random.next(4) << 6) | (8 + _random.next(24)));
+						writeReg(part, 0x60 + reg, _random.next(32));
+						writeReg(part, 0x70 + reg, _random.next(32));
+						writeReg(part, 0x80 + reg, _random.next(256));
+						writeReg(part, 0x90 + reg, _random.next(4) ? 0 : 8 + _random.next(8));
+					}
+					writeReg(part, 0xB0 + offset, _random.next(64));
+					writeReg(part, 0xB4 + offset, 0x40 << _random.next(2) | _random.next(2) << 7);
+					writeReg(part, 0xA4 + offset, _random.next(64));
+					writeReg(part, 0xA0 + offset, _random.next(256));
+					writeReg(0, 0x28, 0xF0 | (part << 2) | offset);
+					break;
+				}
+				case 2:
+					// Key off
+					writeReg(0, 0x28, (part << 2) | offset);
+					break;
+				case 3:
+					// Pitch change
+					writeReg(part, 0xA4 + offset, _random.next(64));
+					writeReg(part, 0xA0 + offset, _random.next(256));
+					break;
+				case 4:
+					// SSG tone and noise
+					writeReg(0, 0x00 + _random.next(6), _random.next(256));
+					writeReg(0, 0x06, _random.next(32));
+					writeReg(0, 0x07, 0x80 | _random.next(64));
+					writeReg(0, 0x08 + _random.next(3), _random.next(32));
+					break;
+				case 5:
+					// SSG envelope
+					writeReg(0, 0x0B, _random.next(256));
+					writeReg(0, 0x0C, _random.next(4));
+					writeReg(0, 0x0D, _random.next(16));
+					break;
+				case 6:
+					// Rhythm
+					writeReg(0, 0x11, 0x20 + _random.next(32));
+					writeReg(0, 0x18 + _random.next(6), 0xC0 | _random.next(32));
+					writeReg(0, 0x10, _random.next(64));
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		void timerCallbackB() override {}
+
+	private:
+		GoldenRandom _random;
+	};
+
+	static uint32 play(TownsPC98_FmSynth::EmuType type) {
+		Common::ScopedPtr<TestSynth> synth(new TestSynth(type));
+		synth->init();
+
+		// The synth expects the mixer to always ask for the same amount of
+		// samples
+		int16 buffer[2 * 512];
+		uint32 hash = kFnv1aBasis;
+		for (int i = 0; i < 200; i++) {
+			synth->readBuffer(buffer, ARRAYSIZE(buffer));
+			fnv1a(hash, buffer, ARRAYSIZE(buffer));
+		}
+		return hash;
+	}
+
+public:
+	void test_golden_output() {
+		Common::install_null_g_system();
+
+		TS_ASSERT_EQUALS(play(TownsPC98_FmSynth::kTypeTowns), 1542171773U);
+		TS_ASSERT_EQUALS(play(TownsPC98_FmSynth::kType26), 4016445063U);
+		TS_ASSERT_EQUALS(play(TownsPC98_FmSynth::kType86), 3385277079U);
+	}
+};
@@ -0,0 +1,254 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The report is printed directly to stdout
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+
+#include "test/benchmark/benchmark.h"
+#include "test/null_osystem.h"
+
+#include "common/algorithm.h"
+#include "common/ptr.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Benchmark {
+
+static const SuiteFactory suiteFactories[] = {
+	createImageSuite,
+	createCodecSuite,
+	createVideoSuite,
+	createOPLSuite,
+	createModsSuite,
+	createGUISuite,
+	createBlitSuite,
+	nullptr
+};
+
+Measurement::Measurement(const Options &opts, Result &result) : _opts(opts), _result(result), _finished(false) {
+	resetAllocPeak();
+	_startAllocs = getAllocStats();
+	_startTime = g_system->getMillis();
+}
+
+Measurement::~Measurement() {
+	finish();
+}
+
+bool Measurement::next() {
+	if (_finished)
+		return false;
+
+	// Always run at least one full iteration
+	if (_result.iterations > 0) {
+		uint32 elapsed = g_system->getMillis() - _startTime;
+		if (elapsed >= _opts.minTime || _result.iterations >= _opts.maxIterations) {
+			finish();
+			return false;
+		}
+	}
+
+	_result.iterations++;
+	return true;
+}
+
+void Measurement::fail(const Common::String &reason) {
+	_result.failed = true;
+	_result.detail = reason;
+	finish();
+}
+
+void Measurement::finish() {
+	if (_finished)
+		return;
+
+	_finished = true;
+	_result.millis = g_system->getMillis() - _startTime;
+
+	AllocStats endAllocs = getAllocStats();
+	_result.allocs = endAllocs.allocCount - _startAllocs.allocCount;
+	_result.peakBytes = endAllocs.peakBytes - _startAllocs.liveBytes;
+}
+
+Common::String getExtension(const Common::String &name) {
+	const char *dot = strrchr(name.c_str(), '.');
+	if (!dot)
+		return Common::String();
+
+	Common::String ext(dot + 1);
+	ext.toLowercase();
+	return ext;
+}
+
+byte *readSample(const Common::FSNode &node, uint32 &size) {
+	Common::ScopedPtr<Common::SeekableReadStream> stream(node.createReadStream());
+	if (!stream)
+		return nullptr;
+
+	size = stream->size();
+	byte *data = (byte *)malloc(size);
+	if (data && stream->read(data, size) != size) {
+		free(data);
+		data = nullptr;
+	}
+	return data;
+}
+
+static void findSamplesInDir(const Options &opts, const Common::FSNode &dir, const char *const *extensions, Common::FSList &samples) {
+	Common::FSList children;
+	if (!dir.getChildren(children, Common::FSNode::kListAll, false))
+		return;
+
+	Common::sort(children.begin(), children.end());
+
+	for (Common::FSList::const_iterator it = children.begin(); it != children.end(); ++it) {
+		if (it->isDirectory()) {
+			findSamplesInDir(opts, *it, extensions, samples);
+			continue;
+		}
+
+		Common::String name = it->getName();
+		if (!opts.sampleFilter.empty() && !name.contains(opts.sampleFilter))
+			continue;
+
+		Common::String ext = getExtension(name);
+		for (const char *const *e = extensions; *e; e++) {
+			if (ext == *e) {
+				samples.push_back(*it);
+				break;
+			}
+		}
+	}
+}
+
+void findSamples(const Options &opts, const char *const *extensions, Common::FSList &samples) {
+	findSamplesInDir(opts, opts.sampleDir, extensions, samples);
+}
+
+static void printReport(const Common::Array<Result> &results) {
+	printf("%-8s %-32s %6s %8s %18s %10s %11s %10s  %s\n",
+		"suite", "sample", "iters", "ms", "rate", "MB/s", "allocs/it", "peak KB", "detail");
+
+	for (Common::Array<Result>::const_iterator it = results.begin(); it != results.end(); ++it) {
+		if (it->failed) {
+			printf("%-8s %-32s FAILED: %s\n", it->suite.c_str(), it->name.c_str(), it->detail.c_str());
+			continue;
+		}
+
+		double seconds = MAX<uint32>(it->millis, 1) / 1000.0;
+		double unitsPerSec = it->units * it->unitScale / seconds;
+		double mbPerSec = it->bytes / seconds / (1024.0 * 1024.0);
+		double allocsPerIter = (double)it->allocs / MAX<uint32>(it->iterations, 1);
+
+		Common::String rate = Common::String::format("%.1f %s/s", unitsPerSec, it->unitName);
+
+		printf("%-8s %-32s %6u %8u %18s %10.2f %11.1f %10u  %s\n",
+			it->suite.c_str(), it->name.c_str(), it->iterations, it->millis,
+			rate.c_str(), mbPerSec, allocsPerIter, (uint32)(it->peakBytes / 1024),
+			it->detail.c_str());
+	}
+}
+
+static void printUsage(const char *name) {
+	printf("Usage: %s [options] <sample directory>\n"
+		"  -s <name>   only run suites whose name contains <name>\n"
+		"  -f <name>   only run samples whose file name contains <name>\n"
+		"  -t <ms>     minimum time spent on each sample (default 1000)\n"
+		"  -n <count>  maximum number of iterations per sample\n"
+		"  -l          list the available suites\n", name);
+}
+
+static void listSuites() {
+	for (const SuiteFactory *f = suiteFactories; *f; f++) {
+		Suite *suite = (*f)();
+		printf("%-10s %s\n", suite->getName(), suite->getDescription());
+		delete suite;
+	}
+}
+
+} // End of namespace Benchmark
+
+int main(int argc, char *argv[]) {
+	using namespace Benchmark;
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+	Common::install_null_g_system();
+#else
+	printf("The benchmark requires the null OSystem, which is not available on this platform\n");
+	return 1;
+#endif
+
+	Options opts;
+	const char *sampleDir = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		Common::String arg(argv[i]);
+
+		if (arg == "-l") {
+			listSuites();
+			return 0;
+		} else if ((arg == "-s" || arg == "-f" || arg == "-t" || arg == "-n") && i + 1 < argc) {
+			const char *value = argv[++i];
+			if (arg == "-s")
+				opts.suiteFilter = value;
+			else if (arg == "-f")
+				opts.sampleFilter = value;
+			else if (arg == "-t")
+				opts.minTime = atoi(value);
+			else
+				opts.maxIterations = MAX(atoi(value), 1);
+		} else if (arg.hasPrefix("-") || sampleDir) {
+			printUsage(argv[0]);
+			return 1;
+		} else {
+			sampleDir = argv[i];
+		}
+	}
+
+	if (!sampleDir) {
+		printUsage(argv[0]);
+		return 1;
+	}
+
+	opts.sampleDir = Common::FSNode(sampleDir);
+	if (!opts.sampleDir.isDirectory()) {
+		printf("'%s' is not a directory\n", sampleDir);
+		return 1;
+	}
+
+	Common::Array<Result> results;
+
+	for (const SuiteFactory *f = suiteFactories; *f; f++) {
+		Suite *suite = (*f)();
+		if (opts.suiteFilter.empty() || Common::String(suite->getName()).contains(opts.suiteFilter))
+			suite->run(opts, results);
+		delete suite;
+	}
+
+	printReport(results);
+
+	for (Common::Array<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+		if (it->failed)
+			return 1;
+
+	return 0;
+}
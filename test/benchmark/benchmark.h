@@ -0,0 +1,173 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_BENCHMARK_BENCHMARK_H
+#define TEST_BENCHMARK_BENCHMARK_H
+
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/str.h"
+
+namespace Benchmark {
+
+/**
+ * Allocation counters maintained by the hooks in memory.cpp.
+ */
+struct AllocStats {
+	uint64 allocCount;
+	uint64 liveBytes;
+	uint64 peakBytes;
+};
+
+/** Return a snapshot of the current allocation counters. */
+AllocStats getAllocStats();
+
+/** Restart peak tracking from the current amount of live memory. */
+void resetAllocPeak();
+
+struct Options {
+	Options() : minTime(1000), maxIterations(1000000) {}
+
+	/** Directory the sample files are read from. */
+	Common::FSNode sampleDir;
+
+	/** Only run suites whose name contains this string. */
+	Common::String suiteFilter;
+
+	/** Only run samples whose file name contains this string. */
+	Common::String sampleFilter;
+
+	/** Minimum wall time in milliseconds spent repeating each sample. */
+	uint32 minTime;
+
+	/** Upper bound on the number of repetitions of each sample. */
+	uint32 maxIterations;
+};
+
+/**
+ * One line of the benchmark report.
+ *
+ * "Units" are whatever the suite naturally produces: frames for
+ * video and image codecs, sample frames for audio, pixels for blits.
+ */
+struct Result {
+	Result() : unitName("unit"), unitScale(1.0), iterations(0), millis(0), units(0), bytes(0), allocs(0), peakBytes(0), failed(false) {}
+
+	Common::String suite;
+	Common::String name;
+	Common::String detail;
+	const char *unitName;
+
+	/** Factor applied to the units in the report, e.g. 1e-6 for Mpix. */
+	double unitScale;
+
+	uint32 iterations;
+	uint32 millis;
+	uint64 units;
+	uint64 bytes;
+	uint64 allocs;
+	uint64 peakBytes;
+	bool failed;
+};
+
+/**
+ * Repeats a workload until the configured minimum time has elapsed,
+ * accumulating timing and allocation statistics into a Result.
+ *
+ * Usage:
+ *	Measurement m(opts, result);
+ *	while (m.next()) {
+ *		... one pass over the sample ...
+ *		m.addUnits(frames);
+ *		m.addBytes(inputSize);
+ *	}
+ */
+class Measurement {
+public:
+	Measurement(const Options &opts, Result &result);
+	~Measurement();
+
+	/** Start the next iteration. Returns false once enough time has passed. */
+	bool next();
+
+	void addUnits(uint64 units) { _result.units += units; }
+	void addBytes(uint64 bytes) { _result.bytes += bytes; }
+
+	/** Abort the measurement and flag the result as failed. */
+	void fail(const Common::String &reason);
+
+private:
+	void finish();
+
+	const Options &_opts;
+	Result &_result;
+	uint32 _startTime;
+	AllocStats _startAllocs;
+	bool _finished;
+};
+
+/**
+ * A group of related benchmarks, e.g. all video decoders.
+ */
+class Suite {
+public:
+	virtual ~Suite() {}
+
+	/** Short identifier used on the command line and in the report. */
+	virtual const char *getName() const = 0;
+
+	/** One line description for --list. */
+	virtual const char *getDescription() const = 0;
+
+	/** Run the suite, appending one Result per measured sample. */
+	virtual void run(const Options &opts, Common::Array<Result> &results) = 0;
+};
+
+typedef Suite *(*SuiteFactory)();
+
+Suite *createImageSuite();
+Suite *createCodecSuite();
+Suite *createVideoSuite();
+Suite *createOPLSuite();
+Suite *createModsSuite();
+Suite *createGUISuite();
+Suite *createBlitSuite();
+
+/**
+ * Collect all files below the sample directory (recursively) whose name
+ * ends with one of the given extensions, honouring the sample filter.
+ * The extension list is terminated by a null pointer.
+ */
+void findSamples(const Options &opts, const char *const *extensions, Common::FSList &samples);
+
+/**
+ * Read a whole sample into memory, so that the measurements are not
+ * affected by file system performance. The buffer must be released
+ * with free(); nullptr is returned on error.
+ */
+byte *readSample(const Common::FSNode &node, uint32 &size);
+
+/** Return the lower-cased extension of a file name, without the dot. */
+Common::String getExtension(const Common::String &name);
+
+} // End of namespace Benchmark
+
+#endif
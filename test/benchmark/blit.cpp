@@ -0,0 +1,451 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+#include "test/golden.h"
+#include "test/instrset_detect.h"
+
+#include "graphics/blit.h"
+#include "graphics/managed_surface.h"
+#include "graphics/transparent_surface.h"
+
+namespace Benchmark {
+
+/**
+ * Measures the blitting routines on synthetic surfaces.
+ *
+ * Covers the format conversions and color keyed copies of graphics/blit,
+ * and the ManagedSurface and TransparentSurface operations built on top of
+ * them, at a sprite sized and two screen sized areas. The operations with
+ * SIMD versions are run once for each version the cpu supports, so that
+ * the platform paths can be compared with each other.
+ *
+ * No samples are needed; the sample filter matches the operation names.
+ * The rate is in Mpix/s of the destination, and the detail column holds a
+ * hash of the output of a single pass. The keyed blitters give identical
+ * results in all versions; the SIMD versions of BlendBlit round differently
+ * from the generic one.
+ */
+class BlitSuite : public Suite {
+public:
+	const char *getName() const override { return "blit"; }
+	const char *getDescription() const override { return "Blitting, format conversion and scaling of surfaces"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override;
+
+private:
+	enum Format {
+		kCLUT8,
+		kRGB555,
+		kRGB565,
+		kRGB888,
+		kXRGB8888,
+		kARGB8888,
+		kRGBA8888,
+		kABGR8888
+	};
+
+	enum Op {
+		kOpCrossBlit,
+		kOpCrossBlitMap,
+		kOpKeyBlit,
+		kOpBlitFrom,
+		kOpTransBlit,
+		kOpTransBlitFlipped,
+		kOpTransBlitScaled,
+		kOpBlendBlit,
+		kOpBlendBlitScaled,
+		kOpBlendBlitTinted,
+		kOpScale,
+		kOpScaleBilinear
+	};
+
+	/** Which of the runtime selected function sets the operation uses. */
+	enum Dispatch {
+		kDispatchNone,
+		kDispatchKeyBlit,
+		kDispatchBlendBlit,
+		kDispatchCrossBlit
+	};
+
+	enum Impl {
+		kImplGeneric,
+		kImplSSE2,
+		kImplAVX2,
+		kImplNEON,
+		kImplCount
+	};
+
+	struct Case {
+		const char *name;
+		Op op;
+		Format srcFormat, dstFormat;
+		Dispatch dispatch;
+	};
+
+	struct Size {
+		int w, h;
+	};
+
+	static const Case kCases[];
+	static const Size kSizes[];
+	static const char *const kImplNames[];
+	static const char *const kFormatNames[];
+
+	static Graphics::PixelFormat getFormat(Format format) {
+		switch (format) {
+		case kCLUT8:
+			return Graphics::PixelFormat::createFormatCLUT8();
+		case kRGB555:
+			return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
+		case kRGB565:
+			return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		case kRGB888:
+			return Graphics::PixelFormat(3, 8, 8, 8, 0, 16, 8, 0, 0);
+		case kXRGB8888:
+			return Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		case kARGB8888:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		case kRGBA8888:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		case kABGR8888:
+		default:
+			return Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		}
+	}
+
+	/** The transparent color used for the keyed operations. */
+	static uint32 getKey(const Graphics::PixelFormat &format) {
+		return format.bytesPerPixel == 1 ? 0 : format.RGBToColor(0xFF, 0, 0xFF);
+	}
+
+	static bool selectImpl(Dispatch dispatch, Impl impl) {
+		if (dispatch == kDispatchNone)
+			return impl == kImplGeneric;
+
+		Graphics::BlendBlit::blitFunc = Graphics::BlendBlit::blitGeneric;
+		Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitGeneric;
+		Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapGeneric;
+		Graphics::CrossBlit::shuffleFunc = nullptr;
+		Graphics::CrossBlit::expandFunc = nullptr;
+		Graphics::CrossBlit::funcsSelected = true;
+
+		switch (impl) {
+		case kImplGeneric:
+			return true;
+#ifdef SCUMMVM_SSE2
+		case kImplSSE2:
+			Graphics::BlendBlit::blitFunc = Graphics::BlendBlit::blitSSE2;
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitSSE2;
+			return dispatch != kDispatchCrossBlit && instrset_detect() >= 2;
+#endif
+#ifdef SCUMMVM_AVX2
+		case kImplAVX2:
+			Graphics::BlendBlit::blitFunc = Graphics::BlendBlit::blitAVX2;
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitAVX2;
+			Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapAVX2;
+			Graphics::CrossBlit::shuffleFunc = Graphics::CrossBlit::shuffleAVX2;
+			Graphics::CrossBlit::expandFunc = Graphics::CrossBlit::expandAVX2;
+			return instrset_detect() >= 8;
+#endif
+#ifdef SCUMMVM_NEON
+		case kImplNEON:
+			Graphics::BlendBlit::blitFunc = Graphics::BlendBlit::blitNEON;
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitNEON;
+			return dispatch != kDispatchCrossBlit;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	/** Let the blitters detect the cpu features again on their next use. */
+	static void resetImpl() {
+		Graphics::BlendBlit::blitFunc = nullptr;
+		Graphics::KeyBlit::blitFunc = nullptr;
+		Graphics::KeyBlit::blitMapFunc = nullptr;
+		Graphics::CrossBlit::funcsSelected = false;
+	}
+
+	/**
+	 * Fills the surface with runs of pseudo-random colors. A quarter of the
+	 * runs uses the transparent color, and the alpha channel is a mix of
+	 * fully transparent, opaque and translucent runs.
+	 */
+	static void fill(Graphics::ManagedSurface &surf, uint32 seed) {
+		const Graphics::PixelFormat &format = surf.format;
+		GoldenRandom rng(seed);
+		const uint32 key = getKey(format);
+
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; ) {
+				uint32 color;
+				if (!rng.next(4)) {
+					color = key;
+				} else if (format.bytesPerPixel == 1) {
+					color = 1 + rng.next(255);
+				} else {
+					const uint alpha = rng.next(3);
+					const byte a = alpha == 0 ? 0 : (alpha == 1 ? 0xFF : rng.next(256));
+					const byte r = rng.next(256);
+					const byte g = rng.next(256);
+					const byte b = rng.next(256);
+					color = format.ARGBToColor(a, r, g, b);
+				}
+
+				for (int run = 1 + rng.next(16); run && x < surf.w; run--, x++) {
+					byte *ptr = (byte *)surf.getBasePtr(x, y);
+					switch (format.bytesPerPixel) {
+					case 1:
+						*ptr = color;
+						break;
+					case 2:
+						*(uint16 *)ptr = color;
+						break;
+					case 3:
+						ptr[0] = color;
+						ptr[1] = color >> 8;
+						ptr[2] = color >> 16;
+						break;
+					default:
+						*(uint32 *)ptr = color;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	static uint32 hashSurface(const Graphics::Surface &surf) {
+		uint32 hash = kFnv1aBasis;
+		fnv1a(hash, surf);
+		return hash;
+	}
+
+	/** Returns the size of the destination written by one pass. */
+	static void getDestSize(const Case &blitCase, int w, int h, int &dstW, int &dstH) {
+		switch (blitCase.op) {
+		case kOpTransBlitScaled:
+		case kOpBlendBlitScaled:
+		case kOpScale:
+		case kOpScaleBilinear:
+			dstW = w * 3 / 2;
+			dstH = h * 3 / 2;
+			break;
+		default:
+			dstW = w;
+			dstH = h;
+			break;
+		}
+	}
+
+	static void runCase(const Options &opts, const Case &blitCase, int w, int h, Result &result) {
+		const Graphics::PixelFormat srcFormat = getFormat(blitCase.srcFormat);
+		const Graphics::PixelFormat dstFormat = getFormat(blitCase.dstFormat);
+		int dstW, dstH;
+		getDestSize(blitCase, w, h, dstW, dstH);
+
+		Graphics::ManagedSurface src(w, h, srcFormat);
+		Graphics::ManagedSurface dst(dstW, dstH, dstFormat);
+		fill(src, 12345);
+
+		byte palette[256 * 3];
+		GoldenRandom rng(4321);
+		for (int i = 0; i < ARRAYSIZE(palette); i++)
+			palette[i] = rng.next(256);
+		if (srcFormat.isCLUT8())
+			src.setPalette(palette, 0, 256);
+
+		uint32 map[256];
+		Graphics::convertPaletteToMap(map, palette, 256, dstFormat);
+
+		// Hash a single pass over a fresh destination, as the blended
+		// operations depend on what was drawn before
+		fill(dst, 54321);
+		uint32 hash;
+		if (!blit(blitCase, src, dst, map, hash)) {
+			Measurement m(opts, result);
+			m.fail("unsupported format");
+			return;
+		}
+		if (!hash)
+			hash = hashSurface(*dst.surfacePtr());
+
+		Measurement m(opts, result);
+		while (m.next()) {
+			uint32 unused;
+			blit(blitCase, src, dst, map, unused);
+			m.addUnits(dstW * dstH);
+			m.addBytes(w * h * srcFormat.bytesPerPixel);
+		}
+
+		result.detail = Common::String::format("hash %08x", hash);
+	}
+
+	/**
+	 * Runs one pass of the operation. hash is set to the hash of the
+	 * output for the operations which don't draw into dst, and to 0
+	 * otherwise.
+	 */
+	static bool blit(const Case &blitCase, Graphics::ManagedSurface &src, Graphics::ManagedSurface &dst,
+			const uint32 *map, uint32 &hash) {
+		const int w = src.w, h = src.h;
+		byte *dstPixels = (byte *)dst.getPixels();
+		const byte *srcPixels = (const byte *)src.getPixels();
+		hash = 0;
+
+		switch (blitCase.op) {
+		case kOpCrossBlit:
+			return Graphics::crossBlit(dstPixels, srcPixels, dst.pitch, src.pitch, w, h, dst.format, src.format);
+		case kOpCrossBlitMap:
+			return Graphics::crossBlitMap(dstPixels, srcPixels, dst.pitch, src.pitch, w, h, dst.format.bytesPerPixel, map);
+		case kOpKeyBlit:
+			return Graphics::keyBlit(dstPixels, srcPixels, dst.pitch, src.pitch, w, h, dst.format.bytesPerPixel, getKey(src.format));
+		case kOpBlitFrom:
+			dst.blitFrom(src);
+			return true;
+		case kOpTransBlit:
+			dst.transBlitFrom(src, getKey(src.format));
+			return true;
+		case kOpTransBlitFlipped:
+			dst.transBlitFrom(src, getKey(src.format), true);
+			return true;
+		case kOpTransBlitScaled:
+			dst.transBlitFrom(src, Common::Rect(0, 0, w, h), Common::Rect(0, 0, dst.w, dst.h), getKey(src.format));
+			return true;
+		case kOpBlendBlit:
+			src.blendBlitTo(dst);
+			return true;
+		case kOpBlendBlitScaled:
+			src.blendBlitTo(dst, 0, 0, Graphics::FLIP_NONE, nullptr, MS_ARGB(255, 255, 255, 255), dst.w, dst.h);
+			return true;
+		case kOpBlendBlitTinted:
+			src.blendBlitTo(dst, 0, 0, Graphics::FLIP_H, nullptr, MS_ARGB(160, 255, 192, 128));
+			return true;
+		case kOpScale:
+		case kOpScaleBilinear: {
+			Graphics::TransparentSurface transSrc(*src.surfacePtr(), false);
+			Graphics::TransparentSurface *scaled = transSrc.scale(dst.w, dst.h, blitCase.op == kOpScaleBilinear);
+			hash = hashSurface(*scaled);
+			scaled->free();
+			delete scaled;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+};
+
+const BlitSuite::Case BlitSuite::kCases[] = {
+	{ "crossBlit",             kOpCrossBlit,        kRGB565,   kRGBA8888, kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kRGB565,   kXRGB8888, kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kRGBA8888, kRGB565,   kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kRGB555,   kRGB565,   kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kRGB888,   kRGBA8888, kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kARGB8888, kRGBA8888, kDispatchCrossBlit },
+	{ "crossBlit",             kOpCrossBlit,        kRGBA8888, kABGR8888, kDispatchCrossBlit },
+	{ "crossBlitMap",          kOpCrossBlitMap,     kCLUT8,    kRGB565,   kDispatchKeyBlit },
+	{ "crossBlitMap",          kOpCrossBlitMap,     kCLUT8,    kRGBA8888, kDispatchKeyBlit },
+	{ "keyBlit",               kOpKeyBlit,          kCLUT8,    kCLUT8,    kDispatchKeyBlit },
+	{ "keyBlit",               kOpKeyBlit,          kRGB565,   kRGB565,   kDispatchKeyBlit },
+	{ "keyBlit",               kOpKeyBlit,          kRGBA8888, kRGBA8888, kDispatchKeyBlit },
+	{ "blitFrom",              kOpBlitFrom,         kCLUT8,    kCLUT8,    kDispatchNone },
+	{ "blitFrom",              kOpBlitFrom,         kRGBA8888, kRGBA8888, kDispatchNone },
+	{ "blitFrom",              kOpBlitFrom,         kRGB565,   kRGBA8888, kDispatchNone },
+	{ "transBlitFrom",         kOpTransBlit,        kCLUT8,    kCLUT8,    kDispatchKeyBlit },
+	{ "transBlitFrom",         kOpTransBlit,        kCLUT8,    kRGB565,   kDispatchKeyBlit },
+	{ "transBlitFrom",         kOpTransBlit,        kCLUT8,    kRGBA8888, kDispatchKeyBlit },
+	{ "transBlitFrom",         kOpTransBlit,        kRGB565,   kRGB565,   kDispatchKeyBlit },
+	{ "transBlitFrom",         kOpTransBlit,        kXRGB8888, kXRGB8888, kDispatchKeyBlit },
+	{ "transBlitFrom",         kOpTransBlit,        kRGBA8888, kRGBA8888, kDispatchNone },
+	{ "transBlitFrom flipped", kOpTransBlitFlipped, kCLUT8,    kCLUT8,    kDispatchKeyBlit },
+	{ "transBlitFrom scaled",  kOpTransBlitScaled,  kCLUT8,    kCLUT8,    kDispatchNone },
+	{ "blendBlitTo",           kOpBlendBlit,        kRGBA8888, kRGBA8888, kDispatchBlendBlit },
+	{ "blendBlitTo scaled",    kOpBlendBlitScaled,  kRGBA8888, kRGBA8888, kDispatchBlendBlit },
+	{ "blendBlitTo tinted",    kOpBlendBlitTinted,  kRGBA8888, kRGBA8888, kDispatchBlendBlit },
+	{ "scale",                 kOpScale,            kRGBA8888, kRGBA8888, kDispatchNone },
+	{ "scale bilinear",        kOpScaleBilinear,    kRGBA8888, kRGBA8888, kDispatchNone }
+};
+
+const BlitSuite::Size BlitSuite::kSizes[] = {
+	{ 64, 64 },
+	{ 320, 200 },
+	{ 640, 480 }
+};
+
+const char *const BlitSuite::kFormatNames[] = {
+	"CLUT8",
+	"RGB555",
+	"RGB565",
+	"RGB888",
+	"XRGB8888",
+	"ARGB8888",
+	"RGBA8888",
+	"ABGR8888"
+};
+
+const char *const BlitSuite::kImplNames[] = {
+	"generic",
+	"SSE2",
+	"AVX2",
+	"NEON"
+};
+
+void BlitSuite::run(const Options &opts, Common::Array<Result> &results) {
+	for (int size = 0; size < ARRAYSIZE(kSizes); size++) {
+		for (int c = 0; c < ARRAYSIZE(kCases); c++) {
+			const Case &blitCase = kCases[c];
+
+			for (int impl = 0; impl < kImplCount; impl++) {
+				if (!selectImpl(blitCase.dispatch, (Impl)impl))
+					continue;
+
+				Result result;
+				result.suite = getName();
+				result.name = Common::String::format("%s %s", blitCase.name, kFormatNames[blitCase.srcFormat]);
+				if (blitCase.dstFormat != blitCase.srcFormat)
+					result.name += Common::String(">") + kFormatNames[blitCase.dstFormat];
+				result.name += Common::String::format(" [%dx%d", kSizes[size].w, kSizes[size].h);
+				if (blitCase.dispatch != kDispatchNone)
+					result.name += Common::String(", ") + kImplNames[impl];
+				result.name += "]";
+				result.unitName = "Mpix";
+				result.unitScale = 1e-6;
+
+				if (opts.sampleFilter.empty() || result.name.contains(opts.sampleFilter))
+					runCase(opts, blitCase, kSizes[size].w, kSizes[size].h, result);
+				else
+					continue;
+
+				results.push_back(result);
+			}
+		}
+	}
+
+	resetImpl();
+}
+
+Suite *createBlitSuite() {
+	return new BlitSuite();
+}
+
+} // End of namespace Benchmark
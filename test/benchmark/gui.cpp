@@ -0,0 +1,292 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+#include "test/golden.h"
+
+#include "common/ptr.h"
+
+#include "graphics/managed_surface.h"
+#include "graphics/VectorRenderer.h"
+
+#include "gui/DrawStepParser.h"
+
+namespace Benchmark {
+
+namespace {
+#include "gui/themes/default.inc"
+}
+
+/**
+ * Collects the drawing steps of a theme description, parsing them as the
+ * ThemeParser does. Only the keys holding the palette, the drawing step
+ * defaults and the steps are handled. Everything else, like the fonts,
+ * bitmaps and layouts, is skipped, and so are the bitmap steps.
+ */
+class StepParser : public GUI::DrawStepParser {
+public:
+	StepParser(int width, int height, int scale) {
+		setBaseResolution(width, height, scale);
+	}
+
+	const Common::Array<Graphics::DrawStep> &getSteps() const { return _steps; }
+
+protected:
+	CUSTOM_XML_PARSER(StepParser) {
+		XML_KEY(render_info)
+			XML_PROP(resolution, false)
+			XML_KEY(palette)
+				XML_KEY(color)
+					XML_PROP(name, true)
+					XML_PROP(rgb, true)
+				KEY_END()
+			KEY_END()
+
+			XML_KEY(defaults)
+				XML_PROP(stroke, false)
+				XML_PROP(shadow, false)
+				XML_PROP(bevel, false)
+				XML_PROP(factor, false)
+				XML_PROP(fg_color, false)
+				XML_PROP(bg_color, false)
+				XML_PROP(gradient_start, false)
+				XML_PROP(gradient_end, false)
+				XML_PROP(bevel_color, false)
+				XML_PROP(gradient_factor, false)
+				XML_PROP(fill, false)
+			KEY_END()
+
+			XML_KEY(drawdata)
+				XML_PROP(id, true)
+				XML_PROP(cache, false)
+				XML_PROP(resolution, false)
+
+				XML_KEY(defaults)
+					XML_PROP(stroke, false)
+					XML_PROP(shadow, false)
+					XML_PROP(bevel, false)
+					XML_PROP(factor, false)
+					XML_PROP(fg_color, false)
+					XML_PROP(bg_color, false)
+					XML_PROP(gradient_start, false)
+					XML_PROP(gradient_end, false)
+					XML_PROP(bevel_color, false)
+					XML_PROP(gradient_factor, false)
+					XML_PROP(fill, false)
+				KEY_END()
+
+				XML_KEY(drawstep)
+					XML_PROP(func, true)
+					XML_PROP(stroke, false)
+					XML_PROP(shadow, false)
+					XML_PROP(bevel, false)
+					XML_PROP(factor, false)
+					XML_PROP(fg_color, false)
+					XML_PROP(bg_color, false)
+					XML_PROP(gradient_start, false)
+					XML_PROP(gradient_end, false)
+					XML_PROP(gradient_factor, false)
+					XML_PROP(bevel_color, false)
+					XML_PROP(fill, false)
+					XML_PROP(radius, false)
+					XML_PROP(width, false)
+					XML_PROP(height, false)
+					XML_PROP(xpos, false)
+					XML_PROP(ypos, false)
+					XML_PROP(padding, false)
+					XML_PROP(orientation, false)
+					XML_PROP(file, false)
+					XML_PROP(autoscale, false)
+					XML_PROP(clip, false)
+				KEY_END()
+			KEY_END()
+		KEY_END()
+	} PARSER_END()
+
+	bool parserCallback_render_info(ParserNode *node) {
+		if (!resolutionCheck(node->values["resolution"]))
+			node->ignore = true;
+		return true;
+	}
+
+	bool parserCallback_drawdata(ParserNode *node) {
+		if (!resolutionCheck(node->values["resolution"])) {
+			node->ignore = true;
+			return true;
+		}
+
+		delete _defaultStepLocal;
+		_defaultStepLocal = nullptr;
+		return true;
+	}
+
+	bool parserCallback_drawstep(ParserNode *node) {
+		// The images are not loaded
+		if (node->values["func"] == "bitmap")
+			return true;
+
+		Graphics::DrawStep *step = createDrawStep(node);
+		if (!step)
+			return false;
+
+		_steps.push_back(*step);
+		delete step;
+		return true;
+	}
+
+	bool handleUnknownKey(ParserNode *node) override {
+		node->ignore = true;
+		node->layout = &_skippedKey;
+		return true;
+	}
+
+private:
+	Common::Array<Graphics::DrawStep> _steps;
+
+	// Layout of the keys which are skipped, so that their children are too
+	CustomXMLKeyLayout _skippedKey;
+};
+
+/**
+ * Draws every DrawStep of a theme with the vector renderers.
+ *
+ * The builtin theme is always drawn; any theme description (*.stx) in the
+ * sample directory is drawn as well, so pointing the runner at gui/themes
+ * also covers the gradients, rounded corners and shadows of the modern
+ * themes. Bitmap steps are skipped, as the images are not loaded.
+ *
+ * Each step is drawn into a widget sized and a dialog sized area, for both
+ * renderers, at 16 and 32 bits per pixel and several overlay resolutions.
+ * The detail column holds a hash of the final surface, so that changes to
+ * the renderers can be checked to be bit exact.
+ */
+class GUISuite : public Suite {
+public:
+	const char *getName() const override { return "gui"; }
+	const char *getDescription() const override { return "Vector renderer, drawing every step of a theme (*.stx)"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		static const char *const extensions[] = { "stx", nullptr };
+
+		Common::String builtin;
+		for (int i = 0; i < ARRAYSIZE(defaultXML); i++)
+			builtin += defaultXML[i];
+
+		if (opts.sampleFilter.empty() || Common::String("builtin").contains(opts.sampleFilter))
+			runTheme(opts, "builtin", builtin, results);
+
+		Common::FSList samples;
+		findSamples(opts, extensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+			if (data) {
+				runTheme(opts, it->getName(), Common::String((const char *)data, size), results);
+				free(data);
+			}
+		}
+	}
+
+private:
+	struct Mode {
+		int width, height, scale;
+	};
+
+	void runTheme(const Options &opts, const Common::String &name, const Common::String &xml, Common::Array<Result> &results) {
+		static const Mode modes[] = {
+			{ 320, 200, 1 },
+			{ 640, 480, 1 },
+			{ 1280, 960, 2 }
+		};
+		static const int renderers[] = {
+			GUI::ThemeEngine::kGfxStandard,
+#ifndef DISABLE_FANCY_THEMES
+			GUI::ThemeEngine::kGfxAntialias,
+#endif
+		};
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int mode = 0; mode < ARRAYSIZE(modes); mode++) {
+			StepParser parser(modes[mode].width, modes[mode].height, modes[mode].scale);
+			if (!parser.loadBuffer((const byte *)xml.c_str(), xml.size()) || !parser.parse() || parser.getSteps().empty())
+				continue;
+
+			const Common::Array<Graphics::DrawStep> &steps = parser.getSteps();
+
+			const int w = modes[mode].width;
+			const int h = modes[mode].height;
+			const Common::Rect clip(w, h);
+			const Common::Rect areas[] = {
+				Common::Rect(8, 8, 8 + w / 5, 8 + h / 14),
+				Common::Rect(w / 10, h / 10, w - w / 10, h - h / 10)
+			};
+
+			for (int renderer = 0; renderer < ARRAYSIZE(renderers); renderer++) {
+				for (int format = 0; format < ARRAYSIZE(formats); format++) {
+					Result result;
+					result.suite = getName();
+					result.name = Common::String::format("%s [%s, %dbpp, %dx%d]", name.c_str(),
+						renderers[renderer] == GUI::ThemeEngine::kGfxStandard ? "standard" : "antialias",
+						formats[format].bytesPerPixel * 8, w, h);
+					result.unitName = "step";
+
+					{
+						Measurement m(opts, result);
+						Common::ScopedPtr<Graphics::VectorRenderer> vr(Graphics::createRenderer(renderers[renderer], formats[format]));
+						Graphics::ManagedSurface surface(w, h, formats[format]);
+						vr->setSurface(&surface);
+
+						while (m.next()) {
+							surface.clear();
+							for (uint i = 0; i < steps.size(); i++)
+								for (int area = 0; area < ARRAYSIZE(areas); area++)
+									vr->drawStep(areas[area], clip, steps[i]);
+
+							m.addUnits(steps.size() * ARRAYSIZE(areas));
+							m.addBytes(surface.pitch * h);
+
+							if (result.iterations == 1)
+								result.detail = Common::String::format("%u steps, hash %08x", steps.size(), hashSurface(surface));
+						}
+					}
+
+					results.push_back(result);
+				}
+			}
+		}
+	}
+
+	static uint32 hashSurface(const Graphics::ManagedSurface &surface) {
+		uint32 hash = kFnv1aBasis;
+		fnv1a(hash, surface.rawSurface());
+		return hash;
+	}
+};
+
+Suite *createGUISuite() {
+	return new GUISuite();
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,253 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+#include "image/bmp.h"
+#include "image/cel_3do.h"
+#include "image/gif.h"
+#include "image/iff.h"
+#include "image/jpeg.h"
+#include "image/pcx.h"
+#include "image/pict.h"
+#include "image/png.h"
+#include "image/tga.h"
+#include "image/xbm.h"
+#include "image/codecs/codec.h"
+
+namespace Benchmark {
+
+static Image::ImageDecoder *createImageDecoder(const Common::String &ext) {
+	if (ext == "bmp")
+		return new Image::BitmapDecoder();
+	if (ext == "cel")
+		return new Image::Cel3DODecoder();
+	if (ext == "gif")
+		return new Image::GIFDecoder();
+	if (ext == "iff" || ext == "lbm" || ext == "ilbm")
+		return new Image::IFFDecoder();
+	if (ext == "jpg" || ext == "jpeg")
+		return new Image::JPEGDecoder();
+	if (ext == "pcx")
+		return new Image::PCXDecoder();
+	if (ext == "pict" || ext == "pic")
+		return new Image::PICTDecoder();
+	if (ext == "png")
+		return new Image::PNGDecoder();
+	if (ext == "tga")
+		return new Image::TGADecoder();
+	if (ext == "xbm")
+		return new Image::XBMDecoder();
+	return nullptr;
+}
+
+class ImageSuite : public Suite {
+public:
+	const char *getName() const override { return "image"; }
+	const char *getDescription() const override { return "Still image decoders (BMP, GIF, IFF, JPEG, PCX, PICT, PNG, TGA, XBM, 3DO CEL)"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		static const char *const extensions[] = {
+			"bmp", "cel", "iff", "lbm", "ilbm", "pcx", "pict", "pic", "tga", "xbm",
+#ifdef USE_GIF
+			"gif",
+#endif
+#ifdef USE_JPEG
+			"jpg", "jpeg",
+#endif
+#ifdef USE_PNG
+			"png",
+#endif
+			nullptr
+		};
+
+		Common::FSList samples;
+		findSamples(opts, extensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			Result result;
+			result.suite = getName();
+			result.name = it->getName();
+			result.unitName = "img";
+
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+			Common::String ext = getExtension(result.name);
+
+			{
+				Measurement m(opts, result);
+				if (!data)
+					m.fail("unable to read file");
+
+				while (m.next()) {
+					Common::ScopedPtr<Image::ImageDecoder> decoder(createImageDecoder(ext));
+					Common::MemoryReadStream stream(data, size);
+
+					if (!decoder->loadStream(stream) || !decoder->getSurface()) {
+						m.fail("decoding failed");
+						break;
+					}
+
+					if (result.iterations == 1) {
+						const Graphics::Surface *surface = decoder->getSurface();
+						result.detail = Common::String::format("%dx%d %s", surface->w, surface->h,
+							surface->format.toString().c_str());
+					}
+
+					m.addUnits(1);
+					m.addBytes(size);
+				}
+			}
+
+			free(data);
+			results.push_back(result);
+		}
+	}
+};
+
+/**
+ * Benchmark for Image::Codec implementations.
+ *
+ * Codecs have no container of their own, so the samples are raw frame
+ * dumps (*.frames) with the following layout:
+ *
+ *	'FRMS'            magic
+ *	uint32BE          container: 'AVI ' for createBitmapCodec(), 'QT  ' for createQuickTimeCodec()
+ *	uint32BE          compression tag, e.g. 'cvid'
+ *	uint32BE          AVI stream handler tag, or 0
+ *	uint16LE          width
+ *	uint16LE          height
+ *	uint16LE          bits per pixel
+ *	uint32LE          frame count
+ *
+ * followed by, for each frame, a uint32LE size and the frame data as it
+ * would be passed to Codec::decodeFrame().
+ */
+class CodecSuite : public Suite {
+public:
+	const char *getName() const override { return "codec"; }
+	const char *getDescription() const override { return "Image::Codec frame decoders, fed from raw frame dumps (*.frames)"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		static const char *const extensions[] = { "frames", nullptr };
+
+		Common::FSList samples;
+		findSamples(opts, extensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			Result result;
+			result.suite = getName();
+			result.name = it->getName();
+			result.unitName = "frame";
+
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+			Header header;
+			Common::Array<Common::MemoryReadStream *> frames;
+
+			{
+				Measurement m(opts, result);
+				if (!data || !parseDump(data, size, header, frames))
+					m.fail("not a valid frame dump");
+
+				while (m.next()) {
+					Common::ScopedPtr<Image::Codec> codec(createCodec(header));
+					if (!codec) {
+						m.fail(Common::String::format("no codec for '%s'", tag2str(header.tag)));
+						break;
+					}
+
+					for (uint i = 0; i < frames.size(); i++) {
+						frames[i]->seek(0);
+						if (codec->decodeFrame(*frames[i]))
+							m.addUnits(1);
+						m.addBytes(frames[i]->size());
+					}
+
+					if (result.iterations == 1)
+						result.detail = Common::String::format("%s %dx%d -> %s", tag2str(header.tag),
+							header.width, header.height, codec->getPixelFormat().toString().c_str());
+				}
+			}
+
+			for (uint i = 0; i < frames.size(); i++)
+				delete frames[i];
+			free(data);
+			results.push_back(result);
+		}
+	}
+
+private:
+	struct Header {
+		uint32 container;
+		uint32 tag;
+		uint32 streamTag;
+		uint16 width;
+		uint16 height;
+		uint16 bitsPerPixel;
+	};
+
+	static bool parseDump(const byte *data, uint32 size, Header &header, Common::Array<Common::MemoryReadStream *> &frames) {
+		Common::MemoryReadStream stream(data, size);
+
+		if (stream.readUint32BE() != MKTAG('F', 'R', 'M', 'S'))
+			return false;
+
+		header.container = stream.readUint32BE();
+		header.tag = stream.readUint32BE();
+		header.streamTag = stream.readUint32BE();
+		header.width = stream.readUint16LE();
+		header.height = stream.readUint16LE();
+		header.bitsPerPixel = stream.readUint16LE();
+		uint32 frameCount = stream.readUint32LE();
+
+		for (uint32 i = 0; i < frameCount; i++) {
+			uint32 frameSize = stream.readUint32LE();
+			if (stream.eos() || frameSize > stream.size() - stream.pos())
+				return false;
+
+			frames.push_back(new Common::MemoryReadStream(data + stream.pos(), frameSize));
+			stream.skip(frameSize);
+		}
+
+		return !stream.err();
+	}
+
+	static Image::Codec *createCodec(const Header &header) {
+		if (header.container == MKTAG('Q', 'T', ' ', ' '))
+			return Image::createQuickTimeCodec(header.tag, header.width, header.height, header.bitsPerPixel);
+		return Image::createBitmapCodec(header.tag, header.streamTag, header.width, header.height, header.bitsPerPixel);
+	}
+};
+
+Suite *createImageSuite() {
+	return new ImageSuite();
+}
+
+Suite *createCodecSuite() {
+	return new CodecSuite();
+}
+
+} // End of namespace Benchmark
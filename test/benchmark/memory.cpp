@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Allocation accounting for the benchmark runner.
+//
+// With glibc the malloc family is interposed, so that both operator new and
+// the plain malloc/calloc calls used by e.g. Graphics::Surface are counted.
+// Everywhere else only the global operator new/delete are replaced, which
+// still covers most of the allocations made by the decoders.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "test/benchmark/benchmark.h"
+
+#include <stdlib.h>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace Benchmark {
+
+// The counters are intentionally plain integers: every suite runs its
+// workload on the main thread, so the accounting is not synchronised.
+static AllocStats s_allocStats = { 0, 0, 0 };
+
+static inline void trackAlloc(size_t size) {
+	s_allocStats.allocCount++;
+	s_allocStats.liveBytes += size;
+	if (s_allocStats.liveBytes > s_allocStats.peakBytes)
+		s_allocStats.peakBytes = s_allocStats.liveBytes;
+}
+
+static inline void trackFree(size_t size) {
+	s_allocStats.liveBytes -= size;
+}
+
+AllocStats getAllocStats() {
+	return s_allocStats;
+}
+
+void resetAllocPeak() {
+	s_allocStats.peakBytes = s_allocStats.liveBytes;
+}
+
+} // End of namespace Benchmark
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size) {
+	void *ptr = __libc_malloc(size);
+	if (ptr)
+		Benchmark::trackAlloc(malloc_usable_size(ptr));
+	return ptr;
+}
+
+void *calloc(size_t count, size_t size) {
+	void *ptr = __libc_calloc(count, size);
+	if (ptr)
+		Benchmark::trackAlloc(malloc_usable_size(ptr));
+	return ptr;
+}
+
+void *realloc(void *ptr, size_t size) {
+	size_t oldSize = ptr ? malloc_usable_size(ptr) : 0;
+	void *newPtr = __libc_realloc(ptr, size);
+	if (newPtr) {
+		Benchmark::trackFree(oldSize);
+		Benchmark::trackAlloc(malloc_usable_size(newPtr));
+	} else if (size == 0) {
+		Benchmark::trackFree(oldSize);
+	}
+	return newPtr;
+}
+
+void *memalign(size_t alignment, size_t size) {
+	void *ptr = __libc_memalign(alignment, size);
+	if (ptr)
+		Benchmark::trackAlloc(malloc_usable_size(ptr));
+	return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+	return memalign(alignment, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size) {
+	void *ptr = memalign(alignment, size);
+	if (!ptr)
+		return 12; // ENOMEM
+	*memptr = ptr;
+	return 0;
+}
+
+void free(void *ptr) {
+	if (!ptr)
+		return;
+	Benchmark::trackFree(malloc_usable_size(ptr));
+	__libc_free(ptr);
+}
+
+} // End of extern "C"
+
+#else
+
+// Store the size in front of each block so that delete can account for it.
+// The header is 16 bytes to keep the returned pointer suitably aligned.
+static const size_t kHeaderSize = 16;
+
+static void *trackedNew(size_t size) {
+	byte *ptr = (byte *)malloc(size + kHeaderSize);
+	if (!ptr)
+		return nullptr;
+	*(size_t *)ptr = size;
+	Benchmark::trackAlloc(size);
+	return ptr + kHeaderSize;
+}
+
+static void trackedDelete(void *ptr) {
+	if (!ptr)
+		return;
+	byte *block = (byte *)ptr - kHeaderSize;
+	Benchmark::trackFree(*(size_t *)block);
+	free(block);
+}
+
+static void *trackedNewOrAbort(size_t size) {
+	void *ptr = trackedNew(size);
+	if (!ptr)
+		abort();
+	return ptr;
+}
+
+void *operator new(size_t size) { return trackedNewOrAbort(size); }
+void *operator new[](size_t size) { return trackedNewOrAbort(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return trackedNew(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return trackedNew(size); }
+void operator delete(void *ptr) noexcept { trackedDelete(ptr); }
+void operator delete[](void *ptr) noexcept { trackedDelete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { trackedDelete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { trackedDelete(ptr); }
+
+#endif
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+#include "test/golden.h"
+
+#include "audio/audiostream.h"
+#include "audio/mods/mod_xm_s3m.h"
+#include "audio/mods/protracker.h"
+
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+namespace Benchmark {
+
+/**
+ * Renders tracker modules headless with each of the interpolation modes.
+ *
+ * Every module (*.mod, *.xm, *.s3m) is played by the ModXmS3m player;
+ * ProTracker modules are also played by the Paula based player. At most
+ * the first kRenderSeconds of each module are rendered. The detail column
+ * holds a hash of the output, so that changes to the mixers can be checked
+ * to be bit exact.
+ */
+class ModsSuite : public Suite {
+public:
+	const char *getName() const override { return "mods"; }
+	const char *getDescription() const override { return "Tracker module players (*.mod, *.xm, *.s3m)"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		static const char *const extensions[] = { "mod", "xm", "s3m", nullptr };
+		static const char *const interpolations[] = { "none", "linear", "cubic", nullptr };
+
+		Common::FSList samples;
+		findSamples(opts, extensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+			bool valid = false;
+			if (data) {
+				Common::MemoryReadStream stream(data, size);
+				valid = Audio::probeModXmS3m(&stream);
+			}
+
+			const bool protracker = getExtension(it->getName()) == "mod";
+
+			for (int player = 0; player < 2; player++) {
+				if (player == 1 && (!valid || !protracker))
+					break;
+
+				for (int interpolation = 0; interpolations[interpolation]; interpolation++) {
+					Result result;
+					result.suite = getName();
+					result.name = Common::String::format("%s [%s, %s]", it->getName().c_str(),
+						player ? "paula" : "modxms3m", interpolations[interpolation]);
+					result.unitName = "sample";
+
+					{
+						Measurement m(opts, result);
+						if (!valid)
+							m.fail("not a supported module");
+
+						while (m.next()) {
+							Common::MemoryReadStream stream(data, size);
+							Common::ScopedPtr<Audio::AudioStream> audio;
+							if (player) {
+								Modules::ProtrackerStream *paula = new Modules::ProtrackerStream(&stream, 0, kRate, true);
+								paula->setInterpolation((Audio::Paula::InterpolationMode)interpolation);
+								audio.reset(paula);
+							} else {
+								audio.reset(Audio::makeModXmS3mStream(&stream, DisposeAfterUse::NO, 0, kRate, interpolation));
+							}
+
+							if (!audio) {
+								m.fail("unable to create the player");
+								break;
+							}
+
+							uint32 hash = kFnv1aBasis;
+							const uint32 frames = render(audio.get(), hash);
+							m.addUnits(frames);
+							m.addBytes(size);
+
+							if (result.iterations == 1)
+								result.detail = Common::String::format("%u.%03u s, hash %08x",
+									frames / kRate, frames % kRate * 1000 / kRate, hash);
+						}
+					}
+
+					results.push_back(result);
+					if (!valid)
+						break;
+				}
+
+				if (!valid)
+					break;
+			}
+
+			free(data);
+		}
+	}
+
+private:
+	enum {
+		kRate = 44100,
+		kRenderSeconds = 60,
+		kBufferFrames = 1024
+	};
+
+	static uint32 render(Audio::AudioStream *audio, uint32 &hash) {
+		int16 buffer[kBufferFrames * 2];
+		uint32 frames = 0;
+
+		while (frames < kRate * kRenderSeconds && !audio->endOfData()) {
+			const int count = audio->readBuffer(buffer, kBufferFrames * 2);
+			if (count <= 0)
+				break;
+
+			fnv1a(hash, buffer, count);
+			frames += count / 2;
+		}
+
+		return frames;
+	}
+};
+
+Suite *createModsSuite() {
+	return new ModsSuite();
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,241 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+#include "test/golden.h"
+
+#include "audio/fmopl.h"
+
+#include "common/config-manager.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+namespace Benchmark {
+
+/**
+ * Replays OPL register logs through each of the OPL emulators.
+ *
+ * The samples are DOSBox Raw OPL v2.0 captures (*.dro), as written by
+ * DOSBox or by running ScummVM with --dump-opl. The log is rendered at the
+ * mixer rate; the detail column holds a hash of the output, so that changes
+ * to an emulator can be checked to be bit exact.
+ */
+class OPLSuite : public Suite {
+public:
+	const char *getName() const override { return "opl"; }
+	const char *getDescription() const override { return "OPL emulators, replaying register logs (*.dro)"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		static const char *const extensions[] = { "dro", nullptr };
+		static const char *const emulators[] = { "mame", "db", "nuked", nullptr };
+
+		// The emulators are created through OPL::Config, which checks this
+		ConfMan.registerDefault("dump_opl", false);
+
+		Common::FSList samples;
+		findSamples(opts, extensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+			Log log;
+			bool valid = data && parseLog(data, size, log);
+
+			for (const char *const *emulator = emulators; *emulator; emulator++) {
+				OPL::Config::DriverId driver = OPL::Config::parse(*emulator);
+				const OPL::Config::EmulatorDescription *desc = OPL::Config::findDriver(driver);
+				if (valid && (!desc || !(desc->flags & typeFlag(log.type))))
+					continue;
+
+				Result result;
+				result.suite = getName();
+				result.name = Common::String::format("%s [%s]", it->getName().c_str(), *emulator);
+				result.unitName = "sample";
+
+				{
+					Measurement m(opts, result);
+					if (!valid)
+						m.fail("not a valid DRO v2 log");
+
+					while (m.next()) {
+						Common::ScopedPtr<OPL::OPL> opl(OPL::Config::create(driver, log.type));
+						if (!opl || !opl->init()) {
+							m.fail("unable to create the emulator");
+							break;
+						}
+
+						uint32 hash = kFnv1aBasis;
+						m.addUnits(replay(static_cast<OPL::EmulatedOPL *>(opl.get()), log, hash));
+						m.addBytes(log.writes.size() * 2);
+
+						if (result.iterations == 1)
+							result.detail = Common::String::format("%s, %u.%03u s, hash %08x", typeName(log.type),
+								log.length / 1000, log.length % 1000, hash);
+					}
+				}
+
+				results.push_back(result);
+				if (!valid)
+					break;
+			}
+
+			free(data);
+		}
+	}
+
+private:
+	struct Write {
+		uint32 time;
+		uint16 reg;
+		byte value;
+	};
+
+	struct Log {
+		OPL::Config::OplType type;
+		uint32 length;
+		Common::Array<Write> writes;
+	};
+
+	enum {
+		kBufferFrames = 1024
+	};
+
+	static bool parseLog(const byte *data, uint32 size, Log &log) {
+		Common::MemoryReadStream stream(data, size);
+
+		char magic[8];
+		stream.read(magic, 8);
+		if (memcmp(magic, "DBRAWOPL", 8) || stream.readUint16LE() != 2 || stream.readUint16LE() != 0)
+			return false;
+
+		uint32 pairs = stream.readUint32LE();
+		log.length = stream.readUint32LE();
+
+		switch (stream.readByte()) {
+		case 0:
+			log.type = OPL::Config::kOpl2;
+			break;
+		case 1:
+			log.type = OPL::Config::kDualOpl2;
+			break;
+		case 2:
+			log.type = OPL::Config::kOpl3;
+			break;
+		default:
+			return false;
+		}
+
+		// Only uncompressed, interleaved logs exist in practice
+		if (stream.readByte() != 0 || stream.readByte() != 0)
+			return false;
+
+		byte shortDelayCode = stream.readByte();
+		byte longDelayCode = stream.readByte();
+		byte codeMapLength = stream.readByte();
+		if (codeMapLength > 128)
+			return false;
+
+		byte codeMap[128];
+		stream.read(codeMap, codeMapLength);
+
+		uint32 time = 0;
+		for (uint32 i = 0; i < pairs; i++) {
+			byte code = stream.readByte();
+			byte value = stream.readByte();
+			if (stream.eos())
+				return false;
+
+			if (code == shortDelayCode) {
+				time += value + 1;
+			} else if (code == longDelayCode) {
+				time += (value + 1) << 8;
+			} else if ((code & 0x7F) < codeMapLength) {
+				Write write;
+				write.time = time;
+				write.reg = codeMap[code & 0x7F] | ((code & 0x80) << 1);
+				write.value = value;
+				log.writes.push_back(write);
+			}
+		}
+
+		log.length = MAX(log.length, time);
+		return !stream.err();
+	}
+
+	static uint32 replay(OPL::EmulatedOPL *opl, const Log &log, uint32 &hash) {
+		const uint32 rate = opl->getRate();
+		const int channels = opl->isStereo() ? 2 : 1;
+		int16 buffer[kBufferFrames * 2];
+		uint32 frames = 0;
+
+		// Timing is done by the replay, but the callback frequency has to be
+		// set for readBuffer() to work
+		opl->setCallbackFrequency(OPL::OPL::kDefaultCallbackFrequency);
+
+		for (uint i = 0; i <= log.writes.size(); i++) {
+			const uint32 time = (i < log.writes.size()) ? log.writes[i].time : log.length;
+			const uint32 target = (uint64)time * rate / 1000;
+
+			while (frames < target) {
+				const uint32 count = MIN<uint32>(target - frames, kBufferFrames);
+				opl->readBuffer(buffer, count * channels);
+				fnv1a(hash, buffer, count * channels);
+				frames += count;
+			}
+
+			if (i < log.writes.size()) {
+				const int port = (log.writes[i].reg & 0x100) ? 0x222 : 0x220;
+				opl->write(port, log.writes[i].reg & 0xFF);
+				opl->write(port + 1, log.writes[i].value);
+			}
+		}
+
+		return frames;
+	}
+
+	static uint32 typeFlag(OPL::Config::OplType type) {
+		switch (type) {
+		case OPL::Config::kDualOpl2:
+			return OPL::Config::kFlagDualOpl2;
+		case OPL::Config::kOpl3:
+			return OPL::Config::kFlagOpl3;
+		default:
+			return OPL::Config::kFlagOpl2;
+		}
+	}
+
+	static const char *typeName(OPL::Config::OplType type) {
+		switch (type) {
+		case OPL::Config::kDualOpl2:
+			return "dual OPL2";
+		case OPL::Config::kOpl3:
+			return "OPL3";
+		default:
+			return "OPL2";
+		}
+	}
+};
+
+Suite *createOPLSuite() {
+	return new OPLSuite();
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/benchmark/benchmark.h"
+
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+#include "video/3do_decoder.h"
+#include "video/avi_decoder.h"
+#include "video/coktel_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/hnm_decoder.h"
+#include "video/mpegps_decoder.h"
+#include "video/mve_decoder.h"
+#include "video/paco_decoder.h"
+#include "video/psx_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+
+#ifdef USE_BINK
+#include "video/bink_decoder.h"
+#endif
+
+#ifdef USE_THEORADEC
+#include "video/theora_decoder.h"
+#endif
+
+#ifdef USE_VPX
+#include "video/mkv_decoder.h"
+#endif
+
+namespace Benchmark {
+
+static const char *const videoExtensions[] = {
+	"avi", "mov", "qt", "smk", "dxa", "flc", "fli", "hnm", "mpg", "mpeg",
+	"mve", "paco", "str", "stream",
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+	"vmd",
+#endif
+#ifdef USE_BINK
+	"bik",
+#endif
+#ifdef USE_THEORADEC
+	"ogv",
+#endif
+#ifdef USE_VPX
+	"mkv", "webm",
+#endif
+	nullptr
+};
+
+/**
+ * Create a decoder for the given extension. Some containers are used with
+ * several decoder configurations; 'variant' selects the next one to try.
+ */
+static Video::VideoDecoder *createVideoDecoder(const Common::String &ext, int variant) {
+	if (ext == "hnm") {
+		// HNM4/UBB2 are paletted, HNM6 needs a true color output format
+		if (variant == 0)
+			return new Video::HNMDecoder(Graphics::PixelFormat::createFormatCLUT8());
+		if (variant == 1)
+			return new Video::HNMDecoder(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		return nullptr;
+	}
+
+	if (variant != 0)
+		return nullptr;
+
+	if (ext == "avi")
+		return new Video::AVIDecoder();
+	if (ext == "mov" || ext == "qt")
+		return new Video::QuickTimeDecoder();
+	if (ext == "smk")
+		return new Video::SmackerDecoder();
+	if (ext == "dxa")
+		return new Video::DXADecoder();
+	if (ext == "flc" || ext == "fli")
+		return new Video::FlicDecoder();
+	if (ext == "mpg" || ext == "mpeg")
+		return new Video::MPEGPSDecoder();
+	if (ext == "mve")
+		return new Video::MveDecoder();
+	if (ext == "paco")
+		return new Video::PacoDecoder();
+	if (ext == "str")
+		return new Video::PSXStreamDecoder(Video::PSXStreamDecoder::kCD2x);
+#if defined(ENABLE_GOB) || defined(ENABLE_SCI32) || defined(DYNAMIC_MODULES)
+	if (ext == "vmd")
+		return new Video::AdvancedVMDDecoder();
+#endif
+	if (ext == "stream")
+		return new Video::ThreeDOMovieDecoder();
+#ifdef USE_BINK
+	if (ext == "bik")
+		return new Video::BinkDecoder();
+#endif
+#ifdef USE_THEORADEC
+	if (ext == "ogv")
+		return new Video::TheoraDecoder();
+#endif
+#ifdef USE_VPX
+	if (ext == "mkv" || ext == "webm")
+		return new Video::MKVDecoder();
+#endif
+	return nullptr;
+}
+
+static Video::VideoDecoder *loadVideo(const Common::String &ext, const byte *data, uint32 size) {
+	for (int variant = 0; ; variant++) {
+		Video::VideoDecoder *decoder = createVideoDecoder(ext, variant);
+		if (!decoder)
+			return nullptr;
+
+		if (decoder->loadStream(new Common::MemoryReadStream(data, size)))
+			return decoder;
+
+		delete decoder;
+	}
+}
+
+/**
+ * Decodes every frame of each sample video. Audio tracks are demuxed as a
+ * side effect of reading the packets, but the videos are never started, so
+ * nothing is sent to the (non-existent) mixer.
+ */
+class VideoSuite : public Suite {
+public:
+	const char *getName() const override { return "video"; }
+	const char *getDescription() const override { return "Video::VideoDecoder implementations, decoding every frame"; }
+
+	void run(const Options &opts, Common::Array<Result> &results) override {
+		Common::FSList samples;
+		findSamples(opts, videoExtensions, samples);
+
+		for (Common::FSList::const_iterator it = samples.begin(); it != samples.end(); ++it) {
+			Result result;
+			result.suite = getName();
+			result.name = it->getName();
+			result.unitName = "frame";
+
+			Common::String ext = getExtension(result.name);
+			uint32 size = 0;
+			byte *data = readSample(*it, size);
+
+			{
+				Measurement m(opts, result);
+				if (!data)
+					m.fail("unable to read file");
+
+				while (m.next()) {
+					Common::ScopedPtr<Video::VideoDecoder> decoder(loadVideo(ext, data, size));
+					if (!decoder) {
+						m.fail("loading failed");
+						break;
+					}
+
+					// Some decoders never flag the end of their (unplayed) audio
+					// tracks, so stop as soon as no further video frame is produced.
+					for (;;) {
+						int curFrame = decoder->getCurFrame();
+						const Graphics::Surface *frame = decoder->decodeNextFrame();
+						if (decoder->getCurFrame() == curFrame)
+							break;
+						if (frame)
+							m.addUnits(1);
+					}
+
+					m.addBytes(size);
+
+					if (result.iterations == 1)
+						result.detail = Common::String::format("%dx%d %s, %d frames", decoder->getWidth(), decoder->getHeight(),
+							decoder->getPixelFormat().toString().c_str(), decoder->getCurFrame() + 1);
+				}
+			}
+
+			free(data);
+			results.push_back(result);
+		}
+	}
+};
+
+Suite *createVideoSuite() {
+	return new VideoSuite();
+}
+
+} // End of namespace Benchmark
@@ -0,0 +1,36 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/scumm/imuse_digi/dimuse_engine.h"
+#include "engines/scumm/imuse_digi/dimuse_internalmixer.h"
+
+/**
+ * Test suite for the iMUSE Digital internal mixer.
+ *
+ * The mixer used to look the amplitude of 16-bit samples up in the 12-bit
+ * amplitude tables, and now computes it, so that the loops over the samples
+ * can be vectorized. This checks that both give the same result.
+ */
+class DiMUSEInternalMixerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_amp16_matches_amp12_table() {
+		// In low latency mode no stream is created, so no mixer is needed
+		Scumm::IMuseDigiInternalMixer mixer(nullptr, 22050, false, true);
+		uint8 mixBuf[64];
+		TS_ASSERT_EQUALS(mixer.init(16, 2, mixBuf, sizeof(mixBuf), 0, 6), 0);
+
+		int errors = 0;
+		for (int volume = 0; volume <= 16; volume++) {
+			int32 *ampTable = &mixer._amp12Table[volume * 2048];
+			const int32 multiplier = mixer.getAmp12Multiplier(ampTable);
+
+			for (int sample = -32768; sample <= 32767; sample++) {
+				// The table lookup the mixing loops used to do
+				const uint16 expected = *(uint16 *)((uint8 *)ampTable + (((int16)sample & (int16)0xFFF7) >> 3) + 4096);
+
+				if (Scumm::IMuseDigiInternalMixer::amp16((int16)sample, multiplier) != expected)
+					errors++;
+			}
+		}
+
+		TS_ASSERT_EQUALS(errors, 0);
+	}
+};
@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_GOLDEN_H
+#define TEST_GOLDEN_H
+
+#include "common/scummsys.h"
+#include "graphics/surface.h"
+
+// Helpers shared by the golden output tests and the benchmarks, which feed
+// code with pseudo-random input and hash its output, so that optimizations
+// can be checked to be bit exact. Changing them changes all golden hashes.
+
+/**
+ * Pseudo-random number generator giving the same sequence on all
+ * platforms, unlike rand().
+ */
+class GoldenRandom {
+public:
+	GoldenRandom(uint32 seed = 12345) : _seed(seed) {}
+
+	void setSeed(uint32 seed) { _seed = seed; }
+
+	/** Return a number in the range [0, max). max must be at most 32768. */
+	uint next(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 16) & 0x7FFF) % max;
+	}
+
+private:
+	uint32 _seed;
+};
+
+/** Initial value of a 32-bit FNV-1a hash. */
+static const uint32 kFnv1aBasis = 2166136261U;
+
+/** Add a value to a 32-bit FNV-1a hash. */
+inline void fnv1a(uint32 &hash, uint32 value) {
+	hash ^= value;
+	hash *= 16777619;
+}
+
+/** Add 16-bit samples to a 32-bit FNV-1a hash. */
+inline void fnv1a(uint32 &hash, const int16 *samples, int count) {
+	for (int i = 0; i < count; i++)
+		fnv1a(hash, (uint16)samples[i]);
+}
+
+/** Add the bytes of the pixels of a surface to a 32-bit FNV-1a hash. */
+inline void fnv1a(uint32 &hash, const Graphics::Surface &surface) {
+	for (int y = 0; y < surface.h; y++) {
+		const byte *line = (const byte *)surface.getBasePtr(0, y);
+		for (int x = 0; x < surface.w * surface.format.bytesPerPixel; x++)
+			fnv1a(hash, line[x]);
+	}
+}
+
+#endif
@@ -0,0 +1,258 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/blit.h"
+
+#include "../golden.h"
+
+// Tests for the format conversions of crossBlit and crossBlitMap. Every
+// pair of a number of common and uncommon formats is converted, both between
+// two buffers and in place, and the result is compared to converting each
+// pixel with PixelFormat, so that the converters specialized for a pair of
+// formats can be checked to be exact. Every implementation supported by the
+// cpu is tested.
+class CrossBlitTestSuite : public CxxTest::TestSuite
+{
+private:
+	GoldenRandom _random;
+
+	static Graphics::PixelFormat getFormat(int index) {
+		static const byte kFormats[][9] = {
+			{ 2, 5, 6, 5, 0, 11, 5, 0, 0 },  // RGB565
+			{ 2, 5, 5, 5, 0, 10, 5, 0, 0 },  // RGB555
+			{ 2, 5, 5, 5, 1, 10, 5, 0, 15 }, // ARGB1555
+			{ 2, 5, 5, 5, 1, 11, 6, 1, 0 },  // RGBA5551
+			{ 2, 4, 4, 4, 4, 12, 8, 4, 0 },  // RGBA4444
+			{ 2, 4, 4, 4, 4, 8, 4, 0, 12 },  // ARGB4444
+			{ 2, 3, 3, 2, 0, 5, 2, 0, 0 },   // RGB332
+			{ 3, 8, 8, 8, 0, 16, 8, 0, 0 },  // RGB888
+			{ 3, 8, 8, 8, 0, 0, 8, 16, 0 },  // BGR888
+			{ 4, 8, 8, 8, 8, 24, 16, 8, 0 }, // RGBA8888
+			{ 4, 8, 8, 8, 8, 16, 8, 0, 24 }, // ARGB8888
+			{ 4, 8, 8, 8, 8, 0, 8, 16, 24 }, // ABGR8888
+			{ 4, 8, 8, 8, 8, 8, 16, 24, 0 }, // BGRA8888
+			{ 4, 8, 8, 8, 0, 16, 8, 0, 0 },  // XRGB8888
+			{ 4, 8, 8, 8, 0, 0, 8, 16, 0 },  // XBGR8888
+			{ 4, 8, 8, 8, 0, 24, 16, 8, 0 }, // RGBX8888
+			{ 4, 6, 6, 6, 2, 18, 12, 6, 0 }  // RGBA6662
+		};
+
+		if (index >= ARRAYSIZE(kFormats))
+			return Graphics::PixelFormat();
+		const byte *f = kFormats[index];
+		return Graphics::PixelFormat(f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]);
+	}
+
+	static uint32 readPixel(const byte *src, uint bytesPerPixel) {
+		if (bytesPerPixel == 2)
+			return *(const uint16 *)src;
+		if (bytesPerPixel == 4)
+			return *(const uint32 *)src;
+#ifdef SCUMM_BIG_ENDIAN
+		return (src[0] << 16) | (src[1] << 8) | src[2];
+#else
+		return src[0] | (src[1] << 8) | (src[2] << 16);
+#endif
+	}
+
+	// Converts the pixels one by one, as the reference for crossBlit
+	static void convert(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint w, uint h,
+			const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt) {
+		for (uint y = 0; y < h; y++) {
+			for (uint x = 0; x < w; x++) {
+				byte a, r, g, b;
+				srcFmt.colorToARGB(readPixel(src + y * srcPitch + x * srcFmt.bytesPerPixel, srcFmt.bytesPerPixel), a, r, g, b);
+				const uint32 color = dstFmt.ARGBToColor(a, r, g, b);
+				byte *ptr = dst + y * dstPitch + x * dstFmt.bytesPerPixel;
+				if (dstFmt.bytesPerPixel == 2)
+					*(uint16 *)ptr = color;
+				else
+					*(uint32 *)ptr = color;
+			}
+		}
+	}
+
+	void fill(byte *buffer, uint size) {
+		for (uint i = 0; i < size; i++)
+			buffer[i] = _random.next(256);
+	}
+
+	// Converts between two buffers with padding at the end of the lines
+	bool checkBlit(const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt, uint w, uint h) {
+		const uint srcPitch = w * srcFmt.bytesPerPixel + 5;
+		const uint dstPitch = w * dstFmt.bytesPerPixel + 3;
+		byte *src = new byte[h * srcPitch];
+		byte *dst = new byte[h * dstPitch];
+		byte *expected = new byte[h * dstPitch];
+		fill(src, h * srcPitch);
+		fill(dst, h * dstPitch);
+		memcpy(expected, dst, h * dstPitch);
+
+		convert(expected, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt);
+		const bool result = Graphics::crossBlit(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt) &&
+			memcmp(dst, expected, h * dstPitch) == 0;
+
+		delete[] src;
+		delete[] dst;
+		delete[] expected;
+		return result;
+	}
+
+	// Converts within one buffer, with the ratio of the pitches being the
+	// ratio of the pixel sizes
+	bool checkInPlace(const Graphics::PixelFormat &dstFmt, const Graphics::PixelFormat &srcFmt, uint w, uint h) {
+		const uint srcPitch = (w + 2) * srcFmt.bytesPerPixel;
+		const uint dstPitch = (w + 2) * dstFmt.bytesPerPixel;
+		const uint size = h * MAX(srcPitch, dstPitch);
+
+		byte *buffer = new byte[size];
+		byte *src = new byte[size];
+		byte *expected = new byte[size];
+		fill(buffer, size);
+		memcpy(src, buffer, size);
+		memcpy(expected, buffer, size);
+
+		convert(expected, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt);
+		const bool result = Graphics::crossBlit(buffer, buffer, dstPitch, srcPitch, w, h, dstFmt, srcFmt);
+
+		// Only the converted pixels are defined after converting in place
+		bool same = true;
+		for (uint y = 0; y < h; y++) {
+			if (memcmp(buffer + y * dstPitch, expected + y * dstPitch, w * dstFmt.bytesPerPixel) != 0)
+				same = false;
+		}
+
+		delete[] buffer;
+		delete[] src;
+		delete[] expected;
+		return result && same;
+	}
+
+	bool checkBlitMap(uint bytesPerPixel, uint w, uint h, bool inPlace) {
+		uint32 map[256];
+		for (int i = 0; i < 256; i++)
+			map[i] = _random.next(65536) << 16 | _random.next(65536);
+
+		const uint srcPitch = w + 3;
+		const uint dstPitch = inPlace ? srcPitch * bytesPerPixel : w * bytesPerPixel + 1;
+		byte *src = new byte[h * srcPitch];
+		byte *dst = new byte[h * dstPitch];
+		byte *expected = new byte[h * dstPitch];
+		fill(src, h * srcPitch);
+		fill(dst, h * dstPitch);
+		memcpy(expected, dst, h * dstPitch);
+
+		for (uint y = 0; y < h; y++) {
+			for (uint x = 0; x < w; x++) {
+				byte *ptr = expected + y * dstPitch + x * bytesPerPixel;
+				const uint32 color = map[src[y * srcPitch + x]];
+				if (bytesPerPixel == 2)
+					*(uint16 *)ptr = color;
+				else
+					*(uint32 *)ptr = color;
+			}
+		}
+
+		bool result;
+		if (inPlace) {
+			memcpy(dst, src, h * srcPitch);
+			result = Graphics::crossBlitMap(dst, dst, dstPitch, srcPitch, w, h, bytesPerPixel, map);
+		} else {
+			result = Graphics::crossBlitMap(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map);
+		}
+		for (uint y = 0; y < h; y++) {
+			const uint size = inPlace ? w * bytesPerPixel : dstPitch;
+			if (memcmp(dst + y * dstPitch, expected + y * dstPitch, size) != 0)
+				result = false;
+		}
+
+		delete[] src;
+		delete[] dst;
+		delete[] expected;
+		return result;
+	}
+
+	static bool selectImpl(int impl) {
+		Graphics::CrossBlit::shuffleFunc = nullptr;
+		Graphics::CrossBlit::expandFunc = nullptr;
+		Graphics::CrossBlit::funcsSelected = true;
+		Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitGeneric;
+		Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapGeneric;
+
+		switch (impl) {
+		case 0:
+			return true;
+#ifdef SCUMMVM_AVX2
+		case 1:
+			Graphics::CrossBlit::shuffleFunc = Graphics::CrossBlit::shuffleAVX2;
+			Graphics::CrossBlit::expandFunc = Graphics::CrossBlit::expandAVX2;
+			Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapAVX2;
+			return instrset_detect() >= 8;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	static void resetImpl() {
+		Graphics::CrossBlit::funcsSelected = false;
+		Graphics::KeyBlit::blitFunc = nullptr;
+		Graphics::KeyBlit::blitMapFunc = nullptr;
+	}
+
+public:
+	void test_cross_blit() {
+		for (int impl = 0; impl < 2; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			for (int i = 0; getFormat(i).bytesPerPixel; i++) {
+				const Graphics::PixelFormat srcFmt = getFormat(i);
+				for (int j = 0; getFormat(j).bytesPerPixel; j++) {
+					const Graphics::PixelFormat dstFmt = getFormat(j);
+					if (dstFmt.bytesPerPixel == 3 || srcFmt == dstFmt)
+						continue;
+
+					TSM_ASSERT(Common::String::format("%d > %d", i, j).c_str(), checkBlit(dstFmt, srcFmt, 37, 13));
+					TSM_ASSERT(Common::String::format("%d > %d", i, j).c_str(), checkBlit(dstFmt, srcFmt, 3, 2));
+				}
+			}
+		}
+		resetImpl();
+	}
+
+	void test_cross_blit_in_place() {
+		for (int impl = 0; impl < 2; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			for (int i = 0; getFormat(i).bytesPerPixel; i++) {
+				const Graphics::PixelFormat srcFmt = getFormat(i);
+				for (int j = 0; getFormat(j).bytesPerPixel; j++) {
+					const Graphics::PixelFormat dstFmt = getFormat(j);
+					if (dstFmt.bytesPerPixel == 3 || srcFmt == dstFmt)
+						continue;
+
+					TSM_ASSERT(Common::String::format("%d > %d", i, j).c_str(), checkInPlace(dstFmt, srcFmt, 29, 11));
+				}
+			}
+		}
+		resetImpl();
+	}
+
+	void test_cross_blit_map() {
+		for (int impl = 0; impl < 2; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			TS_ASSERT(checkBlitMap(2, 37, 13, false));
+			TS_ASSERT(checkBlitMap(4, 37, 13, false));
+			TS_ASSERT(checkBlitMap(2, 37, 13, true));
+			TS_ASSERT(checkBlitMap(4, 37, 13, true));
+		}
+		resetImpl();
+	}
+};
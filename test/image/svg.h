@@ -0,0 +1,119 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "graphics/svg.h"
+
+// Tests for the document and bitmap caches of SVGBitmap. Images created from
+// the cache, after a document was parsed at another size, or after entries
+// were dropped from the cache are compared to rendering them from scratch.
+class SVGTestSuite : public CxxTest::TestSuite
+{
+private:
+	static Common::String makeDocument(int radius) {
+		return Common::String::format(
+			"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"64\" height=\"48\">"
+			"<defs><linearGradient id=\"g\" x1=\"0\" y1=\"0\" x2=\"1\" y2=\"1\">"
+			"<stop offset=\"0\" stop-color=\"#ff8000\"/><stop offset=\"1\" stop-color=\"#0040ff\" stop-opacity=\"0.5\"/>"
+			"</linearGradient></defs>"
+			"<rect x=\"2\" y=\"3\" width=\"60\" height=\"40\" rx=\"6\" fill=\"url(#g)\"/>"
+			"<circle cx=\"30\" cy=\"22\" r=\"%d\" fill=\"none\" stroke=\"#20c040\" stroke-width=\"3\"/>"
+			"</svg>", radius);
+	}
+
+	static Graphics::SVGBitmap *render(const Common::String &document, int w, int h) {
+		Common::MemoryReadStream stream((const byte *)document.c_str(), document.size());
+		return new Graphics::SVGBitmap(&stream, w, h);
+	}
+
+	static bool equals(const Graphics::ManagedSurface *a, const Graphics::ManagedSurface *b) {
+		if (a->w != b->w || a->h != b->h || a->format != b->format)
+			return false;
+		for (int y = 0; y < a->h; y++) {
+			if (memcmp(a->getBasePtr(0, y), b->getBasePtr(0, y), a->w * a->format.bytesPerPixel) != 0)
+				return false;
+		}
+		return true;
+	}
+
+	static bool isBlank(const Graphics::ManagedSurface *surf) {
+		for (int y = 0; y < surf->h; y++) {
+			const byte *line = (const byte *)surf->getBasePtr(0, y);
+			for (int x = 0; x < surf->w * surf->format.bytesPerPixel; x++) {
+				if (line[x])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Renders the document after clearing the cache
+	static Graphics::SVGBitmap *renderFresh(const Common::String &document, int w, int h) {
+		Graphics::SVGBitmap::clearCache();
+		return render(document, w, h);
+	}
+
+public:
+	void test_cached_bitmap() {
+		const Common::String document = makeDocument(12);
+		Graphics::SVGBitmap *first = renderFresh(document, 37, 23);
+		Graphics::SVGBitmap *cached = render(document, 37, 23);
+		Graphics::SVGBitmap *fresh = renderFresh(document, 37, 23);
+
+		TS_ASSERT(!isBlank(first));
+		TS_ASSERT(equals(first, cached));
+		TS_ASSERT(equals(first, fresh));
+
+		delete first;
+		delete cached;
+		delete fresh;
+		Graphics::SVGBitmap::clearCache();
+	}
+
+	void test_cached_document() {
+		const Common::String document = makeDocument(12);
+		Graphics::SVGBitmap *large = renderFresh(document, 128, 96);
+		Graphics::SVGBitmap *small = render(document, 20, 20);
+		Graphics::SVGBitmap *fresh = renderFresh(document, 20, 20);
+
+		TS_ASSERT(equals(small, fresh));
+		TS_ASSERT(large->w == 128 && small->w == 20);
+
+		delete large;
+		delete small;
+		delete fresh;
+		Graphics::SVGBitmap::clearCache();
+	}
+
+	void test_different_documents() {
+		Graphics::SVGBitmap *first = renderFresh(makeDocument(12), 37, 23);
+		Graphics::SVGBitmap *second = render(makeDocument(16), 37, 23);
+		Graphics::SVGBitmap *fresh = renderFresh(makeDocument(16), 37, 23);
+
+		TS_ASSERT(!equals(first, second));
+		TS_ASSERT(equals(second, fresh));
+
+		delete first;
+		delete second;
+		delete fresh;
+		Graphics::SVGBitmap::clearCache();
+	}
+
+	void test_eviction() {
+		Graphics::SVGBitmap *first = renderFresh(makeDocument(5), 60, 45);
+		delete first;
+
+		// Enough documents and bitmaps to drop the first ones from the cache
+		for (int i = 0; i < 40; i++) {
+			delete render(makeDocument(6 + i % 20), 300 + i, 200);
+			delete render(makeDocument(6 + i), 24, 18);
+		}
+
+		Graphics::SVGBitmap *again = render(makeDocument(5), 60, 45);
+		Graphics::SVGBitmap *fresh = renderFresh(makeDocument(5), 60, 45);
+		TS_ASSERT(equals(again, fresh));
+
+		delete again;
+		delete fresh;
+		Graphics::SVGBitmap::clearCache();
+	}
+};
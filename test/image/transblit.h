@@ -0,0 +1,172 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/blit.h"
+#include "graphics/managed_surface.h"
+
+#include "../golden.h"
+
+// Golden output tests for ManagedSurface::transBlitFrom. Pseudo-randomly
+// filled surfaces are blitted with color keys, flipping, clipping, palette
+// lookups and override colors, and the destination is hashed, so that
+// optimizations of the blitters can be checked to be bit exact. Every
+// implementation of the keyed blitters supported by the cpu is tested.
+class TransBlitTestSuite : public CxxTest::TestSuite
+{
+private:
+	GoldenRandom _random;
+
+	// Fills the surface with runs of random values, with the color key being
+	// common enough to produce both opaque and transparent spans
+	void fill(Graphics::ManagedSurface &surf, uint32 key) {
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; ) {
+				uint32 color = _random.next(3) ? (_random.next(256) << 24 | _random.next(256) << 16 | _random.next(256) << 8 | _random.next(256)) : key;
+				for (int run = 1 + _random.next(12); run && x < surf.w; run--, x++) {
+					if (surf.format.bytesPerPixel == 1)
+						*(byte *)surf.getBasePtr(x, y) = color;
+					else if (surf.format.bytesPerPixel == 2)
+						*(uint16 *)surf.getBasePtr(x, y) = color;
+					else
+						*(uint32 *)surf.getBasePtr(x, y) = color;
+				}
+			}
+		}
+	}
+
+	void fillPalette(Graphics::ManagedSurface &surf, bool similar) {
+		byte pal[256 * 3];
+		for (int i = 0; i < 256 * 3; i++)
+			pal[i] = (similar && _random.next(2)) ? (i * 7) & 0xFF : _random.next(256);
+		surf.setPalette(pal, 0, 256);
+	}
+
+	// Blits the source at a number of positions, some of them partially
+	// outside of the destination, and with different source rects
+	void blitAll(Graphics::ManagedSurface &dest, const Graphics::ManagedSurface &src,
+			uint32 transColor, uint32 overrideColor, uint32 &hash) {
+		for (int i = 0; i < 24; i++) {
+			const bool flipped = i & 1;
+			int left = 0, top = _random.next(src.h / 2);
+			if (!flipped)
+				left = _random.next(src.w / 2);
+			const Common::Rect srcRect(left, top, left + 1 + _random.next(src.w - left), top + 1 + _random.next(src.h - top));
+			const int x = (int)_random.next(dest.w + srcRect.width()) - srcRect.width();
+			const int y = (int)_random.next(dest.h + srcRect.height()) - srcRect.height();
+			const Common::Rect destRect(x, y, x + srcRect.width(), y + srcRect.height());
+
+			dest.transBlitFrom(src, srcRect, destRect, transColor, flipped, overrideColor);
+			fnv1a(hash, dest.rawSurface());
+		}
+	}
+
+	uint32 blit(const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &destFormat,
+			uint32 transColor, uint32 overrideColor, bool srcPalette, bool destPalette) {
+		Graphics::ManagedSurface src(71, 37, srcFormat);
+		Graphics::ManagedSurface dest(97, 61, destFormat);
+
+		fill(src, transColor);
+		fill(dest, 0);
+		if (srcPalette)
+			fillPalette(src, false);
+		if (destPalette)
+			fillPalette(dest, true);
+
+		uint32 hash = kFnv1aBasis;
+		blitAll(dest, src, transColor, overrideColor, hash);
+
+		// Also cover the scaled and translucent cases
+		dest.transBlitFrom(src, Common::Rect(0, 0, 40, 30), Common::Rect(-5, 7, 70, 40), transColor);
+		fnv1a(hash, dest.rawSurface());
+		dest.transBlitFrom(src, Common::Rect(0, 0, 40, 30), Common::Rect(11, 3, 51, 33), transColor, true, 0, 0x80);
+		fnv1a(hash, dest.rawSurface());
+		return hash;
+	}
+
+	static bool selectImpl(int impl) {
+		Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitGeneric;
+		Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapGeneric;
+
+		switch (impl) {
+		case 0:
+			return true;
+#ifdef SCUMMVM_SSE2
+		case 1:
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitSSE2;
+			return instrset_detect() >= 2;
+#endif
+#ifdef SCUMMVM_AVX2
+		case 2:
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitAVX2;
+			Graphics::KeyBlit::blitMapFunc = Graphics::KeyBlit::blitMapAVX2;
+			return instrset_detect() >= 8;
+#endif
+#ifdef SCUMMVM_NEON
+		case 3:
+			Graphics::KeyBlit::blitFunc = Graphics::KeyBlit::blitNEON;
+			return true;
+#endif
+		default:
+			return false;
+		}
+	}
+
+	static void resetImpl() {
+		Graphics::KeyBlit::blitFunc = nullptr;
+		Graphics::KeyBlit::blitMapFunc = nullptr;
+	}
+
+public:
+	void test_clut8() {
+		for (int impl = 0; impl < 4; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			const Graphics::PixelFormat clut8 = Graphics::PixelFormat::createFormatCLUT8();
+			TS_ASSERT_EQUALS(blit(clut8, clut8, 0, 0, false, false), 4279685351U);
+			TS_ASSERT_EQUALS(blit(clut8, clut8, 0xE3, 0, false, false), 847928065U);
+			TS_ASSERT_EQUALS(blit(clut8, clut8, (uint32)-1, 0, false, false), 3456703454U);
+			TS_ASSERT_EQUALS(blit(clut8, clut8, 7, 0x1F5, false, false), 2669922615U);
+			TS_ASSERT_EQUALS(blit(clut8, clut8, 7, 0, true, true), 2551871234U);
+			TS_ASSERT_EQUALS(blit(clut8, clut8, 7, 0x42, true, true), 92632163U);
+		}
+		resetImpl();
+	}
+
+	void test_clut8_to_rgb() {
+		for (int impl = 0; impl < 4; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			const Graphics::PixelFormat clut8 = Graphics::PixelFormat::createFormatCLUT8();
+			TS_ASSERT_EQUALS(blit(clut8, Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), 0, 0, true, false), 128401944U);
+			TS_ASSERT_EQUALS(blit(clut8, Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15), 0x80, 0, true, false), 3578500329U);
+			TS_ASSERT_EQUALS(blit(clut8, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 0xFF, 0, true, false), 318139139U);
+			TS_ASSERT_EQUALS(blit(clut8, Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0), 3, 0, true, false), 3598676118U);
+		}
+		resetImpl();
+	}
+
+	void test_rgb() {
+		for (int impl = 0; impl < 4; impl++) {
+			if (!selectImpl(impl))
+				continue;
+
+			_random.setSeed(12345);
+			const Graphics::PixelFormat rgb565(2, 5, 6, 5, 0, 11, 5, 0, 0);
+			const Graphics::PixelFormat rgb555(2, 5, 5, 5, 0, 10, 5, 0, 0);
+			const Graphics::PixelFormat xrgb8888(4, 8, 8, 8, 0, 16, 8, 0, 0);
+			const Graphics::PixelFormat argb8888(4, 8, 8, 8, 8, 16, 8, 0, 24);
+			TS_ASSERT_EQUALS(blit(rgb565, rgb565, 0xF81F, 0, false, false), 3716626068U);
+			TS_ASSERT_EQUALS(blit(rgb565, rgb565, 0, 0, false, false), 2262621394U);
+			TS_ASSERT_EQUALS(blit(rgb555, rgb555, 0x7C1F, 0, false, false), 3232859268U);
+			TS_ASSERT_EQUALS(blit(xrgb8888, xrgb8888, 0x00FF00FF, 0, false, false), 1117862210U);
+			TS_ASSERT_EQUALS(blit(xrgb8888, xrgb8888, (uint32)-1, 0, false, false), 2788769139U);
+			TS_ASSERT_EQUALS(blit(argb8888, argb8888, 0xFFFF00FF, 0, false, false), 1618784880U);
+			TS_ASSERT_EQUALS(blit(rgb565, xrgb8888, 0xF81F, 0, false, false), 1641440632U);
+		}
+		resetImpl();
+	}
+};
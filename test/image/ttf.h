@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/file.h"
+#include "common/ptr.h"
+#include "common/str.h"
+#include "common/ustr.h"
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/managed_surface.h"
+
+#include "../golden.h"
+#include "../null_osystem.h"
+
+// Golden output test for TTFFont. Strings are drawn with a font which has
+// kerning pairs, copied to test/engine-data, in every render mode and into
+// surfaces of several formats. The output and the measured widths are
+// hashed, so that changes to the glyph cache and to the string layout can be
+// checked to be bit exact.
+class TTFFontTestSuite : public CxxTest::TestSuite
+{
+private:
+	static const char *const _strings[];
+	static const char *const _paragraph;
+
+	static void hashRect(uint32 &hash, const Common::Rect &rect) {
+		fnv1a(hash, rect.left);
+		fnv1a(hash, rect.top);
+		fnv1a(hash, rect.right);
+		fnv1a(hash, rect.bottom);
+	}
+
+	template<class SurfaceType>
+	static void drawStrings(const Graphics::Font &font, SurfaceType &surface, uint32 color, uint32 &hash) {
+		static const Graphics::TextAlign aligns[] = { Graphics::kTextAlignLeft, Graphics::kTextAlignCenter, Graphics::kTextAlignRight };
+		const int lineHeight = font.getFontHeight();
+		int y = 0;
+
+		for (int i = 0; _strings[i]; i++) {
+			const Common::String str(_strings[i]);
+			const Common::U32String ustr(_strings[i], Common::kUtf8);
+
+			fnv1a(hash, font.getStringWidth(str));
+			fnv1a(hash, font.getStringWidth(ustr));
+			hashRect(hash, font.getBoundingBox(ustr, 0, 0, 0));
+
+			font.drawString(&surface, str, 2, y, surface.w - 4, color);
+			y += lineHeight;
+			for (int align = 0; align < ARRAYSIZE(aligns); align++) {
+				font.drawString(&surface, ustr, 2, y, surface.w - 4, color, aligns[align]);
+				y += lineHeight;
+			}
+
+			// Clipped, with an ellipsis and shifted
+			hashRect(hash, font.getBoundingBox(ustr, 2, y, 60, Graphics::kTextAlignLeft, 0, true));
+			font.drawString(&surface, ustr, 2, y, 60, color, Graphics::kTextAlignLeft, 0, true);
+			font.drawString(&surface, ustr, 70, y, 60, color, Graphics::kTextAlignLeft, -5, false);
+			y += lineHeight;
+		}
+
+		const Common::U32String paragraph(_paragraph, Common::kUtf8);
+		static const int widths[] = { 90, 150 };
+		for (int i = 0; i < ARRAYSIZE(widths); i++) {
+			Common::Array<Common::U32String> lines;
+			fnv1a(hash, font.wordWrapText(paragraph, widths[i], lines));
+			fnv1a(hash, lines.size());
+
+			for (uint line = 0; line < lines.size(); line++) {
+				fnv1a(hash, font.getStringWidth(lines[line]));
+				font.drawString(&surface, lines[line], 2 + i * 160, y + line * lineHeight, widths[i], color);
+			}
+		}
+	}
+
+	static uint32 render(Common::SeekableReadStream &file, Graphics::TTFRenderMode renderMode) {
+		static const int sizes[] = { 11, 16 };
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		uint32 hash = kFnv1aBasis;
+		for (int size = 0; size < ARRAYSIZE(sizes); size++) {
+			file.seek(0);
+			Common::ScopedPtr<Graphics::Font> font(Graphics::loadTTFFont(file, sizes[size], Graphics::kTTFSizeModeCharacter, 0, renderMode));
+			TS_ASSERT(font);
+			if (!font)
+				return 0;
+
+			// A kerned pair, so that the kerning is known to be covered
+			TS_ASSERT_DIFFERS(font->getKerningOffset('T', 'o'), 0);
+
+			Graphics::Surface clut8;
+			clut8.create(320, 1024, Graphics::PixelFormat::createFormatCLUT8());
+			drawStrings(*font, clut8, 15, hash);
+			fnv1a(hash, clut8);
+			clut8.free();
+
+			for (int format = 0; format < ARRAYSIZE(formats); format++) {
+				Graphics::ManagedSurface surface(320, 1024, formats[format]);
+				surface.clear(formats[format].RGBToColor(16, 32, 48));
+				drawStrings(*font, surface, formats[format].RGBToColor(250, 200, 100), hash);
+				fnv1a(hash, surface.rawSurface());
+			}
+		}
+
+		return hash;
+	}
+
+public:
+	void test_golden_output() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::File file;
+		TS_ASSERT(file.open("LiberationSans-Regular.ttf"));
+		if (!file.isOpen())
+			return;
+
+		TS_ASSERT_EQUALS(render(file, Graphics::kTTFRenderModeNormal), 1391374666U);
+		TS_ASSERT_EQUALS(render(file, Graphics::kTTFRenderModeLight), 3814824926U);
+		TS_ASSERT_EQUALS(render(file, Graphics::kTTFRenderModeMonochrome), 3791381200U);
+#endif
+	}
+};
+
+const char *const TTFFontTestSuite::_strings[] = {
+	"AVATAR Wavy Tokyo LTA",
+	"To Ty Yo P. V, F. r. y.",
+	"The quick brown fox jumps over the lazy dog",
+	"\xc3\x9c" "berpr" "\xc3\xbc" "fung, caf" "\xc3\xa9" " \xc3\x86\xc3\x98\xc3\x85",
+	"",
+	nullptr
+};
+
+const char *const TTFFontTestSuite::_paragraph =
+	"AVery long sentence, with Wavy kerned pairs, which is wrapped over several lines.\n"
+	"A second paragraph follows: supercalifragilisticexpialidocious words are split, and "
+	"  multiple   spaces are kept.";
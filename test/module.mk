@@ -15,6 +15,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
+	backends/mixer/null/null-mixer.o \
 	backends/modular-backend.o
 endif
 
@@ -24,11 +25,12 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/windows/windows-fs.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
+	backends/mixer/null/null-mixer.o \
 	backends/modular-backend.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	audio/libaudio.a math/libmath.a image/libimage.a graphics/libgraphics.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -40,6 +42,13 @@ ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 	TEST_LIBS += engines/ultima/libultima.a
 endif
 
+ifeq ($(ENABLE_SCUMM), STATIC_PLUGIN)
+ifdef ENABLE_SCUMM_7_8
+	TESTS += $(srcdir)/test/engines/scumm/imuse_digi/*.h
+	TEST_LIBS += engines/scumm/libscumm.a
+endif
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
@@ -74,15 +83,43 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+######################################################################
+# Decoder/renderer benchmarks. These are not run by 'make test'; use
+# 'make benchmark' and then run test/benchmark/runner <sample directory>.
+######################################################################
+
+BENCHMARK_OBJS := \
+	test/benchmark/benchmark.o \
+	test/benchmark/blit.o \
+	test/benchmark/gui.o \
+	test/benchmark/image.o \
+	test/benchmark/memory.o \
+	test/benchmark/mods.o \
+	test/benchmark/opl.o \
+	test/benchmark/video.o
+
+# Repeat the libraries which depend on libcommon ahead of it, as
+# TEST_LIBS lists them in an order only suitable for the unit tests.
+BENCHMARK_LIBS := gui/libgui.a video/libvideo.a image/libimage.a graphics/libgraphics.a $(TEST_LIBS)
+
+benchmark: test/benchmark/runner
+test/benchmark/runner: $(BENCHMARK_OBJS) $(BENCHMARK_LIBS) copy-dat
+	+$(QUIET_LINK)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $(BENCHMARK_OBJS) $(BENCHMARK_LIBS) $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/engine-data/LiberationSans-Regular.ttf test/null_osystem.o
+	-$(RM) test/benchmark/runner $(BENCHMARK_OBJS)
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 	$(MKDIR) test/engine-data
 	$(CP) $(srcdir)/dists/engine-data/encoding.dat test/engine-data/encoding.dat
 
-copy-dat: test/engine-data/encoding.dat
+test/engine-data/LiberationSans-Regular.ttf: $(srcdir)/gui/themes/fonts/LiberationSans-Regular.ttf
+	$(MKDIR) test/engine-data
+	$(CP) $(srcdir)/gui/themes/fonts/LiberationSans-Regular.ttf test/engine-data/LiberationSans-Regular.ttf
+
+copy-dat: test/engine-data/encoding.dat test/engine-data/LiberationSans-Regular.ttf
 
-.PHONY: test clean-test copy-dat
+.PHONY: test benchmark clean-test copy-dat
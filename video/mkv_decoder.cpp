@@ -24,77 +24,174 @@
 #include "audio/audiostream.h"
 #include "audio/decoders/raw.h"
 #include "common/debug.h"
+#include "common/mutex.h"
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/util.h"
 #include "graphics/pixelformat.h"
 #include "graphics/yuv_to_rgb.h"
 
 #include "video/mkv/mkvparser.h"
+#include "video/mkv/webmids.h"
 
 namespace mkvparser  {
 
+/**
+ * IMkvReader on top of a SeekableReadStream.
+ *
+ * mkvparser issues lots of tiny reads while walking the element headers,
+ * so reads are served from a cache window. A second window can be filled
+ * ahead of time by prefetch(), which is called from a timer callback; the
+ * windows are swapped when the parser reaches the prefetched range. The
+ * timer thread is shared with other callbacks, so the window is filled a
+ * chunk at a time. All accesses to the stream are serialized by a mutex.
+ */
 class MkvReader : public mkvparser::IMkvReader {
 public:
-	MkvReader() { _stream = nullptr; }
 	MkvReader(Common::SeekableReadStream *stream);
-	virtual ~MkvReader() { Close(); }
-
-	int Open(Common::SeekableReadStream *stream);
-	void Close();
+	virtual ~MkvReader();
 
 	virtual int Read(long long position, long length, unsigned char *buffer);
 	virtual int Length(long long *total, long long *available);
 
+	/** Ask for the given file range to be read ahead. */
+	void requestPrefetch(long long position);
+
+	/**
+	 * Read the requested range, if any, into the prefetch window. If
+	 * oneChunk is set, read at most kPrefetchChunk bytes of it.
+	 */
+	void prefetch(bool oneChunk);
+
 private:
+	enum {
+		kWindowSize = 256 * 1024,
+		kPrefetchChunk = 32 * 1024
+	};
+
+	struct Window {
+		byte *data;
+		long long start;
+		long size;
+
+		bool contains(long long position, long length) const {
+			return size > 0 && position >= start && position + length <= start + size;
+		}
+	};
+
+	bool fill(Window &window, long long position);
+
 	Common::SeekableReadStream *_stream;
-};
+	long long _streamSize;
+	Common::Mutex _mutex;
 
-MkvReader::MkvReader(Common::SeekableReadStream *stream) {
-	_stream = stream;
-}
+	Window _cache;
+	Window _ahead;
+	long long _prefetchPos;
+	long _prefetchSize;
+};
 
-int MkvReader::Open(Common::SeekableReadStream *stream) {
-	_stream = stream;
+MkvReader::MkvReader(Common::SeekableReadStream *stream) : _stream(stream), _prefetchPos(-1), _prefetchSize(0) {
+	_streamSize = _stream->size();
 
-	return 0;
+	_cache.data = new byte[kWindowSize];
+	_cache.start = 0;
+	_cache.size = 0;
+	_ahead.data = new byte[kWindowSize];
+	_ahead.start = 0;
+	_ahead.size = 0;
 }
 
-void MkvReader::Close() {
-	_stream = nullptr;
+MkvReader::~MkvReader() {
+	delete[] _cache.data;
+	delete[] _ahead.data;
 }
 
-int MkvReader::Read(long long position, long length, unsigned char *buffer) {
-	if (!_stream)
-		return -1;
+bool MkvReader::fill(Window &window, long long position) {
+	window.start = position;
+	window.size = (long)MIN<long long>(kWindowSize, _streamSize - position);
 
-	if (position > _stream->size() || position < 0)
-		return -1;
+	_stream->seek(position);
+	if (window.size <= 0 || _stream->read(window.data, window.size) != (uint32)window.size) {
+		window.size = 0;
+		return false;
+	}
 
-	if (length <= 0)
-		return -1;
+	return true;
+}
 
-	_stream->seek(position);
-	if (_stream->read(buffer, length) < (uint32)length)
+int MkvReader::Read(long long position, long length, unsigned char *buffer) {
+	if (position < 0 || length <= 0 || position + length > _streamSize)
 		return -1;
 
+	Common::StackLock lock(_mutex);
+
+	if (!_cache.contains(position, length)) {
+		if (_ahead.contains(position, length)) {
+			// The window may still be being filled, in which case the rest
+			// is read into the cache on demand
+			SWAP(_cache, _ahead);
+			_ahead.size = 0;
+			_prefetchPos = -1;
+		} else if (length > kWindowSize / 2) {
+			// Large frames are read directly, they would only flush the cache
+			_stream->seek(position);
+			return _stream->read(buffer, length) == (uint32)length ? 0 : -1;
+		} else if (!fill(_cache, position)) {
+			return -1;
+		}
+	}
+
+	memcpy(buffer, _cache.data + (position - _cache.start), length);
 	return 0;
 }
 
 int MkvReader::Length(long long *total, long long *available) {
-	if (!_stream)
-		return -1;
-
 	if (total)
-		*total = _stream->size();
+		*total = _streamSize;
 
 	if (available)
-		*available = _stream->size();
+		*available = _streamSize;
 
 	return 0;
 }
 
+void MkvReader::requestPrefetch(long long position) {
+	Common::StackLock lock(_mutex);
+
+	if (position >= _streamSize || position == _prefetchPos || _cache.contains(position, 1) || _ahead.contains(position, 1))
+		return;
+
+	_prefetchPos = position;
+	_prefetchSize = (long)MIN<long long>(kWindowSize, _streamSize - position);
+	_ahead.start = position;
+	_ahead.size = 0;
+}
+
+void MkvReader::prefetch(bool oneChunk) {
+	Common::StackLock lock(_mutex);
+
+	if (_prefetchPos < 0)
+		return;
+
+	long length = _prefetchSize - _ahead.size;
+	if (oneChunk)
+		length = MIN<long>(length, kPrefetchChunk);
+
+	_stream->seek(_ahead.start + _ahead.size);
+	if (_stream->read(_ahead.data + _ahead.size, length) != (uint32)length) {
+		_ahead.size = 0;
+		_prefetchPos = -1;
+		return;
+	}
+
+	_ahead.size += length;
+	if (_ahead.size == _prefetchSize)
+		_prefetchPos = -1;
+}
+
 } // end of namespace mkvparser
 
 namespace Video {
@@ -132,8 +229,7 @@ static uint64 xiph_lace_value(byte **np) {
 bool MKVDecoder::loadStream(Common::SeekableReadStream *stream) {
 	close();
 
-	warning("MKVDecoder::loadStream()");
-
+	_fileStream = stream;
 	_reader = new mkvparser::MkvReader(stream);
 
 	long long pos = 0;
@@ -145,12 +241,16 @@ bool MKVDecoder::loadStream(Common::SeekableReadStream *stream) {
 		error("MKVDecoder::loadStream(): Segment::CreateInstance() failed (%lld).", ret);
 	}
 
-	ret = _pSegment->Load();
-	if (ret) {
-		error("MKVDecoder::loadStream(): Segment::Load() failed (%lld).", ret);
+	// Only parse up to the first cluster, the clusters themselves are
+	// loaded one by one during playback
+	ret = _pSegment->ParseHeaders();
+	if (ret < 0) {
+		error("MKVDecoder::loadStream(): Segment::ParseHeaders() failed (%lld).", ret);
 	}
 
 	_pTracks = _pSegment->GetTracks();
+	if (!_pTracks)
+		error("Movie error: No tracks in movie file.");
 
 	uint32 i = 0;
 	const unsigned long j = _pTracks->GetTracksCount();
@@ -210,104 +310,242 @@ bool MKVDecoder::loadStream(Common::SeekableReadStream *stream) {
 	if (_aTrack < 0)
 		error("Movie error: No sound found.");
 
-	const unsigned long long clusterCount = _pSegment->GetCount();
+	// The cues are usually stored after the clusters, find them through
+	// the seek head so that seeking does not need to load every cluster
+	const mkvparser::Cues *cues = _pSegment->GetCues();
+	const mkvparser::SeekHead *seekHead = _pSegment->GetSeekHead();
+	if (!cues && seekHead) {
+		for (int idx = 0; idx < seekHead->GetCount(); idx++) {
+			const mkvparser::SeekHead::Entry *entry = seekHead->GetEntry(idx);
+			if (entry->id == libwebm::kMkvCues) {
+				long long cuesPos;
+				long cuesLen;
+				_pSegment->ParseCues(entry->pos, cuesPos, cuesLen);
+				break;
+			}
+		}
 
-	if (clusterCount == 0) {
-		error("Movie error: Segment has no clusters.\n");
+		cues = _pSegment->GetCues();
 	}
 
-	_frame = new byte[256 * 1024];
-	if (!_frame)
-		return false;
+	if (cues) {
+		while (!cues->DoneParsing())
+			cues->LoadCuePoint();
 
-	_cluster = _pSegment->GetFirst();
+		debug(1, "Number of cue points: %ld", cues->GetCount());
+	}
 
-	if (_cluster->GetFirst(_pBlockEntry))
-		error("_cluster::GetFirst() failed");
+	_frameSize = 256 * 1024;
+	_frame = new byte[_frameSize];
 
-	if ((_pBlockEntry == NULL) || _pBlockEntry->EOS()) {
-		_cluster = _pSegment->GetNext(_cluster);
-		if ((_cluster == NULL) || _cluster->EOS()) {
-			error("Error: No movie found in the movie file.");
-		}
-		if (_cluster->GetFirst(_pBlockEntry))
-			error("_cluster::GetFirst() failed");
-	}
+	if (!enterCluster(nullptr))
+		error("Error: No movie found in the movie file.");
 
-	_pBlock = _pBlockEntry->GetBlock();
-	_trackNum = _pBlock->GetTrackNumber();
-	_frameCount = _pBlock->GetFrameCount();
-	_fileStream = stream;
+	if (g_system->getTimerManager())
+		_prefetchInstalled = g_system->getTimerManager()->installTimerProc(&prefetchProc, 10000, this, "MKVDecoder");
 
 	return true;
 }
 
 void MKVDecoder::close() {
+	if (_prefetchInstalled) {
+		g_system->getTimerManager()->removeTimerProc(&prefetchProc);
+		_prefetchInstalled = false;
+	}
+
 	VideoDecoder::close();
 
-	delete _fileStream;
-	_fileStream = nullptr;
+	_videoTrack = nullptr;
+	_audioTrack = nullptr;
+	_cluster = nullptr;
+	_pBlockEntry = nullptr;
+	_pTracks = nullptr;
+
+	delete _pSegment;
+	_pSegment = nullptr;
 	delete _reader;
 	_reader = nullptr;
+	delete _fileStream;
+	_fileStream = nullptr;
+
+	delete[] _frame;
+	_frame = nullptr;
+	_frameSize = 0;
+
+	_endOfFile = false;
+	_skipUntil = 0;
+	_audioTime = 0;
 }
 
-void MKVDecoder::readNextPacket() {
+void MKVDecoder::prefetchProc(void *refCon) {
+	MKVDecoder *decoder = (MKVDecoder *)refCon;
+	decoder->_reader->prefetch(true);
+}
 
-	// First, let's get our frame
-	if (_cluster == nullptr || _cluster->EOS()) {
-		_videoTrack->setEndOfVideo();
-		if (!_audioTrack->hasAudio())
-			_audioTrack->setEndOfAudio();
-		return;
-	}
+bool MKVDecoder::isSeekable() const {
+	return isVideoLoaded() && _pSegment->GetCues() && _pSegment->GetCues()->GetCount() > 0;
+}
 
-	// ensure we have enough buffers in the stream
-	while (_audioTrack->needsAudio()) {
-		if (_frameCounter >= _frameCount) {
-		_cluster->GetNext(_pBlockEntry, _pBlockEntry);
-
-			if ((_pBlockEntry == NULL) || _pBlockEntry->EOS()) {
-				_cluster = _pSegment->GetNext(_cluster);
-				if ((_cluster == NULL) || _cluster->EOS()) {
-					_videoTrack->setEndOfVideo();
-					_audioTrack->setEndOfAudio();
-					return;
-				}
-				int ret = _cluster->GetFirst(_pBlockEntry);
-				if (ret < 0)
-					error("MKVDecoder::readNextPacket(): GetFirst() failed");
+bool MKVDecoder::enterCluster(const mkvparser::Cluster *cluster, const mkvparser::BlockEntry *blockEntry) {
+	if (!cluster) {
+		// Find the first cluster holding any blocks
+		for (;;) {
+			cluster = _cluster ? _pSegment->GetNext(_cluster) : _pSegment->GetFirst();
+
+			if (cluster && cluster->EOS() && !_pSegment->DoneParsing()) {
+				// Not loaded yet
+				if (_pSegment->LoadCluster() != 0)
+					return false;
+				continue;
 			}
 
-			_pBlock  = _pBlockEntry->GetBlock();
-			_trackNum = _pBlock->GetTrackNumber();
-			_frameCount = _pBlock->GetFrameCount();
-			_frameCounter = 0;
+			if (!cluster || cluster->EOS())
+				return false;
+
+			_cluster = cluster;
+			if (cluster->GetFirst(blockEntry) < 0)
+				error("MKVDecoder::enterCluster(): GetFirst() failed");
+			if (blockEntry && !blockEntry->EOS())
+				break;
 		}
+	}
 
-		const mkvparser::Block::Frame &theFrame = _pBlock->GetFrame(_frameCounter);
-		const uint32 size = theFrame.len;
+	_cluster = cluster;
+	_pBlockEntry = blockEntry;
+	_pBlock = _pBlockEntry->GetBlock();
+	_trackNum = _pBlock->GetTrackNumber();
+	_frameCount = _pBlock->GetFrameCount();
+	_frameCounter = 0;
 
-		if (size > sizeof(_frame)) {
-			if (_frame)
+	// Let the timer read the data following this cluster while it is played
+	_reader->requestPrefetch(_cluster->m_element_start + _cluster->GetElementSize());
+	return true;
+}
+
+bool MKVDecoder::nextBlock() {
+	_cluster->GetNext(_pBlockEntry, _pBlockEntry);
+
+	if (!_pBlockEntry || _pBlockEntry->EOS())
+		return enterCluster(nullptr);
+
+	_pBlock = _pBlockEntry->GetBlock();
+	_trackNum = _pBlock->GetTrackNumber();
+	_frameCount = _pBlock->GetFrameCount();
+	_frameCounter = 0;
+	return true;
+}
+
+bool MKVDecoder::demuxFrame() {
+	if (_endOfFile)
+		return false;
+
+	if (_frameCounter >= _frameCount && !nextBlock()) {
+		_endOfFile = true;
+		_videoTrack->setEndOfVideo();
+		_audioTrack->setEndOfAudio();
+		return false;
+	}
+
+	const mkvparser::Block::Frame &theFrame = _pBlock->GetFrame(_frameCounter++);
+	const uint32 size = theFrame.len;
+	const uint32 time = (uint32)(_pBlock->GetTime(_cluster) / 1000000);
+
+	if (_trackNum == _vTrack) {
+		if (time < _skipUntil) {
+			if (size > _frameSize) {
 				delete[] _frame;
-			_frame = new unsigned char[size];
-			if (!_frame)
-				return;
-		}
+				_frameSize = size;
+				_frame = new byte[_frameSize];
+			}
 
-		if (_trackNum == _vTrack) {
 			theFrame.Read(_reader, _frame);
-			_videoTrack->decodeFrame(_frame, size);
-		} else if (_trackNum == _aTrack) {
-			if (size > 0) {
-				theFrame.Read(_reader, _frame);
-				queueAudio(size);
-			}
+			_videoTrack->skipPacket(_frame, size);
 		} else {
-			warning("Unprocessed track %lld", _trackNum);
+			Packet packet;
+			packet.data = new byte[MAX<uint32>(size, 1)];
+			packet.size = size;
+			packet.time = time;
+			theFrame.Read(_reader, packet.data);
+			_videoTrack->queuePacket(packet);
 		}
-		++_frameCounter;
+	} else if (_trackNum == _aTrack) {
+		if (size > 0 && time >= _skipUntil) {
+			if (size > _frameSize) {
+				delete[] _frame;
+				_frameSize = size;
+				_frame = new byte[_frameSize];
+			}
+
+			theFrame.Read(_reader, _frame);
+			queueAudio(size);
+			_audioTime = time;
+		}
+	} else {
+		warning("Unprocessed track %lld", _trackNum);
 	}
+
+	return true;
+}
+
+void MKVDecoder::readNextPacket() {
+	// Keep enough audio queued to cover the gaps between our updates, but
+	// never let the compressed video run further ahead than necessary
+	static const uint32 kAudioLeadTime = 500;
+	static const uint32 kMaxVideoBufferTime = 2000;
+
+	for (;;) {
+		if (!_videoTrack->needsPackets()) {
+			uint32 time = getTime();
+			bool audioLow = _audioTime < time + kAudioLeadTime;
+
+			if (!audioLow || _videoTrack->getBufferedTime() >= kMaxVideoBufferTime)
+				break;
+		}
+
+		if (!demuxFrame())
+			break;
+	}
+
+	// Without a timer, there is nobody else to do the read ahead
+	if (!_prefetchInstalled)
+		_reader->prefetch(false);
+}
+
+bool MKVDecoder::seekIntern(const Audio::Timestamp &time) {
+	const mkvparser::Cues *cues = _pSegment->GetCues();
+	const long long timeNs = (long long)time.msecs() * 1000000;
+
+	if (_pSegment->GetDuration() > 0 && timeNs > _pSegment->GetDuration())
+		return false;
+
+	const mkvparser::CuePoint *cuePoint;
+	const mkvparser::CuePoint::TrackPosition *trackPos;
+	if (!cues->Find(timeNs, _pTracks->GetTrackByNumber(_vTrack), cuePoint, trackPos))
+		return false;
+
+	// Cue points reference key frames, so decoding can restart there
+	const mkvparser::BlockEntry *blockEntry = cues->GetBlock(cuePoint, trackPos);
+	if (!blockEntry || blockEntry->EOS())
+		return false;
+
+	// The frames between the key frame and the requested time are decoded
+	// by skipPacket(), which advances the frame number
+	const uint32 keyTime = (uint32)(blockEntry->GetBlock()->GetTime(blockEntry->GetCluster()) / 1000000);
+	_videoTrack->reset(keyTime);
+	_audioTrack->reset();
+
+	_endOfFile = false;
+	_skipUntil = time.msecs();
+	_audioTime = _skipUntil;
+
+	if (!enterCluster(blockEntry->GetCluster(), blockEntry))
+		return false;
+
+	// Decode up to the requested frame
+	while (_videoTrack->needsPackets() && demuxFrame())
+		;
+
+	return true;
 }
 
 MKVDecoder::VPXVideoTrack::VPXVideoTrack(const mkvparser::Track *const pTrack) {
@@ -324,9 +562,17 @@ MKVDecoder::VPXVideoTrack::VPXVideoTrack(const mkvparser::Track *const pTrack) {
 	debug(1, "VideoTrack: %d x %d", _width, _height);
 
 	_endOfVideo = false;
-	_nextFrameStartTime = 0.0;
+	_nextFrameStartTime = 0;
 	_curFrame = -1;
 
+	// Only used to time the last frame, and to guess the frame number after seeking
+	if (pVideoTrack->GetDefaultDuration())
+		_frameDuration = (uint32)(pVideoTrack->GetDefaultDuration() / 1000000);
+	else if (pVideoTrack->GetFrameRate() > 0)
+		_frameDuration = (uint32)(1000 / pVideoTrack->GetFrameRate());
+	else
+		_frameDuration = 0;
+
 	_codec = new vpx_codec_ctx_t;
 
 	/* Initialize video codec */
@@ -335,49 +581,85 @@ MKVDecoder::VPXVideoTrack::VPXVideoTrack(const mkvparser::Track *const pTrack) {
 }
 
 MKVDecoder::VPXVideoTrack::~VPXVideoTrack() {
-	// The last frame is not freed in decodeNextFrame(), clear it hear instead.
+	reset(0);
 	_surface.free();
+	vpx_codec_destroy(_codec);
 	delete _codec;
 }
 
 bool MKVDecoder::VPXVideoTrack::endOfTrack() const {
-	if (_endOfVideo && _displayQueue.size())
-		return false;
-	return _endOfVideo;
+	return _endOfVideo && _packets.empty();
+}
+
+void MKVDecoder::VPXVideoTrack::queuePacket(const Packet &packet) {
+	_packets.push(packet);
+}
+
+uint32 MKVDecoder::VPXVideoTrack::getBufferedTime() const {
+	if (_packets.size() < 2)
+		return 0;
+
+	return _packets.back().time - _packets.front().time;
+}
+
+void MKVDecoder::VPXVideoTrack::reset(uint32 time) {
+	while (!_packets.empty())
+		delete[] _packets.pop().data;
+
+	_endOfVideo = false;
+	_nextFrameStartTime = time;
+	_curFrame = _frameDuration ? (int)(time / _frameDuration) - 1 : -1;
 }
 
 const Graphics::Surface *MKVDecoder::VPXVideoTrack::decodeNextFrame() {
-	if (_displayQueue.size()) {
-		if (_surface.getPixels())
-			_surface.free();
-		_surface = _displayQueue.pop();
-	}
+	if (_packets.empty())
+		return &_surface;
+
+	Packet packet = _packets.pop();
+	decodePacket(packet.data, packet.size, true);
+	delete[] packet.data;
+
+	if (!_packets.empty())
+		_nextFrameStartTime = _packets.front().time;
+	else
+		_nextFrameStartTime = packet.time + _frameDuration;
+
+	_curFrame++;
 	return &_surface;
 }
 
-bool MKVDecoder::VPXVideoTrack::decodeFrame(byte *frame, long size) {
-
-	//warning("In within decodeFrame");
+void MKVDecoder::VPXVideoTrack::skipPacket(const byte *data, uint32 size) {
+	decodePacket(data, size, false);
+	_curFrame++;
+}
 
+void MKVDecoder::VPXVideoTrack::decodePacket(const byte *data, uint32 size, bool convert) {
 	/* Decode the frame */
-	if (vpx_codec_decode(_codec, frame, size, NULL, 0))
-		error("Failed to decode frame");
+	if (vpx_codec_decode(_codec, data, size, NULL, 0)) {
+		warning("Failed to decode frame");
+		return;
+	}
 
 	// Let's decode an image frame!
 	vpx_codec_iter_t iter = NULL;
 	vpx_image_t *img;
-	Graphics::Surface tmp;
-	tmp.create(getWidth(), getHeight(), getPixelFormat());
 
 	/* Get frame data */
 	while ((img = vpx_codec_get_frame(_codec, &iter))) {
 		if (img->fmt != VPX_IMG_FMT_I420)
 			error("Movie error. The movie is not in I420 colour format, which is the only one I can hanlde at the moment.");
 
-		YUVToRGBMan.convert420(&tmp, Graphics::YUVToRGBManager::kScaleITU, img->planes[0], img->planes[1], img->planes[2], img->d_w, img->d_h, img->stride[0], img->stride[1]);
-		_displayQueue.push(tmp);
+		if (!convert)
+			continue;
+
+		// The same surface is reused for every frame
+		if (_surface.w != getWidth() || _surface.h != getHeight() || _surface.format != getPixelFormat()) {
+			_surface.free();
+			_surface.create(getWidth(), getHeight(), getPixelFormat());
+		}
+
+		YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, img->planes[0], img->planes[1], img->planes[2], img->d_w, img->d_h, img->stride[0], img->stride[1]);
 	}
-	return false;
 }
 
 MKVDecoder::VorbisAudioTrack::VorbisAudioTrack(const mkvparser::Track *const pTrack) :
@@ -510,13 +792,18 @@ bool MKVDecoder::VorbisAudioTrack::decodeSamples(byte *frame, long size) {
 	return false;
 }
 
-bool MKVDecoder::VorbisAudioTrack::hasAudio() const {
-	return _audStream->numQueuedStreams() > 0;
+void MKVDecoder::VorbisAudioTrack::setEndOfAudio() {
+	if (!_endOfAudio)
+		_audStream->finish();
+	_endOfAudio = true;
 }
 
-bool MKVDecoder::VorbisAudioTrack::needsAudio() const {
-	// TODO: 10 is very arbitrary. We probably should do something like QuickTime does.
-	return _audStream->numQueuedStreams() < 10;
+void MKVDecoder::VorbisAudioTrack::reset() {
+	vorbis_synthesis_restart(&_vorbisDSP);
+
+	delete _audStream;
+	_audStream = Audio::makeQueuingAudioStream(_vorbisInfo.rate, _vorbisInfo.channels != 1);
+	_endOfAudio = false;
 }
 
 bool MKVDecoder::VorbisAudioTrack::synthesizePacket(byte *frame, long size) {
@@ -65,8 +65,17 @@ namespace Video {
 class MkvReader;
 
 /**
+ * Decoder for Matroska/WebM videos with VP8 video and Vorbis audio.
+ *
+ * The file is parsed incrementally: clusters are loaded as playback reaches
+ * them and compressed video packets are only buffered for a short amount of
+ * time ahead of the playback position, so memory use does not depend on the
+ * length of the movie. File reads go through a small cache, and the byte range
+ * following the current cluster is prefetched from a timer callback, a small
+ * chunk at a time.
+ *
+ * Seeking is supported when the file has a Cues element.
  *
- * Decoder for MKV/Webm videos.
  * Video decoder used in engines:
  *  - sludge
  */
@@ -82,10 +91,20 @@ public:
 	bool loadStream(Common::SeekableReadStream *stream);
 	void close();
 
+	bool isSeekable() const;
+
 protected:
 	void readNextPacket();
+	bool seekIntern(const Audio::Timestamp &time);
 
 private:
+	/** A compressed video packet waiting to be decoded. */
+	struct Packet {
+		byte *data;
+		uint32 size;
+		uint32 time; // msecs
+	};
+
 	class VPXVideoTrack : public VideoTrack {
 	public:
 		VPXVideoTrack(const mkvparser::Track *const pTrack);
@@ -97,22 +116,39 @@ private:
 		Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
 		bool setOutputPixelFormat(const Graphics::PixelFormat &format) { _pixelFormat = format; return true; }
 		int getCurFrame() const { return _curFrame; }
-		uint32 getNextFrameStartTime() const { return (uint32)(_nextFrameStartTime * 1000); }
+		uint32 getNextFrameStartTime() const { return _nextFrameStartTime; }
 		const Graphics::Surface *decodeNextFrame();
-		bool decodeFrame(byte *frame, long size);
 		void setEndOfVideo() { _endOfVideo = true; }
 
+		/** Queue a packet; the track takes ownership of the data. */
+		void queuePacket(const Packet &packet);
+
+		/** Decode a packet without converting the picture, used when seeking. */
+		void skipPacket(const byte *data, uint32 size);
+
+		/** True if fewer packets are queued than needed to time the next frame. */
+		bool needsPackets() const { return _packets.size() < 2; }
+
+		/** Amount of video, in msecs, sitting in the packet queue. */
+		uint32 getBufferedTime() const;
+
+		/** Drop all queued packets and restart at the given time. */
+		void reset(uint32 time);
+
 	private:
+		void decodePacket(const byte *data, uint32 size, bool convert);
+
 		int _curFrame;
 		bool _endOfVideo;
-		double _nextFrameStartTime;
+		uint32 _nextFrameStartTime;
+		uint32 _frameDuration;
 
 		uint16 _width;
 		uint16 _height;
 		Graphics::PixelFormat _pixelFormat;
 
 		Graphics::Surface _surface;
-		Common::Queue<Graphics::Surface> _displayQueue;
+		Common::Queue<Packet> _packets;
 
 		vpx_codec_ctx_t *_codec = nullptr;
 	};
@@ -123,10 +159,11 @@ private:
 		~VorbisAudioTrack();
 
 		bool decodeSamples(byte *frame, long size);
-		bool hasAudio() const;
-		bool needsAudio() const;
 		bool synthesizePacket(byte *frame, long size);
-		void setEndOfAudio() { _endOfAudio = true; }
+		void setEndOfAudio();
+
+		/** Throw away all queued and pending samples, used when seeking. */
+		void reset();
 
 	protected:
 		Audio::AudioStream *getAudioStream() const;
@@ -145,6 +182,17 @@ private:
 
 	bool queueAudio(long size);
 
+	/** Advance to the next block, loading clusters as needed. */
+	bool nextBlock();
+
+	/** Start reading blocks from the given cluster. */
+	bool enterCluster(const mkvparser::Cluster *cluster, const mkvparser::BlockEntry *blockEntry = nullptr);
+
+	/** Demux one frame of the current block. Returns false at the end of the file. */
+	bool demuxFrame();
+
+	static void prefetchProc(void *refCon);
+
 	Common::SeekableReadStream *_fileStream;
 
 	bool _hasVideo, _hasAudio;
@@ -160,6 +208,7 @@ private:
 	mkvparser::Segment *_pSegment = nullptr;
 
 	byte *_frame = nullptr;
+	uint32 _frameSize = 0;
 	int _frameCounter = 0;
 
 	int _vTrack = -1;
@@ -168,6 +217,15 @@ private:
 	const mkvparser::Block *_pBlock;
 	long long _trackNum;
 	int _frameCount;
+
+	bool _endOfFile = false;
+	bool _prefetchInstalled = false;
+
+	// Packets older than this are decoded without being shown or heard
+	uint32 _skipUntil = 0;
+
+	// Timestamp, in msecs, of the latest audio packet handed to the audio track
+	uint32 _audioTime = 0;
 };
 
 } // End of namespace Video
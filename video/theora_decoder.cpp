@@ -40,6 +40,7 @@
 #include "common/stream.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/timer.h"
 #include "common/util.h"
 #include "graphics/pixelformat.h"
 #include "graphics/yuv_to_rgb.h"
@@ -52,6 +53,7 @@ TheoraDecoder::TheoraDecoder() {
 	_videoTrack = 0;
 	_audioTrack = 0;
 	_hasVideo = _hasAudio = false;
+	_decodeAheadInstalled = false;
 }
 
 TheoraDecoder::~TheoraDecoder() {
@@ -167,7 +169,7 @@ bool TheoraDecoder::loadStream(Common::SeekableReadStream *stream) {
 
 	// And now we have it all. Initialize decoders next
 	if (_hasVideo) {
-		_videoTrack = new TheoraVideoTrack(theoraInfo, theoraSetup);
+		_videoTrack = new TheoraVideoTrack(theoraInfo, theoraSetup, _mutex);
 		addTrack(_videoTrack);
 	}
 
@@ -197,6 +199,11 @@ bool TheoraDecoder::loadStream(Common::SeekableReadStream *stream) {
 }
 
 void TheoraDecoder::close() {
+	if (_decodeAheadInstalled) {
+		g_system->getTimerManager()->removeTimerProc(&decodeAheadProc);
+		_decodeAheadInstalled = false;
+	}
+
 	VideoDecoder::close();
 
 	if (!_fileStream)
@@ -222,13 +229,27 @@ void TheoraDecoder::close() {
 }
 
 void TheoraDecoder::readNextPacket() {
+	Common::StackLock lock(_mutex);
+
+	// Start decoding ahead once the first frame is requested, as the
+	// output pixel format cannot change anymore after that
+	if (!_decodeAheadInstalled && g_system->getTimerManager())
+		_decodeAheadInstalled = g_system->getTimerManager()->installTimerProc(&decodeAheadProc, 10000, this, "TheoraDecoder");
+
+	// Usually the timer has done this already
+	decodeAhead(false);
+
+	if (_hasVideo && _videoTrack->hasPendingFrame())
+		_videoTrack->presentFrame();
+}
+
+void TheoraDecoder::decodeAhead(bool oneStep) {
 	// First, let's get our frame
 	if (_hasVideo) {
-		while (!_videoTrack->endOfTrack()) {
+		while (!_videoTrack->hasPendingFrame() && !_videoTrack->isEndOfPackets()) {
 			// theora is one in, one out...
 			if (ogg_stream_packetout(&_theoraOut, &_oggPacket) > 0) {
-				if (_videoTrack->decodePacket(_oggPacket))
-					break;
+				_videoTrack->decodePacket(_oggPacket);
 			} else if (_theoraOut.e_o_s || _fileStream->eos()) {
 				// If we can't get any more frames, we're done.
 				_videoTrack->setEndOfVideo();
@@ -241,11 +262,23 @@ void TheoraDecoder::readNextPacket() {
 
 			// Update audio if we can
 			queueAudio();
+
+			if (oneStep)
+				return;
 		}
 	}
 
 	// Then make sure we have enough audio buffered
-	ensureAudioBufferSize();
+	ensureAudioBufferSize(oneStep);
+}
+
+void TheoraDecoder::decodeAheadProc(void *refCon) {
+	TheoraDecoder *decoder = (TheoraDecoder *)refCon;
+
+	// The timer thread is shared with other callbacks, such as the music
+	// drivers, so only do a little work each time
+	Common::StackLock lock(decoder->_mutex);
+	decoder->decodeAhead(true);
 }
 
 Common::Rational TheoraDecoder::getFrameRate() const {
@@ -254,7 +287,7 @@ Common::Rational TheoraDecoder::getFrameRate() const {
 	return Common::Rational();
 }
 
-TheoraDecoder::TheoraVideoTrack::TheoraVideoTrack(th_info &theoraInfo, th_setup_info *theoraSetup) {
+TheoraDecoder::TheoraVideoTrack::TheoraVideoTrack(th_info &theoraInfo, th_setup_info *theoraSetup, Common::Mutex &mutex) : _mutex(mutex) {
 	_theoraDecode = th_decode_alloc(&theoraInfo, theoraSetup);
 
 	if (theoraInfo.pixel_fmt != TH_PF_420 && theoraInfo.pixel_fmt != TH_PF_422 && theoraInfo.pixel_fmt != TH_PF_444) {
@@ -284,31 +317,40 @@ TheoraDecoder::TheoraVideoTrack::TheoraVideoTrack(th_info &theoraInfo, th_setup_
 
 	_endOfVideo = false;
 	_nextFrameStartTime = 0.0;
+	_decodeTime = 0.0;
+	_pendingFrameEndTime = 0.0;
+	_hasPendingFrame = false;
 	_curFrame = -1;
-	_surface = nullptr;
-	_displaySurface = nullptr;
+	_surfaces[0] = _surfaces[1] = nullptr;
+	_backBuffer = 0;
 }
 
 TheoraDecoder::TheoraVideoTrack::~TheoraVideoTrack() {
 	th_decode_free(_theoraDecode);
 
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-		_surface = nullptr;
+	for (int i = 0; i < 2; i++) {
+		if (_surfaces[i]) {
+			_surfaces[i]->free();
+			delete _surfaces[i];
+			_surfaces[i] = nullptr;
+		}
 	}
+}
 
-	if (_displaySurface) {
-		_displaySurface->setPixels(0);
-		delete _displaySurface;
-		_displaySurface = nullptr;
-	}
+void TheoraDecoder::TheoraVideoTrack::presentFrame() {
+	Graphics::Surface *surface = _surfaces[_backBuffer];
+	_displaySurface.init(_width, _height, surface->pitch, surface->getBasePtr(_x, _y), surface->format);
+
+	// The previously shown frame is decoded into next
+	_backBuffer ^= 1;
+	_hasPendingFrame = false;
+
+	_curFrame++;
+	_nextFrameStartTime = _pendingFrameEndTime;
 }
 
 bool TheoraDecoder::TheoraVideoTrack::decodePacket(ogg_packet &oggPacket) {
 	if (th_decode_packetin(_theoraDecode, &oggPacket, 0) == 0) {
-		_curFrame++;
-
 		// Convert YUV data to RGB data
 		th_ycbcr_buffer yuv;
 		th_decode_ycbcr_out(_theoraDecode, yuv);
@@ -321,10 +363,12 @@ bool TheoraDecoder::TheoraVideoTrack::decodePacket(ogg_packet &oggPacket) {
 		// Ogg is a lossy container format, so it doesn't always list the time to the
 		// next frame. In such cases, we need to calculate it ourselves.
 		if (time == -1.0)
-			_nextFrameStartTime += _frameRate.getInverse().toDouble();
+			_decodeTime += _frameRate.getInverse().toDouble();
 		else
-			_nextFrameStartTime = time;
+			_decodeTime = time;
 
+		_pendingFrameEndTime = _decodeTime;
+		_hasPendingFrame = true;
 		return true;
 	}
 
@@ -350,27 +394,21 @@ void TheoraDecoder::TheoraVideoTrack::translateYUVtoRGBA(th_ycbcr_buffer &YUVBuf
 	assert((YUVBuffer[kBufferU].height == YUVBuffer[kBufferY].height >> 1) || (YUVBuffer[kBufferU].height == YUVBuffer[kBufferY].height));
 	assert((YUVBuffer[kBufferV].height == YUVBuffer[kBufferY].height >> 1) || (YUVBuffer[kBufferV].height == YUVBuffer[kBufferY].height));
 
-	if (!_surface) {
-		_surface = new Graphics::Surface();
-		_surface->create(_surfaceWidth, _surfaceHeight, _pixelFormat);
-	}
-
-	// Set up a display surface
-	if (!_displaySurface) {
-		_displaySurface = new Graphics::Surface();
-		_displaySurface->init(_width, _height, _surface->pitch,
-		                      _surface->getBasePtr(_x, _y), _surface->format);
+	Graphics::Surface *&surface = _surfaces[_backBuffer];
+	if (!surface) {
+		surface = new Graphics::Surface();
+		surface->create(_surfaceWidth, _surfaceHeight, _pixelFormat);
 	}
 
 	switch (_theoraPixelFormat) {
 	case TH_PF_420:
-		YUVToRGBMan.convert420(_surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
+		YUVToRGBMan.convert420(surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
 		break;
 	case TH_PF_422:
-		YUVToRGBMan.convert422(_surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
+		YUVToRGBMan.convert422(surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
 		break;
 	case TH_PF_444:
-		YUVToRGBMan.convert444(_surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
+		YUVToRGBMan.convert444(surface, Graphics::YUVToRGBManager::kScaleITU, YUVBuffer[kBufferY].data, YUVBuffer[kBufferU].data, YUVBuffer[kBufferV].data, YUVBuffer[kBufferY].width, YUVBuffer[kBufferY].height, YUVBuffer[kBufferY].stride, YUVBuffer[kBufferU].stride);
 		break;
 	default:
 		error("Unsupported Theora pixel format");
@@ -523,7 +561,7 @@ bool TheoraDecoder::queueAudio() {
 	return queuedAudio;
 }
 
-void TheoraDecoder::ensureAudioBufferSize() {
+void TheoraDecoder::ensureAudioBufferSize(bool oneStep) {
 	if (!_hasAudio)
 		return;
 
@@ -538,6 +576,9 @@ void TheoraDecoder::ensureAudioBufferSize() {
 			_audioTrack->setEndOfAudio();
 			break;
 		}
+
+		if (oneStep)
+			break;
 	}
 }
 
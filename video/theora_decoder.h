@@ -26,6 +26,7 @@
 #ifndef VIDEO_THEORA_DECODER_H
 #define VIDEO_THEORA_DECODER_H
 
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "video/video_decoder.h"
 #include "audio/mixer.h"
@@ -53,6 +54,15 @@ namespace Video {
 /**
  *
  * Decoder for Theora videos.
+ *
+ * Once playback has started, the next video frame and the audio are
+ * decoded ahead from a timer callback, so that the engine only has to
+ * present the frames and the audio keeps flowing when the engine is busy.
+ * The callback decodes one packet or reads one block of data at a time, so
+ * that it does not hold up the other timer callbacks, such as the music
+ * drivers. Without a timer manager everything is decoded in
+ * readNextPacket().
+ *
  * Video decoder used in engines:
  *  - pegasus
  *  - sword25
@@ -79,10 +89,10 @@ protected:
 private:
 	class TheoraVideoTrack : public VideoTrack {
 	public:
-		TheoraVideoTrack(th_info &theoraInfo, th_setup_info *theoraSetup);
+		TheoraVideoTrack(th_info &theoraInfo, th_setup_info *theoraSetup, Common::Mutex &mutex);
 		~TheoraVideoTrack();
 
-		bool endOfTrack() const { return _endOfVideo; }
+		bool endOfTrack() const { Common::StackLock lock(_mutex); return _endOfVideo && !_hasPendingFrame; }
 		uint16 getWidth() const { return _width; }
 		uint16 getHeight() const { return _height; }
 		Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
@@ -90,19 +100,36 @@ private:
 		int getCurFrame() const { return _curFrame; }
 		const Common::Rational &getFrameRate() const { return _frameRate; }
 		uint32 getNextFrameStartTime() const { return (uint32)(_nextFrameStartTime * 1000); }
-		const Graphics::Surface *decodeNextFrame() { return _displaySurface; }
+		const Graphics::Surface *decodeNextFrame() { return _displaySurface.getPixels() ? &_displaySurface : nullptr; }
 
 		bool decodePacket(ogg_packet &oggPacket);
 		void setEndOfVideo() { _endOfVideo = true; }
+		bool isEndOfPackets() const { Common::StackLock lock(_mutex); return _endOfVideo; }
+
+		/** True if a frame has been decoded but not shown yet. */
+		bool hasPendingFrame() const { Common::StackLock lock(_mutex); return _hasPendingFrame; }
+
+		/** Make the pending frame the current one. */
+		void presentFrame();
 
 	private:
+		// The decoder's lock, as the timer callback decodes the frames
+		Common::Mutex &_mutex;
+
 		int _curFrame;
 		bool _endOfVideo;
 		Common::Rational _frameRate;
 		double _nextFrameStartTime;
 
-		Graphics::Surface *_surface;
-		Graphics::Surface *_displaySurface;
+		// End time of the last decoded frame, and of the pending one
+		double _decodeTime;
+		double _pendingFrameEndTime;
+		bool _hasPendingFrame;
+
+		// Two full frames: the one on display and the one decoded ahead
+		Graphics::Surface *_surfaces[2];
+		int _backBuffer;
+		Graphics::Surface _displaySurface;
 		Graphics::PixelFormat _pixelFormat;
 		int _x;
 		int _y;
@@ -147,7 +174,19 @@ private:
 	void queuePage(ogg_page *page);
 	int bufferData();
 	bool queueAudio();
-	void ensureAudioBufferSize();
+	void ensureAudioBufferSize(bool oneStep);
+
+	/**
+	 * Decode the next video frame and top up the audio. If oneStep is set,
+	 * stop after decoding one packet or reading one block of data. Call
+	 * with _mutex held.
+	 */
+	void decodeAhead(bool oneStep);
+	static void decodeAheadProc(void *refCon);
+
+	// Protects the Ogg, Theora and Vorbis state from the timer callback
+	Common::Mutex _mutex;
+	bool _decodeAheadInstalled;
 
 	Common::SeekableReadStream *_fileStream;
 